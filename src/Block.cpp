@@ -5,11 +5,13 @@
 
 #include "Block.h"
 #include "covLoader.h"
+#include "identity.h"
 #include "util.h"
 
 //pthread_mutex_t mutex_print = PTHREAD_MUTEX_INITIALIZER;
 pthread_mutex_t mutex_write_misAln = PTHREAD_MUTEX_INITIALIZER;
 pthread_mutex_t mutex_cns_work = PTHREAD_MUTEX_INITIALIZER;
+extern pthread_mutex_t mutex_fai;
 
 // Constructor with parameters
 Block::Block(string chrname, size_t startPos, size_t endPos, faidx_t *fai,  Paras *paras){
@@ -58,6 +60,7 @@ Block::~Block(){
 	if(!clipRegVector.empty()) destroyClipRegVector();
 	if(!zeroCovRegVector.empty()) destroyZeroCovRegVector();
 	if(!misAlnRegVector.empty()) destroyMisAlnRegVector();
+	if(!fastPathIndelVector.empty() or !fastPathVarVector.empty()) destroyFastPathVarVector();
 }
 
 // set the output directory
@@ -124,6 +127,16 @@ void Block::destroyMisAlnRegVector(){
 	vector<misAlnReg>().swap(misAlnRegVector);
 }
 
+// destroy the fast path variant vectors
+void Block::destroyFastPathVarVector(){
+	for(size_t i=0; i<fastPathIndelVector.size(); i++)
+		delete fastPathIndelVector.at(i).var;
+	vector<fastPathIndel_t>().swap(fastPathIndelVector);
+	for(size_t i=0; i<fastPathVarVector.size(); i++)
+		delete fastPathVarVector.at(i);
+	vector<reg_t*>().swap(fastPathVarVector);
+}
+
 // set the region ingnore flag in the block
 void Block::setRegIngFlag(bool headIgnFlag, bool tailIgnFlag){
 	this->headIgnFlag = headIgnFlag;
@@ -284,6 +297,10 @@ void Block::blockDetect(){
 	removeRedundantItems(indelVector);
 	removeRedundantItems(clipRegVector);
 
+	// call the simple indels directly from the read evidence before it is released, they are
+	// extracted from the candidates after the chromosome-level filters
+	if(paras->fast_path_flag) callFastPathIndels();
+
 	// save SV to file
 	//saveSV2File(); // delete on 2024-04-06
 
@@ -792,6 +809,191 @@ void Block::removeFalseSNV(){
 	if(flag) snvVector.shrink_to_fit();
 }
 
+// call the simple indels directly from the read evidence, the candidate regions are kept in indelVector
+// to be filtered at chromosome level like the others
+void Block::callFastPathIndels(){
+	size_t i;
+	reg_t *reg;
+	fastPathIndel_t fast_indel;
+	bool isolated_flag;
+
+	for(i=0; i<indelVector.size(); i++){
+		reg = indelVector.at(i);
+
+		// no neighbouring candidates sharing the consensus region, and no nearby clippings
+		isolated_flag = true;
+		if(i>0 and reg->startRefPos-indelVector.at(i-1)->endRefPos<=paras->cnsSideExtSize) isolated_flag = false;
+		else if(i+1<indelVector.size() and indelVector.at(i+1)->startRefPos-reg->endRefPos<=paras->cnsSideExtSize) isolated_flag = false;
+		else if(isClipRegNearby(reg, paras->cnsSideExtSize)) isolated_flag = false;
+
+		if(isolated_flag){
+			fast_indel.var = computeFastPathIndel(reg);
+			if(fast_indel.var){
+				fast_indel.startRefPos = reg->startRefPos;
+				fast_indel.endRefPos = reg->endRefPos;
+				fastPathIndelVector.push_back(fast_indel);
+			}
+		}
+	}
+}
+
+// remove the candidate regions of the fast path indels from the consensus candidates, and the indels whose
+// candidate regions were removed by the mate clipping region and redundancy filters are discarded
+void Block::extractFastPathIndels(){
+	size_t i, j;
+	reg_t *reg;
+	fastPathIndel_t *fast_indel;
+	vector<reg_t*> indel_vec_tmp;
+
+	if(fastPathIndelVector.empty()) return;
+
+	// both vectors are sorted by position
+	j = 0;
+	for(i=0; i<indelVector.size(); i++){
+		reg = indelVector.at(i);
+		while(j<fastPathIndelVector.size() and fastPathIndelVector.at(j).startRefPos<reg->startRefPos){
+			delete fastPathIndelVector.at(j).var;
+			j++;
+		}
+		fast_indel = (j<fastPathIndelVector.size()) ? &fastPathIndelVector.at(j) : NULL;
+		if(fast_indel and fast_indel->startRefPos==reg->startRefPos and fast_indel->endRefPos==reg->endRefPos){
+			fastPathVarVector.push_back(fast_indel->var);
+			delete reg;
+			j++;
+		}else indel_vec_tmp.push_back(reg);
+	}
+	for(; j<fastPathIndelVector.size(); j++) delete fastPathIndelVector.at(j).var;
+
+	indelVector.swap(indel_vec_tmp);
+	vector<fastPathIndel_t>().swap(fastPathIndelVector);
+}
+
+// whether there are clip regions near the given region
+bool Block::isClipRegNearby(reg_t *reg, int64_t ext_size){
+	reg_t *clip_reg;
+	for(size_t i=0; i<clipRegVector.size(); i++){
+		clip_reg = clipRegVector.at(i);
+		if(isOverlappedPos(reg->startRefPos-ext_size, reg->endRefPos+ext_size, clip_reg->startRefPos, clip_reg->endRefPos))
+			return true;
+	}
+	return false;
+}
+
+// order of the indel signatures by size
+static bool isIndelEventShorter(const indelEvent_t *event1, const indelEvent_t *event2){
+	return event1->seq.size()<event2->seq.size();
+}
+
+// compute the indel from the read signatures around the candidate region, NULL is returned
+// unless all the signatures agree tightly in position, size and inserted sequence
+reg_t* Block::computeFastPathIndel(reg_t *reg){
+	int64_t begPos_ext, endPos_ext, pos, anchor_pos, pos_diff, depth, min_sig_size, supp_num, max_size;
+	size_t i;
+	int32_t var_type, sig_len, ref_len;
+	Base *base;
+	vector<indelEvent_t*> sig_vec;
+	indelEvent_t *sig, *sig_mid;
+	string reg_str, refseq;
+	char *seq;
+	int seq_len;
+	double size_ratio;
+	reg_t *var;
+
+	// the signatures may be truncated at the block ends, and the base ahead of the variant should be in the block
+	begPos_ext = reg->startRefPos - FAST_PATH_EXT_SIZE;
+	endPos_ext = reg->endRefPos + FAST_PATH_EXT_SIZE;
+	if(begPos_ext<=startPos or begPos_ext<2 or endPos_ext>endPos) return NULL;
+
+	// collect the signatures, all of them should be of the same type without any clippings
+	min_sig_size = paras->min_sv_size_usr * FAST_PATH_MIN_SIG_SIZE_RATIO;
+	if(min_sig_size<1) min_sig_size = 1;
+	var_type = VAR_UNC;
+	for(pos=begPos_ext; pos<=endPos_ext; pos++){
+		base = baseArr + pos - startPos;
+		if(!base->clipVector.empty()) return NULL;
+		for(i=0; i<base->insVector.size(); i++){
+			if((int64_t)base->insVector.at(i)->seq.size()>=min_sig_size){
+				if(var_type==VAR_DEL) return NULL;
+				var_type = VAR_INS;
+				sig_vec.push_back(base->insVector.at(i));
+			}
+		}
+		for(i=0; i<base->delVector.size(); i++){
+			if((int64_t)base->delVector.at(i)->seq.size()>=min_sig_size){
+				if(var_type==VAR_INS) return NULL;
+				var_type = VAR_DEL;
+				sig_vec.push_back(base->delVector.at(i));
+			}
+		}
+	}
+	supp_num = sig_vec.size();
+	if(supp_num<FAST_PATH_MIN_SUPP_NUM or supp_num<paras->minReadsNumSupportSV) return NULL;
+
+	// all the signatures should agree with the median one
+	sort(sig_vec.begin(), sig_vec.end(), isIndelEventShorter);
+	sig_mid = sig_vec.at(supp_num/2);
+	sig_len = sig_mid->seq.size();
+	max_size = (paras->max_sv_size_usr<FAST_PATH_MAX_SV_SIZE) ? paras->max_sv_size_usr : FAST_PATH_MAX_SV_SIZE;
+	if(sig_len<paras->min_sv_size_usr or sig_len>max_size) return NULL;
+
+	for(i=0; i<sig_vec.size(); i++){
+		sig = sig_vec.at(i);
+		if(sig==sig_mid) continue;
+		pos_diff = (int64_t)sig->startPos - (int64_t)sig_mid->startPos;
+		if(pos_diff<-FAST_PATH_MAX_POS_DIFF or pos_diff>FAST_PATH_MAX_POS_DIFF) return NULL;
+		if(sig->seq.size()<=sig_mid->seq.size()) size_ratio = (double)sig->seq.size() / sig_mid->seq.size();
+		else size_ratio = (double)sig_mid->seq.size() / sig->seq.size();
+		if(size_ratio<FAST_PATH_MIN_SIZE_RATIO) return NULL;
+		if(var_type==VAR_INS and computeVarseqIdentity(sig->seq, sig_mid->seq, FAST_PATH_MIN_INS_IDENTITY)<FAST_PATH_MIN_INS_IDENTITY) return NULL;
+	}
+
+	// the depth is computed at the base ahead of the variant
+	anchor_pos = sig_mid->startPos - 1;
+	depth = baseArr[anchor_pos-startPos].coverage.num_bases[5];
+	if(depth<supp_num) depth = supp_num;
+	if((double)supp_num/depth<FAST_PATH_MIN_SUPP_RATIO) return NULL;
+
+	// reference bases, including the base ahead of the variant
+	ref_len = (var_type==VAR_DEL) ? sig_len + 1 : 1;
+	reg_str = chrname + ":" + to_string(anchor_pos) + "-" + to_string(anchor_pos+ref_len-1);
+	pthread_mutex_lock(&mutex_fai);
+	seq = fai_fetch(fai, reg_str.c_str(), &seq_len);
+	pthread_mutex_unlock(&mutex_fai);
+	if(seq==NULL) return NULL;
+	refseq = seq;
+	free(seq);
+	if(seq_len!=ref_len) return NULL;
+
+	var = new reg_t();
+	var->chrname = chrname;
+	var->startRefPos = anchor_pos;
+	var->endRefPos = anchor_pos + ref_len - 1;
+	var->startLocalRefPos = var->endLocalRefPos = 0;
+	var->startQueryPos = var->endQueryPos = 0;
+	var->var_type = var_type;
+	var->sv_len = sig_len;
+	var->query_id = -1;
+	var->blat_aln_id = -1;
+	var->minimap2_aln_id = -1;
+	var->call_success_status = true;
+	var->short_sv_flag = false;
+	var->zero_cov_flag = false;
+	var->aln_seg_end_flag = false;
+	var->query_pos_invalid_flag = false;
+	var->large_indel_flag = false;
+	var->gt_type = -1;
+	var->gt_seq = "";
+	var->AF = 0;
+	var->supp_num = supp_num;
+	var->DP = depth;
+	var->discover_level = VAR_DISCOV_L_READS;
+	var->refseq = refseq;
+	if(var_type==VAR_DEL) var->altseq = refseq.substr(0, 1);
+	else var->altseq = refseq + sig_mid->seq;
+
+	return var;
+}
+
 // sort the region vector
 //void Block::sortRegVec(vector<reg_t*> &regVector){
 //	size_t min_idx;
@@ -18,8 +18,25 @@
 
 //#define MIN_ADJACENT_REG_DIST		50
 
+// fast path of the simple indels, which are called directly from the read evidence
+#define FAST_PATH_EXT_SIZE				200		// flanking size checked for clippings and signatures
+#define FAST_PATH_MIN_SIG_SIZE_RATIO	0.5		// signatures shorter than this ratio of the minimal SV size are ignored
+#define FAST_PATH_MAX_POS_DIFF			10		// maximal position difference to the median signature
+#define FAST_PATH_MIN_SIZE_RATIO		0.95	// minimal size ratio to the median signature
+#define FAST_PATH_MIN_INS_IDENTITY		0.95	// minimal identity of the inserted sequence to the median signature
+#define FAST_PATH_MIN_SUPP_NUM			5
+#define FAST_PATH_MIN_SUPP_RATIO		0.3		// minimal ratio of the signatures to the depth
+#define FAST_PATH_MAX_SV_SIZE			1000
+
 using namespace std;
 
+// simple indel called by the fast path, it is kept with the position of its candidate region until
+// the candidate region passes the chromosome-level filters, see extractFastPathIndels()
+typedef struct{
+	int64_t startRefPos, endRefPos;		// candidate region
+	reg_t *var;
+}fastPathIndel_t;
+
 class Block{
 	public:
 		Paras *paras;
@@ -38,6 +55,8 @@ class Block{
 		vector<reg_t*> indelVector;
 		vector<misAlnReg> misAlnRegVector;
 		vector<reg_t*> zeroCovRegVector;	// for long deletions
+		vector<fastPathIndel_t> fastPathIndelVector;	// simple indels called directly from the read evidence, not yet extracted
+		vector<reg_t*> fastPathVarVector;	// simple indels extracted from the consensus candidates
 
 		// clip regions
 		vector<reg_t*> clipRegVector;
@@ -69,6 +88,7 @@ class Block{
 		void resetVarCandFiles();
 		void setMisAlnRegFile(ofstream *misAln_reg_file);
 		void resetMisAlnRegFile();
+		void extractFastPathIndels();
 
 	private:
 		void destroyBaseArray();
@@ -78,6 +98,7 @@ class Block{
 		void destroyClipRegVector();
 		void destroyZeroCovRegVector();
 		void destroyMisAlnRegVector();
+		void destroyFastPathVarVector();
 		Base *initBaseArray();
 		int loadAlnData();
 		int computeBlockBaseInfo();
@@ -102,6 +123,9 @@ class Block{
 		void updateIndelRegUsingLongZeroCov(vector<reg_t*> &regVec, vector<reg_t*> &zero_cov_vec);
 		void removeFalseIndel();
 		void removeFalseSNV();
+		void callFastPathIndels();
+		bool isClipRegNearby(reg_t *reg, int64_t ext_size);
+		reg_t* computeFastPathIndel(reg_t *reg);
 		//void sortRegVec(vector<reg_t*> &regVector);
 		void blockGenerateLocalConsWorkOpt_Indel();
 		void blockGenerateLocalConsWorkOpt_ClipReg();
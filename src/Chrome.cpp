@@ -4,9 +4,7 @@
 #include "Thread.h"
 #include "util.h"
 #include <pthread.h>
-#include <htslib/thread_pool.h>
 
-pthread_mutex_t mutex_mate_clip_reg = PTHREAD_MUTEX_INITIALIZER;
 extern pthread_mutex_t mutex_fai;
 
 // Constructor with parameters
@@ -26,6 +24,7 @@ Chrome::Chrome(string& chrname, int chrlen, faidx_t *fai, Paras *paras, vector<C
 	out_filename_detect_snv = "";
 	out_filename_detect_indel = "";
 	out_filename_detect_clipReg = "";
+	out_filename_detect_fast_indel = "";
 	out_filename_call_snv = "";
 	out_filename_call_indel = "";
 	out_filename_call_clipReg = "";
@@ -39,6 +38,7 @@ Chrome::~Chrome(){
 	if(!clipRegVector.empty()) destroyClipRegVector();
 	if(!mateClipRegVector.empty()) destroyMateClipRegVector();
 	if(!var_cand_clipReg_vec.empty()) destroyVarCandVector(var_cand_clipReg_vec);
+	if(!fast_path_var_vec.empty()) destroyFastPathVarVec();
 }
 
 // initialization
@@ -63,6 +63,7 @@ void Chrome::setOutputDir(string& out_dir_detect_prefix, string& out_dir_cns_pre
 	out_filename_detect_snv = out_dir_detect + "_SNV_candidate";
 	out_filename_detect_indel = out_dir_detect + "_INDEL_candidate";
 	out_filename_detect_clipReg = out_dir_detect + "_clipReg_candidate";
+	out_filename_detect_fast_indel = out_dir_detect + "_INDEL_fast_call";
 	out_filename_call_snv = out_dir_call + "_SNV";
 	out_filename_call_indel = out_dir_call + "_INDEL";
 	misAln_reg_filename = out_dir_detect + "_misaln_reg";
@@ -208,6 +209,13 @@ void Chrome::destroyMateClipRegVector(){
 	vector<mateClipReg_t*>().swap(mateClipRegVector);
 }
 
+// destroy the fast path variant vector
+void Chrome::destroyFastPathVarVec(){
+	for(size_t i=0; i<fast_path_var_vec.size(); i++)
+		delete fast_path_var_vec.at(i);
+	vector<reg_t*>().swap(fast_path_var_vec);
+}
+
 // save the blocks to file
 void Chrome::saveChrBlocksToFile(){
 	ofstream outfile(blocks_out_file);
@@ -328,23 +336,8 @@ int Chrome::chrDetect_st(){
 
 // multiple threads
 int Chrome::chrDetect_mt(){
-	int32_t i;
-	MultiThread mt[paras->num_threads];
-	for(i=0; i<paras->num_threads; i++){
-		mt[i].setNumThreads(paras->num_threads);
-		mt[i].setBlockVec(&blockVector);
-		mt[i].setUserThreadID(i);
-		if(!mt[i].startDetect()){
-			cerr << __func__ << ", line=" << __LINE__ << ": unable to create thread, error!" << endl;
-			exit(1);
-		}
-	}
-	for(i=0; i<paras->num_threads; i++){
-		if(!mt[i].join()){
-			cerr << __func__ << ", line=" << __LINE__ << ": unable to join, error!" << endl;
-			exit(1);
-		}
-	}
+	dispatchBlockWork(TASK_TYPE_DETECT, processSingleBlockDetectWork);
+	paras->thread_pool->wait(TASK_TYPE_DETECT);
 
 	return 0;
 }
@@ -456,8 +449,7 @@ void Chrome::chrComputeMateClipReg(){
 	processMateClipRegDetectWork();
 
 	// sort
-	sortMateClipRegsByWorkId();
-	bubbleSortMateClipRegs();
+	sortMateClipRegs();
 
 	// check sort
 	checkSortMateClipRegs();
@@ -475,18 +467,22 @@ void Chrome::processMateClipRegDetectWork(){
 	int32_t num_work;
 	reg_t *reg;
 	mateClipRegDetectWork_opt *mate_clip_reg_work_opt;
+	mateClipRegDetectResult_t *result;
+	vector<mateClipRegDetectResult_t> result_vec;
 	//Time time;
 
 	if(clipRegVector.empty()) return;  // no work, then return directly
 
 	//cout << "[" << time.getTime() << "], Chr " << chrname << ", detect mate clipping regions using " << paras->num_threads << " threads ..." << endl;
 
-	hts_tpool *p = hts_tpool_init(paras->num_threads);
-	hts_tpool_process *q = hts_tpool_process_init(p, paras->num_threads*2, 1);
-
-	pthread_mutex_init(&mutex_mate_clip_reg, NULL);
-
+	// each work has its own result slot indexed by work id
 	num_work = clipRegVector.size();
+	result_vec.resize(num_work);
+	for(int32_t i=0; i<num_work; i++){
+		result_vec.at(i).mate_clip_reg = NULL;
+		result_vec.at(i).indel_reg = NULL;
+	}
+
 	for(int32_t i=0; i<num_work; i++){
 		//if(clip_processed_flag_vec.at(i)==false){
 			reg = clipRegVector.at(i);
@@ -504,46 +500,27 @@ void Chrome::processMateClipRegDetectWork(){
 			mate_clip_reg_work_opt->fai = fai;
 			mate_clip_reg_work_opt->paras = paras;
 			//mate_clip_reg_work_opt->clip_processed_flag_vec = &clip_processed_flag_vec;
-			mate_clip_reg_work_opt->mateClipRegVector = &mateClipRegVector;
-			mate_clip_reg_work_opt->clipRegVector = &clipRegVector;
-			mate_clip_reg_work_opt->var_cand_clipReg_vec = &var_cand_clipReg_vec;
-			mate_clip_reg_work_opt->blockVector = &blockVector;
-			mate_clip_reg_work_opt->p_mutex_mate_clip_reg = &mutex_mate_clip_reg;
+			mate_clip_reg_work_opt->result = &result_vec.at(i);
 			//mate_clip_reg_work_opt->p_mate_clip_reg_fail_num = &mate_clip_reg_fail_num;
 
-			hts_tpool_dispatch(p, q, processSingleMateClipRegDetectWork, mate_clip_reg_work_opt);
+			paras->thread_pool->dispatch(TASK_TYPE_MATE_CLIP_REG, processSingleMateClipRegDetectWork, mate_clip_reg_work_opt);
 		//}
 	}
+	paras->thread_pool->wait(TASK_TYPE_MATE_CLIP_REG);
 
-    hts_tpool_process_flush(q);
-    hts_tpool_process_destroy(q);
-    hts_tpool_destroy(p);
+	// compact the result slots in work id order
+	for(int32_t i=0; i<num_work; i++){
+		result = &result_vec.at(i);
+		if(result->mate_clip_reg) mateClipRegVector.push_back(result->mate_clip_reg);
+		for(size_t j=0; j<result->removed_var_cand_vec.size(); j++) removeVarCandNode(result->removed_var_cand_vec.at(j), var_cand_clipReg_vec);
+		if(result->indel_reg) addIndelRegToBlock(result->indel_reg, blockVector, paras);
+	}
 
     //cout << "\tChr " << chrname << ", num_work=" << num_work << ", mate_clip_reg_fail_num=" << mate_clip_reg_fail_num << endl;
 }
 
-// sort mate clipping region items by work id
-void Chrome::sortMateClipRegsByWorkId(){
-	size_t i;
-	mateClipReg_t *mate_clip_1, *mate_clip_2, *tmp;
-
-	if(mateClipRegVector.size()<2) return;
-
-	for(i=0; i<mateClipRegVector.size()-1; i++){
-		mate_clip_1 = mateClipRegVector.at(i);
-		mate_clip_2 = mateClipRegVector.at(i+1);
-		if(mate_clip_1->work_id>mate_clip_2->work_id){
-			tmp = mateClipRegVector.at(i);
-			mateClipRegVector.at(i) = mateClipRegVector.at(i+1);
-			mateClipRegVector.at(i+1) = tmp;
-		}
-	}
-}
-
-// sort mate clipping region items by bubble sort
-void Chrome::bubbleSortMateClipRegs(){
-	size_t i, j;
-	mateClipReg_t *mate_clip_1, *mate_clip_2, *tmp;
+// determine whether the two adjacent mate clipping region items are out of order, i.e. they should be swapped
+bool Chrome::isMateClipRegPairSwapped(mateClipReg_t *mate_clip_1, mateClipReg_t *mate_clip_2){
 	int64_t left_pos1, left_pos2, other_left_pos1, other_left_pos2, left_pos, other_left_pos;
 	int64_t right_pos1, right_pos2, other_right_pos1, other_right_pos2, right_pos, other_right_pos;
 	int64_t left_end_pos1, left_end_pos2, other_left_end_pos1, other_left_end_pos2, left_end_pos, other_left_end_pos;
@@ -553,180 +530,175 @@ void Chrome::bubbleSortMateClipRegs(){
 	string chrname_tmp;
 	bool swap_flag, equal_flag;
 
-	if(mateClipRegVector.size()<2) return;
-
-	for(i=0; i<mateClipRegVector.size(); i++){
-		for(j=0; j<mateClipRegVector.size()-i-1; j++){
-			mate_clip_1 = mateClipRegVector.at(j);
-			mate_clip_2 = mateClipRegVector.at(j+1);
-
-			if(mate_clip_1->large_indel_flag==false and mate_clip_2->large_indel_flag==false){ // both clipping regions
-				left_pos1 = left_pos2 = other_left_pos1 = other_left_pos2 = left_pos = other_left_pos = -1;
-				right_pos1 = right_pos2 = other_right_pos1 = other_right_pos2 = right_pos = other_right_pos = -1;
+	if(mate_clip_1->large_indel_flag==false and mate_clip_2->large_indel_flag==false){ // both clipping regions
+		left_pos1 = left_pos2 = other_left_pos1 = other_left_pos2 = left_pos = other_left_pos = -1;
+		right_pos1 = right_pos2 = other_right_pos1 = other_right_pos2 = right_pos = other_right_pos = -1;
 
-				if(mate_clip_1->leftClipReg) {
-					left_pos1 = mate_clip_1->leftClipReg->startRefPos;
-					left_end_pos1 = mate_clip_1->leftClipReg->endRefPos;
-				}
-				if(mate_clip_1->leftClipReg2) {
-					left_pos2 = mate_clip_1->leftClipReg2->startRefPos;
-					left_end_pos2 = mate_clip_1->leftClipReg2->endRefPos;
-				}
-				if(mate_clip_1->rightClipReg){
-					right_pos1 = mate_clip_1->rightClipReg->startRefPos;
-					right_end_pos1 = mate_clip_1->rightClipReg->endRefPos;
-				}
-				if(mate_clip_1->rightClipReg2){
-					right_pos2 = mate_clip_1->rightClipReg2->startRefPos;
-					right_end_pos2 = mate_clip_1->rightClipReg2->endRefPos;
-				}
+		if(mate_clip_1->leftClipReg) {
+			left_pos1 = mate_clip_1->leftClipReg->startRefPos;
+			left_end_pos1 = mate_clip_1->leftClipReg->endRefPos;
+		}
+		if(mate_clip_1->leftClipReg2) {
+			left_pos2 = mate_clip_1->leftClipReg2->startRefPos;
+			left_end_pos2 = mate_clip_1->leftClipReg2->endRefPos;
+		}
+		if(mate_clip_1->rightClipReg){
+			right_pos1 = mate_clip_1->rightClipReg->startRefPos;
+			right_end_pos1 = mate_clip_1->rightClipReg->endRefPos;
+		}
+		if(mate_clip_1->rightClipReg2){
+			right_pos2 = mate_clip_1->rightClipReg2->startRefPos;
+			right_end_pos2 = mate_clip_1->rightClipReg2->endRefPos;
+		}
 
-				if(mate_clip_2->leftClipReg){
-					other_left_pos1 = mate_clip_2->leftClipReg->startRefPos;
-					other_left_end_pos1 = mate_clip_2->leftClipReg->endRefPos;
-				}
-				if(mate_clip_2->leftClipReg2){
-					other_left_pos2 = mate_clip_2->leftClipReg2->startRefPos;
-					other_left_end_pos2 = mate_clip_2->leftClipReg2->endRefPos;
-				}
-				if(mate_clip_2->rightClipReg){
-					other_right_pos1 = mate_clip_2->rightClipReg->startRefPos;
-					other_right_end_pos1 = mate_clip_2->rightClipReg->endRefPos;
-				}
-				if(mate_clip_2->rightClipReg2){
-					other_right_pos2 = mate_clip_2->rightClipReg2->startRefPos;
-					other_right_end_pos2 = mate_clip_2->rightClipReg2->endRefPos;
-				}
+		if(mate_clip_2->leftClipReg){
+			other_left_pos1 = mate_clip_2->leftClipReg->startRefPos;
+			other_left_end_pos1 = mate_clip_2->leftClipReg->endRefPos;
+		}
+		if(mate_clip_2->leftClipReg2){
+			other_left_pos2 = mate_clip_2->leftClipReg2->startRefPos;
+			other_left_end_pos2 = mate_clip_2->leftClipReg2->endRefPos;
+		}
+		if(mate_clip_2->rightClipReg){
+			other_right_pos1 = mate_clip_2->rightClipReg->startRefPos;
+			other_right_end_pos1 = mate_clip_2->rightClipReg->endRefPos;
+		}
+		if(mate_clip_2->rightClipReg2){
+			other_right_pos2 = mate_clip_2->rightClipReg2->startRefPos;
+			other_right_end_pos2 = mate_clip_2->rightClipReg2->endRefPos;
+		}
 
-				// ignore the second region if there are two regions
-				if(left_pos1!=-1) { left_pos = left_pos1; left_end_pos = left_end_pos1; }
-				else{ left_pos = left_pos2; left_end_pos = left_end_pos2; }
-				if(right_pos1!=-1){ right_pos = right_pos1; right_end_pos = right_end_pos1; }
-				else{ right_pos = right_pos2; right_end_pos = right_end_pos2; }
-
-				if(other_left_pos1!=-1){ other_left_pos = other_left_pos1; other_left_end_pos = other_left_end_pos1; }
-				else{ other_left_pos = other_left_pos2; other_left_end_pos = other_left_end_pos2; }
-				if(other_right_pos1!=-1){ other_right_pos = other_right_pos1; other_right_end_pos = other_right_end_pos1; }
-				else{ other_right_pos = other_right_pos2; other_right_end_pos = other_right_end_pos2; }
-
-				clipPosNum = mate_clip_1->leftClipPosNum + mate_clip_1->leftClipPosNum2 + mate_clip_1->rightClipPosNum + mate_clip_1->rightClipPosNum2;
-				other_clipPosNum = mate_clip_2->leftClipPosNum + mate_clip_2->leftClipPosNum2 + mate_clip_2->rightClipPosNum + mate_clip_2->rightClipPosNum2;
-
-				swap_flag = equal_flag = false;
-				if(left_pos>other_left_pos) swap_flag = true;
-				else if(left_pos==other_left_pos){ // equal left loci, then compare right loci
-					if(right_pos>other_right_pos) swap_flag = true;
-					else if(right_pos==other_right_pos){ // equal right loci, then compare left end loci
-						if(left_end_pos>other_left_end_pos) swap_flag = true;
-						else if(left_end_pos==other_left_end_pos){ // equal left end loci, then compare right end loci
-							if(right_end_pos>other_right_end_pos) swap_flag = true;
-							else if(right_end_pos==other_right_end_pos){ // check clipPosNum
-								if(clipPosNum<other_clipPosNum) swap_flag = true;
-								else if(clipPosNum==other_clipPosNum) equal_flag = true;
-							}
-						}
+		// ignore the second region if there are two regions
+		if(left_pos1!=-1) { left_pos = left_pos1; left_end_pos = left_end_pos1; }
+		else{ left_pos = left_pos2; left_end_pos = left_end_pos2; }
+		if(right_pos1!=-1){ right_pos = right_pos1; right_end_pos = right_end_pos1; }
+		else{ right_pos = right_pos2; right_end_pos = right_end_pos2; }
+
+		if(other_left_pos1!=-1){ other_left_pos = other_left_pos1; other_left_end_pos = other_left_end_pos1; }
+		else{ other_left_pos = other_left_pos2; other_left_end_pos = other_left_end_pos2; }
+		if(other_right_pos1!=-1){ other_right_pos = other_right_pos1; other_right_end_pos = other_right_end_pos1; }
+		else{ other_right_pos = other_right_pos2; other_right_end_pos = other_right_end_pos2; }
+
+		clipPosNum = mate_clip_1->leftClipPosNum + mate_clip_1->leftClipPosNum2 + mate_clip_1->rightClipPosNum + mate_clip_1->rightClipPosNum2;
+		other_clipPosNum = mate_clip_2->leftClipPosNum + mate_clip_2->leftClipPosNum2 + mate_clip_2->rightClipPosNum + mate_clip_2->rightClipPosNum2;
+
+		swap_flag = equal_flag = false;
+		if(left_pos>other_left_pos) swap_flag = true;
+		else if(left_pos==other_left_pos){ // equal left loci, then compare right loci
+			if(right_pos>other_right_pos) swap_flag = true;
+			else if(right_pos==other_right_pos){ // equal right loci, then compare left end loci
+				if(left_end_pos>other_left_end_pos) swap_flag = true;
+				else if(left_end_pos==other_left_end_pos){ // equal left end loci, then compare right end loci
+					if(right_end_pos>other_right_end_pos) swap_flag = true;
+					else if(right_end_pos==other_right_end_pos){ // check clipPosNum
+						if(clipPosNum<other_clipPosNum) swap_flag = true;
+						else if(clipPosNum==other_clipPosNum) equal_flag = true;
 					}
 				}
+			}
+		}
 
-				// sort by the second region
-				if(equal_flag and mate_clip_1->leftClipRegNum==2 and mate_clip_2->leftClipRegNum==2){
-					if(left_pos2>other_left_pos2) swap_flag = true;
-					else if(left_pos2==other_left_pos2){
-						if(left_end_pos2>other_left_end_pos2) swap_flag = true;
-						else if(left_end_pos2==other_left_end_pos2) equal_flag = true;
-					}
+		// sort by the second region
+		if(equal_flag and mate_clip_1->leftClipRegNum==2 and mate_clip_2->leftClipRegNum==2){
+			if(left_pos2>other_left_pos2) swap_flag = true;
+			else if(left_pos2==other_left_pos2){
+				if(left_end_pos2>other_left_end_pos2) swap_flag = true;
+				else if(left_end_pos2==other_left_end_pos2) equal_flag = true;
+			}
 
-				}
-				if(equal_flag and mate_clip_1->rightClipRegNum==2 and mate_clip_2->rightClipRegNum==2){
-					if(right_pos2>other_right_pos2) swap_flag = true;
-					else if(right_pos2==other_right_pos2){
-						if(right_end_pos2>other_right_end_pos2) swap_flag = true;
-						else if(right_end_pos2==other_right_end_pos2) equal_flag = true;
-					}
-				}
+		}
+		if(equal_flag and mate_clip_1->rightClipRegNum==2 and mate_clip_2->rightClipRegNum==2){
+			if(right_pos2>other_right_pos2) swap_flag = true;
+			else if(right_pos2==other_right_pos2){
+				if(right_end_pos2>other_right_end_pos2) swap_flag = true;
+				else if(right_end_pos2==other_right_end_pos2) equal_flag = true;
+			}
+		}
+	}else{ // at least one large indel region
+		min_start_pos = min_end_pos = LONG_MAX;
+		if(mate_clip_1->large_indel_flag==false){ // clipping region
+			chrname_tmp = mate_clip_2->largeIndelClipReg->chrname;
+			if(mate_clip_1->leftClipReg and mate_clip_1->leftClipReg->chrname.compare(chrname_tmp)==0) {
+				left_pos1 = mate_clip_1->leftClipReg->startRefPos;
+				left_end_pos1 = mate_clip_1->leftClipReg->endRefPos;
+				if(left_pos1<min_start_pos) min_start_pos = left_pos1;
+				if(left_end_pos1<min_end_pos) min_end_pos = left_end_pos1;
+			}
+			if(mate_clip_1->leftClipReg2 and mate_clip_1->leftClipReg2->chrname.compare(chrname_tmp)==0) {
+				left_pos2 = mate_clip_1->leftClipReg2->startRefPos;
+				left_end_pos2 = mate_clip_1->leftClipReg2->endRefPos;
+				if(left_pos2<min_start_pos) min_start_pos = left_pos2;
+				if(left_end_pos2<min_end_pos) min_end_pos = left_end_pos2;
+			}
+			if(mate_clip_1->rightClipReg and mate_clip_1->rightClipReg->chrname.compare(chrname_tmp)==0){
+				right_pos1 = mate_clip_1->rightClipReg->startRefPos;
+				right_end_pos1 = mate_clip_1->rightClipReg->endRefPos;
+				if(right_pos1<min_start_pos) min_start_pos = right_pos1;
+				if(right_end_pos1<min_end_pos) min_end_pos = right_end_pos1;
+			}
+			if(mate_clip_1->rightClipReg2 and mate_clip_1->rightClipReg2->chrname.compare(chrname_tmp)==0){
+				right_pos2 = mate_clip_1->rightClipReg2->startRefPos;
+				right_end_pos2 = mate_clip_1->rightClipReg2->endRefPos;
+				if(right_pos2<min_start_pos) min_start_pos = right_pos2;
+				if(right_end_pos2<min_end_pos) min_end_pos = right_end_pos2;
+			}
+		}else{ // large indel
+			min_start_pos = mate_clip_1->largeIndelClipReg->startRefPos;
+			min_end_pos = mate_clip_1->largeIndelClipReg->endRefPos;
+		}
 
-				if(swap_flag){ // swap
-					tmp = mateClipRegVector.at(j);
-					mateClipRegVector.at(j) = mateClipRegVector.at(j+1);
-					mateClipRegVector.at(j+1) = tmp;
-				}
-			}else{ // at least one large indel region
-				min_start_pos = min_end_pos = LONG_MAX;
-				if(mate_clip_1->large_indel_flag==false){ // clipping region
-					chrname_tmp = mate_clip_2->largeIndelClipReg->chrname;
-					if(mate_clip_1->leftClipReg and mate_clip_1->leftClipReg->chrname.compare(chrname_tmp)==0) {
-						left_pos1 = mate_clip_1->leftClipReg->startRefPos;
-						left_end_pos1 = mate_clip_1->leftClipReg->endRefPos;
-						if(left_pos1<min_start_pos) min_start_pos = left_pos1;
-						if(left_end_pos1<min_end_pos) min_end_pos = left_end_pos1;
-					}
-					if(mate_clip_1->leftClipReg2 and mate_clip_1->leftClipReg2->chrname.compare(chrname_tmp)==0) {
-						left_pos2 = mate_clip_1->leftClipReg2->startRefPos;
-						left_end_pos2 = mate_clip_1->leftClipReg2->endRefPos;
-						if(left_pos2<min_start_pos) min_start_pos = left_pos2;
-						if(left_end_pos2<min_end_pos) min_end_pos = left_end_pos2;
-					}
-					if(mate_clip_1->rightClipReg and mate_clip_1->rightClipReg->chrname.compare(chrname_tmp)==0){
-						right_pos1 = mate_clip_1->rightClipReg->startRefPos;
-						right_end_pos1 = mate_clip_1->rightClipReg->endRefPos;
-						if(right_pos1<min_start_pos) min_start_pos = right_pos1;
-						if(right_end_pos1<min_end_pos) min_end_pos = right_end_pos1;
-					}
-					if(mate_clip_1->rightClipReg2 and mate_clip_1->rightClipReg2->chrname.compare(chrname_tmp)==0){
-						right_pos2 = mate_clip_1->rightClipReg2->startRefPos;
-						right_end_pos2 = mate_clip_1->rightClipReg2->endRefPos;
-						if(right_pos2<min_start_pos) min_start_pos = right_pos2;
-						if(right_end_pos2<min_end_pos) min_end_pos = right_end_pos2;
-					}
-				}else{ // large indel
-					min_start_pos = mate_clip_1->largeIndelClipReg->startRefPos;
-					min_end_pos = mate_clip_1->largeIndelClipReg->endRefPos;
-				}
+		min_other_start_pos = min_other_end_pos = LONG_MAX;
+		if(mate_clip_2->large_indel_flag==false){ // clipping region
+			chrname_tmp = mate_clip_1->largeIndelClipReg->chrname;
+			if(mate_clip_2->leftClipReg and mate_clip_2->leftClipReg->chrname.compare(chrname_tmp)==0) {
+				other_left_pos1 = mate_clip_2->leftClipReg->startRefPos;
+				other_left_end_pos1 = mate_clip_2->leftClipReg->endRefPos;
+				if(other_left_pos1<min_other_start_pos) min_other_start_pos = other_left_pos1;
+				if(other_left_end_pos1<min_other_end_pos) min_other_end_pos = other_left_end_pos1;
+			}
+			if(mate_clip_2->leftClipReg2 and mate_clip_2->leftClipReg2->chrname.compare(chrname_tmp)==0) {
+				other_left_pos2 = mate_clip_2->leftClipReg2->startRefPos;
+				other_left_end_pos2 = mate_clip_2->leftClipReg2->endRefPos;
+				if(other_left_pos2<min_start_pos) min_other_start_pos = other_left_pos2;
+				if(other_left_end_pos2<min_end_pos) min_other_end_pos = other_left_end_pos2;
+			}
+			if(mate_clip_2->rightClipReg and mate_clip_2->rightClipReg->chrname.compare(chrname_tmp)==0){
+				other_right_pos1 = mate_clip_2->rightClipReg->startRefPos;
+				other_right_end_pos1 = mate_clip_2->rightClipReg->endRefPos;
+				if(other_right_pos1<min_other_start_pos) min_other_start_pos = other_right_pos1;
+				if(other_right_end_pos1<min_other_end_pos) min_other_end_pos = other_right_end_pos1;
+			}
+			if(mate_clip_2->rightClipReg2 and mate_clip_2->rightClipReg2->chrname.compare(chrname_tmp)==0){
+				other_right_pos2 = mate_clip_2->rightClipReg2->startRefPos;
+				other_right_end_pos2 = mate_clip_2->rightClipReg2->endRefPos;
+				if(other_right_pos2<min_other_start_pos) min_other_start_pos = other_right_pos2;
+				if(other_right_end_pos2<min_other_end_pos) min_other_end_pos = other_right_end_pos2;
+			}
+		}else{ // large indel
+			min_other_start_pos = mate_clip_2->largeIndelClipReg->startRefPos;
+			min_other_end_pos = mate_clip_2->largeIndelClipReg->endRefPos;
+		}
 
-				min_other_start_pos = min_other_end_pos = LONG_MAX;
-				if(mate_clip_2->large_indel_flag==false){ // clipping region
-					chrname_tmp = mate_clip_1->largeIndelClipReg->chrname;
-					if(mate_clip_2->leftClipReg and mate_clip_2->leftClipReg->chrname.compare(chrname_tmp)==0) {
-						other_left_pos1 = mate_clip_2->leftClipReg->startRefPos;
-						other_left_end_pos1 = mate_clip_2->leftClipReg->endRefPos;
-						if(other_left_pos1<min_other_start_pos) min_other_start_pos = other_left_pos1;
-						if(other_left_end_pos1<min_other_end_pos) min_other_end_pos = other_left_end_pos1;
-					}
-					if(mate_clip_2->leftClipReg2 and mate_clip_2->leftClipReg2->chrname.compare(chrname_tmp)==0) {
-						other_left_pos2 = mate_clip_2->leftClipReg2->startRefPos;
-						other_left_end_pos2 = mate_clip_2->leftClipReg2->endRefPos;
-						if(other_left_pos2<min_start_pos) min_other_start_pos = other_left_pos2;
-						if(other_left_end_pos2<min_end_pos) min_other_end_pos = other_left_end_pos2;
-					}
-					if(mate_clip_2->rightClipReg and mate_clip_2->rightClipReg->chrname.compare(chrname_tmp)==0){
-						other_right_pos1 = mate_clip_2->rightClipReg->startRefPos;
-						other_right_end_pos1 = mate_clip_2->rightClipReg->endRefPos;
-						if(other_right_pos1<min_other_start_pos) min_other_start_pos = other_right_pos1;
-						if(other_right_end_pos1<min_other_end_pos) min_other_end_pos = other_right_end_pos1;
-					}
-					if(mate_clip_2->rightClipReg2 and mate_clip_2->rightClipReg2->chrname.compare(chrname_tmp)==0){
-						other_right_pos2 = mate_clip_2->rightClipReg2->startRefPos;
-						other_right_end_pos2 = mate_clip_2->rightClipReg2->endRefPos;
-						if(other_right_pos2<min_other_start_pos) min_other_start_pos = other_right_pos2;
-						if(other_right_end_pos2<min_other_end_pos) min_other_end_pos = other_right_end_pos2;
-					}
-				}else{ // large indel
-					min_other_start_pos = mate_clip_2->largeIndelClipReg->startRefPos;
-					min_other_end_pos = mate_clip_2->largeIndelClipReg->endRefPos;
-				}
+		swap_flag = false;
+		if(min_start_pos>min_other_start_pos) swap_flag = true;
+		else if(min_start_pos==min_other_start_pos){
+			if(min_end_pos>min_other_end_pos) swap_flag = true;
+		}
+	}
 
-				swap_flag = false;
-				if(min_start_pos>min_other_start_pos) swap_flag = true;
-				else if(min_start_pos==min_other_start_pos){
-					if(min_end_pos>min_other_end_pos) swap_flag = true;
-				}
+	return swap_flag;
+}
 
-				if(swap_flag){ // swap
-					tmp = mateClipRegVector.at(j);
-					mateClipRegVector.at(j) = mateClipRegVector.at(j+1);
-					mateClipRegVector.at(j+1) = tmp;
-				}
-			}
+// sort mate clipping region items by insertion sort, the items collected by work id are nearly in order
+void Chrome::sortMateClipRegs(){
+	size_t i, j;
+	mateClipReg_t *tmp;
+
+	for(i=1; i<mateClipRegVector.size(); i++){
+		for(j=i; j>0 and isMateClipRegPairSwapped(mateClipRegVector.at(j-1), mateClipRegVector.at(j)); j--){ // swap
+			tmp = mateClipRegVector.at(j-1);
+			mateClipRegVector.at(j-1) = mateClipRegVector.at(j);
+			mateClipRegVector.at(j) = tmp;
 		}
 	}
 }
@@ -1366,6 +1338,26 @@ void Chrome::chrMergeDetectResultToFile(){
 	out_file_snv.close();
 	out_file_indel.close();
 
+	// simple indels called by the fast path, columns: chr, start, end, type, sv_len, refseq, altseq, supp_num, depth
+	if(paras->fast_path_flag){
+		out_file_indel.open(out_filename_detect_fast_indel);
+		if(!out_file_indel.is_open()){
+			cerr << __func__ << ", line=" << __LINE__ << ": cannot open file:" << out_filename_detect_fast_indel << endl;
+			exit(1);
+		}
+		for(i=0; i<blockVector.size(); i++){
+			bloc = blockVector.at(i);
+			for(j=0; j<bloc->fastPathVarVector.size(); j++){
+				reg = bloc->fastPathVarVector.at(j);
+				var_type = (reg->var_type==VAR_INS) ? VAR_INS_STR : VAR_DEL_STR;
+				out_file_indel << reg->chrname << "\t" << reg->startRefPos << "\t" << reg->endRefPos << "\t" << var_type << "\t" << reg->sv_len << "\t" << reg->refseq << "\t" << reg->altseq << "\t" << reg->supp_num << "\t" << reg->DP << endl;
+			}
+			paras->fast_path_indel_num += bloc->fastPathVarVector.size();
+			paras->detect_indel_num += bloc->fastPathVarVector.size() + bloc->indelVector.size();
+		}
+		out_file_indel.close();
+	}else if(isFileExist(out_filename_detect_fast_indel)) remove(out_filename_detect_fast_indel.c_str()); // stale result of a previous run
+
 	// clipping regions
 	out_file_clipReg.open(out_filename_detect_clipReg);
 	if(!out_file_clipReg.is_open()){
@@ -1855,6 +1847,7 @@ void Chrome::chrLoadIndelDataCons(){
 	//if(paras->limit_reg_process_flag) limit_reg_vec = getSimpleRegs(chrname, -1, -1, paras->limit_reg_vec);
 	if(paras->limit_reg_process_flag) limit_reg_vec = getOverlappedSimpleRegs(chrname, -1, -1, paras->limit_reg_vec);
 	chrLoadIndelData(paras->limit_reg_process_flag, limit_reg_vec);
+	paras->fast_path_indel_num += countFastPathIndels(paras->limit_reg_process_flag, limit_reg_vec);  // called in the previous detect stage
 }
 
 // load detected indel data
@@ -1928,6 +1921,115 @@ void Chrome::chrLoadIndelData(bool limit_reg_process_flag, vector<simpleReg_t*>
 	if(limit_reg_process_flag) delete simple_reg;
 }
 
+// load the simple indels called by the fast path in detect stage, and genotype them by Nsupp and Depth
+void Chrome::loadFastPathIndelData(bool limit_reg_process_flag, vector<simpleReg_t*> &limit_reg_vec){
+	string line, gt_str;
+	vector<string> str_vec;
+	vector<simpleReg_t*> sub_limit_reg_vec;
+	ifstream infile;
+	int64_t begPos, endPos;
+	reg_t *reg;
+	double val;
+
+	if(!fast_path_var_vec.empty()) destroyFastPathVarVec();
+	if(isFileExist(out_filename_detect_fast_indel)==false) return;
+
+	infile.open(out_filename_detect_fast_indel);
+	if(!infile.is_open()){
+		cerr << __func__ << ", line=" << __LINE__ << ": cannot open file:" << out_filename_detect_fast_indel << endl;
+		exit(1);
+	}
+
+	while(getline(infile, line)){
+		if(line.size()>0 and line.at(0)!='#'){
+			str_vec = split(line, "\t");
+			begPos = stoi(str_vec.at(1));
+			endPos = stoi(str_vec.at(2));
+
+			// deal with limit regions
+			if(limit_reg_process_flag){
+				sub_limit_reg_vec = getOverlappedSimpleRegs(chrname, begPos, endPos, limit_reg_vec);
+				if(sub_limit_reg_vec.size()==0) continue;
+			}
+
+			reg = new reg_t();
+			reg->chrname = chrname;
+			reg->startRefPos = begPos;
+			reg->endRefPos = endPos;
+			reg->startLocalRefPos = reg->endLocalRefPos = 0;
+			reg->startQueryPos = reg->endQueryPos = 0;
+			reg->var_type = (str_vec.at(3).compare(VAR_INS_STR)==0) ? VAR_INS : VAR_DEL;
+			reg->sv_len = stoi(str_vec.at(4));
+			reg->refseq = str_vec.at(5);
+			reg->altseq = str_vec.at(6);
+			reg->supp_num = stoi(str_vec.at(7));
+			reg->DP = stoi(str_vec.at(8));
+			reg->query_id = -1;
+			reg->blat_aln_id = -1;
+			reg->minimap2_aln_id = -1;
+			reg->call_success_status = true;
+			reg->short_sv_flag = false;
+			reg->zero_cov_flag = false;
+			reg->aln_seg_end_flag = false;
+			reg->query_pos_invalid_flag = false;
+			reg->large_indel_flag = false;
+			reg->discover_level = VAR_DISCOV_L_READS;
+
+			// genotyping
+			val = (double)reg->supp_num / reg->DP;
+			if(val>=paras->gt_homo_ratio){
+				reg->gt_type = GT_HOMOZYGOUS;
+				gt_str = GT_HOMOZYGOUS_STR;
+			}else if(val>=paras->gt_hete_ratio){
+				reg->gt_type = GT_HETEROZYGOUS;
+				gt_str = GT_HETEROZYGOUS_STR;
+			}else{
+				reg->gt_type = GT_NOZYGOUS;
+				gt_str = GT_NOZYGOUS_STR;
+			}
+			reg->AF = val;
+			reg->gt_seq = "GT:AD:DP\t" + gt_str + ":" + to_string(reg->DP-reg->supp_num) + "," + to_string(reg->supp_num) + ":" + to_string(reg->DP);
+
+			fast_path_var_vec.push_back(reg);
+		}
+	}
+	infile.close();
+}
+
+// count the indels called by the fast path in detect stage
+int64_t Chrome::countFastPathIndels(bool limit_reg_process_flag, vector<simpleReg_t*> &limit_reg_vec){
+	string line;
+	vector<string> str_vec;
+	vector<simpleReg_t*> sub_limit_reg_vec;
+	ifstream infile;
+	int64_t begPos, endPos, indel_num;
+
+	indel_num = 0;
+	if(isFileExist(out_filename_detect_fast_indel)==false) return 0;
+
+	infile.open(out_filename_detect_fast_indel);
+	if(!infile.is_open()){
+		cerr << __func__ << ", line=" << __LINE__ << ": cannot open file:" << out_filename_detect_fast_indel << endl;
+		exit(1);
+	}
+
+	while(getline(infile, line)){
+		if(line.size()>0 and line.at(0)!='#'){
+			if(limit_reg_process_flag){
+				str_vec = split(line, "\t");
+				begPos = stoi(str_vec.at(1));
+				endPos = stoi(str_vec.at(2));
+				sub_limit_reg_vec = getOverlappedSimpleRegs(chrname, begPos, endPos, limit_reg_vec);
+				if(sub_limit_reg_vec.size()==0) continue;
+			}
+			indel_num ++;
+		}
+	}
+	infile.close();
+
+	return indel_num;
+}
+
 // load detected indel data for local consensus
 void Chrome::chrLoadClipRegDataCons(){
 	chrLoadMateClipRegDataOp(paras->limit_reg_process_flag, paras->limit_reg_vec);
@@ -2343,24 +2445,36 @@ int Chrome::chrGenerateLocalConsWorkOpt_st(){
 
 // generate local consensus work for chrome using multiple threads
 int Chrome::chrGenerateLocalConsWorkOpt_mt(){
-	int32_t i;
-	MultiThread mt[paras->num_threads];
-	for(i=0; i<paras->num_threads; i++){
-		mt[i].setNumThreads(paras->num_threads);
-		mt[i].setBlockVec(&blockVector);
-		mt[i].setUserThreadID(i);
-		if(!mt[i].startGenConsWorkOpt()){
-			cerr << __func__ << ", line=" << __LINE__ << ": unable to create thread, error!" << endl;
-			exit(1);
+	dispatchBlockWork(TASK_TYPE_GEN_CNS_WORK, processSingleBlockGenConsWorkOptWork);
+	paras->thread_pool->wait(TASK_TYPE_GEN_CNS_WORK);
+	return 0;
+}
+
+// dispatch the block works to thread pool; in NUMA mode, the blocks are split into contiguous chunks,
+// one chunk per node, and the chunks are dispatched in interleaved order to feed all the nodes
+void Chrome::dispatchBlockWork(int32_t task_type, taskFunc_t func){
+	int32_t num_nodes, node, chunk_size;
+	size_t i, idx;
+	Block *bloc;
+
+	num_nodes = paras->thread_pool->getNumNumaNodes();
+	if(num_nodes<=1){
+		for(i=0; i<blockVector.size(); i++){
+			bloc = blockVector.at(i);
+			if(bloc->process_flag) paras->thread_pool->dispatch(task_type, func, bloc);
 		}
-	}
-	for(i=0; i<paras->num_threads; i++){
-		if(!mt[i].join()){
-			cerr << __func__ << ", line=" << __LINE__ << ": unable to join, error!" << endl;
-			exit(1);
+	}else{
+		chunk_size = (blockVector.size() + num_nodes - 1) / num_nodes;
+		for(i=0; i<(size_t)chunk_size; i++){
+			for(node=0; node<num_nodes; node++){
+				idx = (size_t)node * chunk_size + i;
+				if(idx<blockVector.size()){
+					bloc = blockVector.at(idx);
+					if(bloc->process_flag) paras->thread_pool->dispatch(task_type, func, bloc, node);
+				}
+			}
 		}
 	}
-	return 0;
 }
 
 // reset chrome consensus data
@@ -2470,23 +2584,10 @@ void Chrome::chrCallVariants(vector<varCand*> &var_cand_vec){
 
 // call variants for chrome using multiple threads
 void Chrome::chrCall_mt(){
-	int32_t i;
-	MultiThread mt[paras->num_threads];
-	for(i=0; i<paras->num_threads; i++){
-		mt[i].setNumThreads(paras->num_threads);
-		mt[i].setVarCandVec(&var_cand_vec, &var_cand_clipReg_vec);
-		mt[i].setUserThreadID(i);
-		if(!mt[i].startCall()){
-			cerr << __func__ << ", line=" << __LINE__ << ": unable to create thread, error!" << endl;
-			exit(1);
-		}
-	}
-	for(i=0; i<paras->num_threads; i++){
-		if(!mt[i].join()){
-			cerr << __func__ << ", line=" << __LINE__ << ": unable to join, error!" << endl;
-			exit(1);
-		}
-	}
+	size_t i;
+	for(i=0; i<var_cand_vec.size(); i++) paras->thread_pool->dispatch(TASK_TYPE_CALL, processSingleVarCandCallWork, var_cand_vec.at(i));
+	for(i=0; i<var_cand_clipReg_vec.size(); i++) paras->thread_pool->dispatch(TASK_TYPE_CALL, processSingleVarCandCallWork, var_cand_clipReg_vec.at(i));
+	paras->thread_pool->wait(TASK_TYPE_CALL);
 }
 
 
@@ -2510,6 +2611,7 @@ void Chrome::loadVarCandData(){
 	//if(mateClipRegVector.size()==0) chrLoadMateClipRegDataOp(paras->limit_reg_process_flag, limit_reg_vec);
 	loadVarCandDataFromFile(var_cand_vec, var_cand_indel_filename, false, paras->limit_reg_process_flag, limit_reg_vec);
 	loadVarCandDataFromFile(var_cand_clipReg_vec, var_cand_clipReg_filename, true, paras->limit_reg_process_flag, paras->limit_reg_vec);
+	loadFastPathIndelData(paras->limit_reg_process_flag, limit_reg_vec);
 
 	// load previously minimap2 aligned information
 	//loadPrevMinimapAlnItems(false, paras->limit_reg_process_flag, limit_reg_vec);
@@ -2785,6 +2887,7 @@ void Chrome::loadVarCandDataFromFile(vector<varCand*> &var_cand_vec, string &var
 
 				// process monitor killed blat work
 				var_cand_tmp->max_proc_running_minutes = paras->max_proc_running_minutes_call;
+				var_cand_tmp->minimap2_lib_flag = paras->minimap2_lib_flag;
 				var_cand_tmp->killed_blat_work_vec = &paras->killed_blat_work_vec;
 				var_cand_tmp->killed_blat_work_file = &paras->killed_blat_work_file;
 				var_cand_tmp->mtx_killed_blat_work = &paras->mtx_killed_blat_work;
@@ -3124,6 +3227,7 @@ void Chrome::loadPrevMinimapAlnItems(bool clipReg_flag, bool limit_reg_process_f
 
 				// process monitor killed blat work
 				var_cand_tmp->max_proc_running_minutes = paras->max_proc_running_minutes_call;
+				var_cand_tmp->minimap2_lib_flag = paras->minimap2_lib_flag;
 				var_cand_tmp->killed_blat_work_vec = &paras->killed_blat_work_vec;
 				var_cand_tmp->killed_blat_work_file = &paras->killed_blat_work_file;
 				var_cand_tmp->mtx_killed_blat_work = &paras->mtx_killed_blat_work;
@@ -3808,6 +3912,7 @@ void Chrome::saveCallIndelClipReg2File02(string &outfilename_indel, string &outf
 	varCand *var_cand; //, *var_cand_pre, *var_cand_pre_pre;
 	reg_t *reg;
 	string line, sv_type, header_line_bed, discov_level_str;
+	vector<reg_t*> indel_var_vec;
 	int32_t ref_dist, query_dist;
 	static int32_t ins_num = 0, del_num = 0, dup_num= 0, inv_num = 0, tra_num = 0, sv_num;
 	bool size_satisfied; //, no_existed;
@@ -3822,86 +3927,90 @@ void Chrome::saveCallIndelClipReg2File02(string &outfilename_indel, string &outf
 	header_line_bed = getCallFileHeaderBed(paras->sample);
 	outfile << header_line_bed << endl;
 
+	// indel regions, including the simple indels called by the fast path
 	for(i=0; i<var_cand_vec.size(); i++){ // indel region
 		var_cand = var_cand_vec.at(i);
 //		if(i>0) var_cand_pre = var_cand_vec.at(i-1);
 //		if(i>1) var_cand_pre_pre = var_cand_vec.at(i-2);
-		for(j=0; j<var_cand->newVarVec.size(); j++){
-			//no_existed = true;
-			reg = var_cand->newVarVec.at(j);
-			// choose the size-selected variants
-			size_satisfied = isSizeSatisfied2(reg->sv_len, paras->min_sv_size_usr, paras->max_sv_size_usr);
-
-//			if(i>0) no_existed = isNotAlreadyExists(var_cand_pre->newVarVec, reg);
-//			if(i>1 and no_existed) no_existed = isNotAlreadyExists(var_cand_pre_pre->newVarVec, reg);
-//			if(no_existed) no_existed = isNotAlreadyExists(var_cand->newVarVec, reg, j);
-
-			//if(reg->var_type!=VAR_UNC and reg->call_success_status and size_satisfied and no_existed){ // deleted on 2024-08-02
-			sv_num = 0;
-			if(reg->var_type!=VAR_UNC and reg->call_success_status and size_satisfied){
-				switch(reg->var_type){
-					case VAR_UNC: sv_type = VAR_UNC_STR; break;
-					case VAR_INS: sv_type = VAR_INS_STR; ins_num++; sv_num = ins_num; break;
-					case VAR_DEL: sv_type = VAR_DEL_STR; del_num++; sv_num = del_num; break;
-					case VAR_DUP: sv_type = VAR_DUP_STR; dup_num++; sv_num = dup_num; break;
-					case VAR_INV: sv_type = VAR_INV_STR; inv_num++; sv_num = inv_num; break;
-					case VAR_TRA: sv_type = VAR_TRA_STR; tra_num++; sv_num = tra_num; break;
-					default: sv_type = VAR_MIX_STR; break;
-				}
-				// line = reg->chrname + "\t" + to_string(reg->startRefPos) + "\t" + to_string(reg->endRefPos) + "\t" + sv_type;
-				line = reg->chrname + "\t" + to_string(reg->startRefPos) + "\t" + to_string(reg->endRefPos) + "\tASVCLR." + sv_type + "." + to_string(sv_num) + "\t" + sv_type;
-				if(reg->var_type!=VAR_TRA)
-					line += "\t" + to_string(reg->sv_len);
-				else
-					line += "\t-";
-				if(reg->var_type==VAR_DUP)
-					line += "\t" + to_string(reg->dup_num);
-				else
-					line += "\t-";
-
-				//upperSeq
-				if(reg->refseq.size()) {
-					upperSeq(reg->refseq);
-					line += "\t" + reg->refseq;
-				}
-				else line += "\t-";
-				if(reg->altseq.size()){
-					upperSeq(reg->altseq);
-					line += "\t" + reg->altseq;
-				}
-				else line += "\t-";
-
-				// extra information, split with ";"
-				stringstream ss;
-				ss << setprecision(3) << reg->AF;
-				line += "\tDP=" + to_string(reg->DP) + ";AF=" + ss.str();
-
-				discov_level_str = "";
-				switch(reg->discover_level){
-					case VAR_DISCOV_L_UNUSED:
-						break;
-					case VAR_DISCOV_L_CNS_ALN:
-						discov_level_str = VAR_DISCOV_L_CNS_ALN_STR;
-						break;
-					case VAR_DISCOV_L_RESCUE_CNS_ALN:
-						discov_level_str = VAR_DISCOV_L_RESCUE_CNS_ALN_STR;
-						break;
-					case VAR_DISCOV_L_READS:
-						discov_level_str = VAR_DISCOV_L_READS_STR;
-						break;
-				}
-				if(discov_level_str.size()>0) line = line + ";" + VAR_DISCOV_L_TITLE_STR + "=" + discov_level_str;
+		for(j=0; j<var_cand->newVarVec.size(); j++) indel_var_vec.push_back(var_cand->newVarVec.at(j));
+	}
+	indel_var_vec.insert(indel_var_vec.end(), fast_path_var_vec.begin(), fast_path_var_vec.end());
+
+	for(j=0; j<indel_var_vec.size(); j++){
+		//no_existed = true;
+		reg = indel_var_vec.at(j);
+		// choose the size-selected variants
+		size_satisfied = isSizeSatisfied2(reg->sv_len, paras->min_sv_size_usr, paras->max_sv_size_usr);
+
+//		if(i>0) no_existed = isNotAlreadyExists(var_cand_pre->newVarVec, reg);
+//		if(i>1 and no_existed) no_existed = isNotAlreadyExists(var_cand_pre_pre->newVarVec, reg);
+//		if(no_existed) no_existed = isNotAlreadyExists(var_cand->newVarVec, reg, j);
+
+		//if(reg->var_type!=VAR_UNC and reg->call_success_status and size_satisfied and no_existed){ // deleted on 2024-08-02
+		sv_num = 0;
+		if(reg->var_type!=VAR_UNC and reg->call_success_status and size_satisfied){
+			switch(reg->var_type){
+				case VAR_UNC: sv_type = VAR_UNC_STR; break;
+				case VAR_INS: sv_type = VAR_INS_STR; ins_num++; sv_num = ins_num; break;
+				case VAR_DEL: sv_type = VAR_DEL_STR; del_num++; sv_num = del_num; break;
+				case VAR_DUP: sv_type = VAR_DUP_STR; dup_num++; sv_num = dup_num; break;
+				case VAR_INV: sv_type = VAR_INV_STR; inv_num++; sv_num = inv_num; break;
+				case VAR_TRA: sv_type = VAR_TRA_STR; tra_num++; sv_num = tra_num; break;
+				default: sv_type = VAR_MIX_STR; break;
+			}
+			// line = reg->chrname + "\t" + to_string(reg->startRefPos) + "\t" + to_string(reg->endRefPos) + "\t" + sv_type;
+			line = reg->chrname + "\t" + to_string(reg->startRefPos) + "\t" + to_string(reg->endRefPos) + "\tASVCLR." + sv_type + "." + to_string(sv_num) + "\t" + sv_type;
+			if(reg->var_type!=VAR_TRA)
+				line += "\t" + to_string(reg->sv_len);
+			else
+				line += "\t-";
+			if(reg->var_type==VAR_DUP)
+				line += "\t" + to_string(reg->dup_num);
+			else
+				line += "\t-";
+
+			//upperSeq
+			if(reg->refseq.size()) {
+				upperSeq(reg->refseq);
+				line += "\t" + reg->refseq;
+			}
+			else line += "\t-";
+			if(reg->altseq.size()){
+				upperSeq(reg->altseq);
+				line += "\t" + reg->altseq;
+			}
+			else line += "\t-";
+
+			// extra information, split with ";"
+			stringstream ss;
+			ss << setprecision(3) << reg->AF;
+			line += "\tDP=" + to_string(reg->DP) + ";AF=" + ss.str();
+
+			discov_level_str = "";
+			switch(reg->discover_level){
+				case VAR_DISCOV_L_UNUSED:
+					break;
+				case VAR_DISCOV_L_CNS_ALN:
+					discov_level_str = VAR_DISCOV_L_CNS_ALN_STR;
+					break;
+				case VAR_DISCOV_L_RESCUE_CNS_ALN:
+					discov_level_str = VAR_DISCOV_L_RESCUE_CNS_ALN_STR;
+					break;
+				case VAR_DISCOV_L_READS:
+					discov_level_str = VAR_DISCOV_L_READS_STR;
+					break;
+			}
+			if(discov_level_str.size()>0) line = line + ";" + VAR_DISCOV_L_TITLE_STR + "=" + discov_level_str;
 
-				if(reg->gt_seq.size()==0) reg->gt_seq = GT_STR_DEFAULT;
-				line += "\t" + reg->gt_seq;
+			if(reg->gt_seq.size()==0) reg->gt_seq = GT_STR_DEFAULT;
+			line += "\t" + reg->gt_seq;
 
 
-				if(reg->short_sv_flag) line += "\tShortSV";
+			if(reg->short_sv_flag) line += "\tShortSV";
 
-				//cout << "line=" << __LINE__ << ": " << line << endl;
+			//cout << "line=" << __LINE__ << ": " << line << endl;
 
-				outfile << line << endl;
-			}
+			outfile << line << endl;
 		}
 	}
 	outfile.close();
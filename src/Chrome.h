@@ -14,6 +14,7 @@
 #include "Block.h"
 #include "varCand.h"
 #include "clipReg.h"
+#include "Thread.h"
 
 using namespace std;
 
@@ -36,12 +37,13 @@ class Chrome{
 
 		// output directory
 		string out_dir_detect, out_dir_cns, out_dir_call;
-		string out_filename_detect_snv, out_filename_detect_indel, out_filename_detect_clipReg;
+		string out_filename_detect_snv, out_filename_detect_indel, out_filename_detect_clipReg, out_filename_detect_fast_indel;
 		string out_filename_call_snv, out_filename_call_indel, out_filename_call_clipReg;
 
 		vector<mateClipReg_t*> mateClipRegVector;
 		vector<varCand*> var_cand_vec;
 		vector<varCand*> var_cand_clipReg_vec;
+		vector<reg_t*> fast_path_var_vec;	// simple indels called in detect stage without local consensus
 
 		vector<Block*> blockVector;
 
@@ -109,9 +111,12 @@ class Chrome{
 		void destroyMisAlnVector();
 		void destroyClipRegVector();
 		void destroyMateClipRegVector();
+		void destroyFastPathVarVec();
 		void chrLoadIndelDataCons();
 		void chrLoadIndelData(bool limit_reg_process_flag, vector<simpleReg_t*> &limit_reg_vec);
 		void chrLoadClipRegDataCons();
+		void loadFastPathIndelData(bool limit_reg_process_flag, vector<simpleReg_t*> &limit_reg_vec);
+		int64_t countFastPathIndels(bool limit_reg_process_flag, vector<simpleReg_t*> &limit_reg_vec);
 		int chrDetect_st();
 		int chrDetect_mt();
 		void removeRedundantIndelDetect();
@@ -123,6 +128,7 @@ class Chrome{
 		int32_t computeBlocID(int64_t begPos, vector<Block*> &block_vec);
 		int chrGenerateLocalConsWorkOpt_st();
 		int chrGenerateLocalConsWorkOpt_mt();
+		void dispatchBlockWork(int32_t task_type, taskFunc_t func);
 		void outputCnsDataToFile(string &filename);
 		void loadPrevConsInfo2(bool clipReg_flag, bool limit_reg_process_flag, vector<simpleReg_t*> &limit_reg_vec, vector<cnsWork_opt*> &cns_work_vec);
 		string getCnsFileHeaderLine();
@@ -154,8 +160,8 @@ class Chrome{
 		void chrComputeMateClipReg();
 		//void processMateClipRegDetectWork(vector<bool> &clip_processed_flag_vec);
 		void processMateClipRegDetectWork();
-		void sortMateClipRegsByWorkId();
-		void bubbleSortMateClipRegs();
+		void sortMateClipRegs();
+		bool isMateClipRegPairSwapped(mateClipReg_t *mate_clip_1, mateClipReg_t *mate_clip_2);
 		void checkSortMateClipRegs();
 		//void removeRedundantItemsClipReg(vector<reg_t*> &clipReg_vec, vector<bool> &clip_processed_flag_vec);
 		void removeRedundantItemsClipReg(vector<reg_t*> &clipReg_vec);
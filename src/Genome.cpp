@@ -3,7 +3,9 @@
 #include <fstream>
 #include <string>
 #include <pthread.h>
-#include <htslib/thread_pool.h>
+#include <map>
+#include <set>
+#include <algorithm>
 
 #include "Genome.h"
 #include "Thread.h"
@@ -26,6 +28,7 @@ Genome::Genome(Paras *paras){
 
 //Destructor
 Genome::~Genome(){
+	removeScratchDir();
 	destroyChromeVector();
 	fai_destroy(fai);
 	bam_hdr_destroy(header);
@@ -59,6 +62,7 @@ void Genome::init(){
 	mkdir(out_dir_cns.c_str(), S_IRWXU | S_IRGRP | S_IXGRP | S_IROTH | S_IXOTH);  // create directory for consensus command
 	mkdir(out_dir_call.c_str(), S_IRWXU | S_IRGRP | S_IXGRP | S_IROTH | S_IXOTH);  // create directory for call command
 	mkdir(out_dir_tra.c_str(), S_IRWXU | S_IRGRP | S_IXGRP | S_IROTH | S_IXOTH);  // create the directory for TRA
+	initScratchDir(paras->scratch_dir);  // transient consensus and alignment files
 
 	result_prefix = "";
 	if(paras->outFilePrefix.size()) result_prefix = paras->outFilePrefix + "_";
@@ -329,15 +333,23 @@ int Genome::genomeDetect(){
 	// remove overlapped indels from mate clipping regions
 	removeOverlappedIndelFromMateClipReg();
 
+	// extract the simple indels called by the fast path after all the filters of the candidates
+	if(paras->fast_path_flag) extractFastPathIndels();
+
 	//cout << "[" << time.getTime() << "]: saveDetectResultToFile() ..." << endl;
 	// save detect result to file for each chrome
 	saveDetectResultToFile();
 
+	if(paras->fast_path_flag and paras->detect_indel_num>0)
+		cout << "Indel candidates called by the fast path: " << paras->fast_path_indel_num << "/" << paras->detect_indel_num << " (" << round(1000.0 * paras->fast_path_indel_num / paras->detect_indel_num) / 10 << "%)" << endl;
+
 	mergeDetectResult();
 
 	// compute statistics for detect command
 	computeVarNumStatDetect();
 
+	paras->thread_pool->printNumaStat(TASK_TYPE_DETECT, "block detection");
+
 	return 0;
 }
 
@@ -596,6 +608,16 @@ mateClipReg_t* Genome::getSameClipRegTRA(mateClipReg_t *clip_reg_given, vector<C
 	return clip_reg_ret;
 }
 
+// extract the simple indels called by the fast path from the candidates of each block
+void Genome::extractFastPathIndels(){
+	Chrome *chr;
+	for(size_t i=0; i<chromeVector.size(); i++){
+		chr = chromeVector.at(i);
+		for(size_t j=0; j<chr->blockVector.size(); j++)
+			chr->blockVector.at(j)->extractFastPathIndels();
+	}
+}
+
 // save detect result to file for each chrome
 void Genome::saveDetectResultToFile(){
 	Chrome *chr;
@@ -644,7 +666,9 @@ void Genome::mergeDetectResult(){
 // local consensus for genome
 int Genome::genomeLocalCons(){
 	Chrome *chr;
-	Time time;
+	Time time, cns_time;
+	double cns_seconds;
+	int64_t indel_work_num;
 
 	// load consensus data
 	genomeLoadDataCons();
@@ -652,12 +676,18 @@ int Genome::genomeLocalCons(){
 	cout << "Number of previously processed regions: " << paras->cns_reg_preDone_num << endl;
 	cout << "Number of regions to be processed: " << paras->cns_reg_work_total << endl;
 
-	// invoke the monitor of conseneus work process
-	//startWorkProcessMonitor(work_finish_filename, paras->monitoring_proc_names_cns, paras->max_proc_running_minutes_cns);
-
 	// begin consensus
 	if(!paras->cns_work_vec.empty()) cout << "[" << time.getTime() << "]: start local consensus ..." << endl;
+	resetMemAdmitStat();
+	resetPoaLatencyStat();
+	setCnsCacheDir(paras->cns_cache_dir, paras->abpoa_version, paras->wtdbg2_version);
+	resetCnsCacheStat();
+	cns_time.setStartTime();
 	processConsWork();
+	cns_seconds = paras->cns_work_vec.empty() ? 0 : cns_time.getElapsedSeconds();
+	printMemAdmitStat("local consensus");
+	printCpuTokenStat("local consensus");
+	printPoaLatencyStat();
 
 //	for(size_t i=0; i<1001; i++){
 //		cout << i << "\t" << sig_num_arr[i] << endl;
@@ -667,6 +697,12 @@ int Genome::genomeLocalCons(){
 
 	computeVarNumStatCons(); // compute statistics for cns command
 
+	// estimated by the mean time of the indel consensus works, as each fast path indel would otherwise be a separate work
+	indel_work_num = 0;
+	for(size_t i=0; i<paras->cns_work_vec.size(); i++) if(paras->cns_work_vec.at(i)->clip_reg_flag==false) indel_work_num ++;
+	if(paras->fast_path_indel_num>0 and indel_work_num>0)
+		cout << "Estimated consensus time saved by the fast path: " << round(cns_seconds / indel_work_num * paras->fast_path_indel_num) << " seconds for " << paras->fast_path_indel_num << " indels" << endl;
+
 	if(!paras->cns_work_vec.empty()) destroyConsWorkOptVec(paras->cns_work_vec);
 
 	// reset consensus data
@@ -736,8 +772,7 @@ int Genome::processConsWork(){
 //	else
 //		cout << "Local consensus will be processed using " << num_threads_work << " concurrent works, and each work will be limited to " << paras->num_threads_per_cns_work << " threads" << endl;
 
-	hts_tpool *p = hts_tpool_init(num_threads_work);
-	hts_tpool_process *q = hts_tpool_process_init(p, num_threads_work*2, 1);
+	paras->thread_pool->setMaxRunningNum(TASK_TYPE_CNS, num_threads_work);
 
 	pthread_mutex_init(&paras->mtx_cns_reg_workDone_num, NULL);
 
@@ -745,6 +780,10 @@ int Genome::processConsWork(){
 	num_work = paras->cns_work_vec.size();
 	num_work_percent = num_work / (paras->num_parts_progress >> 1);
 	if(num_work_percent==0) num_work_percent = 1;
+
+	// the external consensus jobs share the CPU budget with the consensus workers
+	initCpuTokens(paras->num_threads, num_threads_work, num_work, paras->num_threads_per_cns_work);
+
 	for(i=0; i<num_work; i++){
 		cns_work_opt = paras->cns_work_vec.at(i);
 		var_cand_file = getVarcandFile(cns_work_opt->chrname, chromeVector, cns_work_opt->clip_reg_flag);
@@ -808,6 +847,7 @@ int Genome::processConsWork(){
 		cns_work->min_supp_num = paras->minReadsNumSupportSV;
 		cns_work->sv_len_est = sv_len_sum;
 		cns_work->max_seg_size_ratio = paras->max_seg_size_ratio_usr;
+		cns_work->max_proc_running_minutes = paras->max_proc_running_minutes_cns;
 		cns_work->inBamFile = paras->inBamFile;
 		cns_work->fai = fai;
 		cns_work->var_cand_file = var_cand_file;
@@ -821,12 +861,9 @@ int Genome::processConsWork(){
 		cns_work->minMapQ = paras->minMapQ;
 		cns_work->minHighMapQ = paras->minHighMapQ;
 
-		hts_tpool_dispatch(p, q, processSingleConsWork, cns_work);
+		paras->thread_pool->dispatch(TASK_TYPE_CNS, processSingleConsWork, cns_work);
 	}
-
-	hts_tpool_process_flush(q);
-	hts_tpool_process_destroy(q);
-	hts_tpool_destroy(p);
+	paras->thread_pool->wait(TASK_TYPE_CNS);
 
 	// create the work finish file
 	//generateFile(work_finish_filename);
@@ -865,9 +902,9 @@ void Genome::generateFile(string &filename){
 int Genome::genomeCall(){
 	Time time;
 	
-	// initialize the variables for process monitor killed blat works
-	//initMonitorKilledBlatWorkMem();
-	//initMonitorKilledMinimap2WorkMem();
+	// initialize the variables for the works killed by the process watchdog
+	initMonitorKilledBlatWorkMem();
+	initMonitorKilledMinimap2WorkMem();
 
 	// load clipping region information
 	genomeLoadMateClipRegData();
@@ -878,10 +915,8 @@ int Genome::genomeCall(){
 
 	cout << "Number of regions to be processed: " << paras->call_work_num << endl;
 
-	// invoke the monitor of consensus work process
-	//startWorkProcessMonitor(work_finish_filename, paras->monitoring_proc_names_call, paras->max_proc_running_minutes_call);
-
 	// blat alignment work
+	resetMemAdmitStat();
 	time.setStartTime();
 	processAlnWork();
 	time.printElapsedTime();
@@ -890,6 +925,8 @@ int Genome::genomeCall(){
 	time.setStartTime();
 	processCallWork();
 	time.printElapsedTime();
+	printMemAdmitStat("variant call");
+	printCpuTokenStat("variant call");
 
 	// finish call work
 	//genomeFinishCallWork();
@@ -928,8 +965,8 @@ int Genome::genomeCall(){
 	cout << "[" << time.getTime() << "]: compute variant NUMBER statistics... " << endl;
 	computeVarNumStatCall();
 
-	//releaseMonitorKilledBlatWorkMem();
-	//releaseMonitorKilledMinimap2WorkMem();
+	releaseMonitorKilledBlatWorkMem();
+	releaseMonitorKilledMinimap2WorkMem();
 
 	return 0;
 }
@@ -1112,8 +1149,8 @@ int Genome::processAlnWork(){
 
 	cout << "Begin sequence alignment ..." << endl;
 
-	hts_tpool *p = hts_tpool_init(paras->num_threads);
-	hts_tpool_process *q = hts_tpool_process_init(p, paras->num_threads*2, 1);
+	// align the contigs in batches first, and the works left unaligned are aligned separately
+	if(paras->minimap2_batch_size>1 and paras->minimap2_lib_flag==false) genomeMinimap2BatchAln();
 
 	pthread_mutex_init(&paras->mtx_call_workDone_num, NULL);
 
@@ -1122,6 +1159,7 @@ int Genome::processAlnWork(){
 	//num_work_percent = num_work / (paras->num_parts_progress >> 1);
 	num_work_percent = num_work / (paras->num_parts_progress / 10);
 	if(num_work_percent==0) num_work_percent = 1;
+
 	for(size_t i=0; i<num_work; i++){
 		var_cand = paras->call_work_vec.at(i);
 
@@ -1138,16 +1176,84 @@ int Genome::processAlnWork(){
 		call_work_opt->p_call_workDone_num = &(paras->call_workDone_num);
 		call_work_opt->p_mtx_call_workDone_num = &(paras->mtx_call_workDone_num);
 
-		hts_tpool_dispatch(p, q, processSingleMinimap2AlnWork, call_work_opt);
+		paras->thread_pool->dispatch(TASK_TYPE_ALN, processSingleMinimap2AlnWork, call_work_opt);
 	}
-
-    hts_tpool_process_flush(q);
-    hts_tpool_process_destroy(q);
-    hts_tpool_destroy(p);
+	paras->thread_pool->wait(TASK_TYPE_ALN);
 
 	return 0;
 }
 
+bool isMinimap2BatchItemLess(const minimap2BatchItem_t &item1, const minimap2BatchItem_t &item2){
+	return item1.start_pos<item2.start_pos;
+}
+
+// align the contigs of the call works on each chromosome by batches, the refseq regions in a batch
+// are not overlapped with each other to reduce the alignments across works, see minimap2AlnBatch()
+void Genome::genomeMinimap2BatchAln(){
+	map<string, vector<minimap2BatchItem_t>> chr_item_map;
+	map<string, vector<minimap2BatchItem_t>>::iterator chr_it;
+	vector<minimap2BatchItem_t> *item_vec;
+	minimap2BatchItem_t item;
+	vector<minimap2BatchAlnWork_opt*> open_batch_vec;
+	vector<int64_t> batch_end_pos_vec;
+	minimap2BatchAlnWork_opt *batch_work_opt;
+	set<string> aln_file_set;
+	varCand *var_cand;
+	string chrname, out_dir_batch;
+	size_t i, j, batch_id;
+
+	// collect the works to be aligned
+	for(i=0; i<paras->call_work_vec.size(); i++){
+		var_cand = paras->call_work_vec.at(i);
+		if(var_cand->cns_success==false or var_cand->getMinimap2AlnDoneFlag() or isFileExist(var_cand->alnfilename)) continue;
+		if(aln_file_set.find(var_cand->alnfilename)!=aln_file_set.end()) continue;
+		if(getRefseqRegion(var_cand->refseqfilename, chrname, item.start_pos, item.end_pos)==false) continue;
+		aln_file_set.insert(var_cand->alnfilename);
+		item.var_cand = var_cand;
+		chr_item_map[chrname].push_back(item);
+	}
+	if(chr_item_map.empty()) return;
+
+	cout << "Batched minimap2 alignment for " << aln_file_set.size() << " regions ..." << endl;
+
+	batch_id = 0;
+	for(chr_it=chr_item_map.begin(); chr_it!=chr_item_map.end(); chr_it++){
+		item_vec = &chr_it->second;
+		sort(item_vec->begin(), item_vec->end(), isMinimap2BatchItemLess);
+
+		// each region is put into the first batch ending before it
+		for(i=0; i<item_vec->size(); i++){
+			item = item_vec->at(i);
+			for(j=0; j<open_batch_vec.size(); j++) if(batch_end_pos_vec.at(j)<item.start_pos) break;
+			if(j==open_batch_vec.size()){
+				out_dir_batch = item.var_cand->alnfilename.substr(0, item.var_cand->alnfilename.find_last_of("/")+1);
+				batch_work_opt = new minimap2BatchAlnWork_opt();
+				batch_work_opt->batch_prefix = getScratchFilename(out_dir_batch + "minimap2_batch_" + to_string(batch_id++));
+				batch_work_opt->max_proc_running_minutes = paras->max_proc_running_minutes_call;
+				open_batch_vec.push_back(batch_work_opt);
+				batch_end_pos_vec.push_back(0);
+			}
+			open_batch_vec.at(j)->var_cand_vec.push_back(item.var_cand);
+			batch_end_pos_vec.at(j) = item.end_pos;
+
+			if((int32_t)open_batch_vec.at(j)->var_cand_vec.size()>=paras->minimap2_batch_size){ // full batch
+				paras->thread_pool->dispatch(TASK_TYPE_ALN, processMinimap2BatchAlnWork, open_batch_vec.at(j));
+				open_batch_vec.erase(open_batch_vec.begin()+j);
+				batch_end_pos_vec.erase(batch_end_pos_vec.begin()+j);
+			}
+		}
+
+		// single-work batches are left to be aligned separately
+		for(j=0; j<open_batch_vec.size(); j++){
+			if(open_batch_vec.at(j)->var_cand_vec.size()>1) paras->thread_pool->dispatch(TASK_TYPE_ALN, processMinimap2BatchAlnWork, open_batch_vec.at(j));
+			else delete open_batch_vec.at(j);
+		}
+		vector<minimap2BatchAlnWork_opt*>().swap(open_batch_vec);
+		vector<int64_t>().swap(batch_end_pos_vec);
+	}
+	paras->thread_pool->wait(TASK_TYPE_ALN);
+}
+
 // call variants using thread pool
 int Genome::processBlatAlnWork(){
 	callWork_opt *call_work_opt;
@@ -1158,9 +1264,6 @@ int Genome::processBlatAlnWork(){
 
 	cout << "Begin blat alignment ..." << endl;
 
-	hts_tpool *p = hts_tpool_init(paras->num_threads);
-	hts_tpool_process *q = hts_tpool_process_init(p, paras->num_threads*2, 1);
-
 	pthread_mutex_init(&paras->mtx_call_workDone_num, NULL);
 
 	paras->call_workDone_num = 0;
@@ -1183,12 +1286,9 @@ int Genome::processBlatAlnWork(){
 		call_work_opt->p_call_workDone_num = &(paras->call_workDone_num);
 		call_work_opt->p_mtx_call_workDone_num = &(paras->mtx_call_workDone_num);
 
-		hts_tpool_dispatch(p, q, processSingleBlatAlnWork, call_work_opt);
+		paras->thread_pool->dispatch(TASK_TYPE_ALN, processSingleBlatAlnWork, call_work_opt);
 	}
-
-    hts_tpool_process_flush(q);
-    hts_tpool_process_destroy(q);
-    hts_tpool_destroy(p);
+	paras->thread_pool->wait(TASK_TYPE_ALN);
 
 	return 0;
 }
@@ -1203,9 +1303,6 @@ int Genome::processCallWork(){
 
 	cout << "Begin variants call ..." << endl;
 
-	hts_tpool *p = hts_tpool_init(paras->num_threads);
-	hts_tpool_process *q = hts_tpool_process_init(p, paras->num_threads*2, 1);
-
 	pthread_mutex_init(&paras->mtx_call_workDone_num, NULL);
 
 	paras->call_workDone_num = 0;
@@ -1213,6 +1310,11 @@ int Genome::processCallWork(){
 	//num_work_percent = num_work / (paras->num_parts_progress >> 1); // deleted on 2024-09-04
 	num_work_percent = num_work / (paras->num_parts_progress / 10);
 	if(num_work_percent==0) num_work_percent = 1;
+
+	// the rescue consensus jobs of callVariants02() share the CPU budget with the call workers,
+	// and each finished call work is counted in processSingleCallWork()
+	initCpuTokens(paras->num_threads, paras->num_threads, num_work, paras->num_threads_per_cns_work);
+
 	for(size_t i=0; i<num_work; i++){
 		var_cand = paras->call_work_vec.at(i);
 
@@ -1236,12 +1338,9 @@ int Genome::processCallWork(){
 		call_work_opt->p_call_workDone_num = &(paras->call_workDone_num);
 		call_work_opt->p_mtx_call_workDone_num = &(paras->mtx_call_workDone_num);
 
-		hts_tpool_dispatch(p, q, processSingleCallWork, call_work_opt);
+		paras->thread_pool->dispatch(TASK_TYPE_CALL, processSingleCallWork, call_work_opt);
 	}
-
-    hts_tpool_process_flush(q);
-    hts_tpool_process_destroy(q);
-    hts_tpool_destroy(p);
+	paras->thread_pool->wait(TASK_TYPE_CALL);
 
 	return 0;
 }
@@ -1746,23 +1845,9 @@ void Genome::blatAlnTra_st(vector<blatAlnTra*> *blat_aln_tra_vec){
 }
 
 void Genome::blatAlnTra_mt(vector<blatAlnTra*> *blat_aln_tra_vec){
-	int32_t i;
-	MultiThread mt[paras->num_threads];
-	for(i=0; i<paras->num_threads; i++){
-		mt[i].setNumThreads(paras->num_threads);
-		mt[i].setBlatAlnTraVec(blat_aln_tra_vec);
-		mt[i].setUserThreadID(i);
-		if(!mt[i].startBlatAlnTra()){
-			cerr << __func__ << ", line=" << __LINE__ << ": unable to create thread, error!" << endl;
-			exit(1);
-		}
-	}
-	for(i=0; i<paras->num_threads; i++){
-		if(!mt[i].join()){
-			cerr << __func__ << ", line=" << __LINE__ << ": unable to join, error!" << endl;
-			exit(1);
-		}
-	}
+	for(size_t i=0; i<blat_aln_tra_vec->size(); i++)
+		paras->thread_pool->dispatch(TASK_TYPE_BLAT_TRA, processSingleBlatAlnTraWork, blat_aln_tra_vec->at(i));
+	paras->thread_pool->wait(TASK_TYPE_BLAT_TRA);
 }
 
 varCand* Genome::constructNewVarCand(varCand *var_cand, varCand *var_cand_tmp){
@@ -1821,6 +1906,7 @@ varCand* Genome::constructNewVarCand(varCand *var_cand, varCand *var_cand_tmp){
 
 		// process monitor killed blat work
 		var_cand_tmp->max_proc_running_minutes = paras->max_proc_running_minutes_call;
+		var_cand_tmp->minimap2_lib_flag = paras->minimap2_lib_flag;
 		var_cand_tmp->killed_blat_work_vec = &paras->killed_blat_work_vec;
 		var_cand_tmp->killed_blat_work_file = &paras->killed_blat_work_file;
 		var_cand_tmp->mtx_killed_blat_work = &paras->mtx_killed_blat_work;
@@ -2773,11 +2859,13 @@ void Genome::genomeFillVarseq(){
 }
 
 void Genome::genomeFillVarseqTra(){
-	size_t i, j;
+	size_t i, j, k;
 	Chrome *chr;
 	mateClipReg_t *clip_reg;
 	ofstream cns_info_file;
 	string cns_info_filename_tra;
+	fillVarseqTraWork_opt *fill_work_opt;
+	vector<fillVarseqTraWork_opt*> fill_work_vec;
 
 	cns_info_filename_tra = out_dir_tra + "/" + "tra_cns_info";
 	cns_info_file.open(cns_info_filename_tra);
@@ -2786,18 +2874,36 @@ void Genome::genomeFillVarseqTra(){
 		exit(1);
 	}
 
+	// each translocation is filled by a task, and its consensus information is collected in the work
 	for(i=0; i<chromeVector.size(); i++){
 		chr = chromeVector.at(i);
 		for(j=0; j<chr->mateClipRegVector.size(); j++){
 			clip_reg = chr->mateClipRegVector.at(j);
-			if(clip_reg->valid_flag and (clip_reg->call_success_flag or clip_reg->tra_rescue_success_flag) and clip_reg->sv_type==VAR_TRA)
-				fillVarseqSingleMateClipReg(clip_reg, cns_info_file);
+			if(clip_reg->valid_flag and (clip_reg->call_success_flag or clip_reg->tra_rescue_success_flag) and clip_reg->sv_type==VAR_TRA){
+				fill_work_opt = new fillVarseqTraWork_opt();
+				fill_work_opt->clip_reg = clip_reg;
+				fill_work_opt->genome = this;
+				fill_work_vec.push_back(fill_work_opt);
+			}
 		}
 	}
+
+	for(i=0; i<fill_work_vec.size(); i++)
+		paras->thread_pool->dispatch(TASK_TYPE_FILL_VARSEQ_TRA, processSingleFillVarseqTraWork, fill_work_vec.at(i));
+	paras->thread_pool->wait(TASK_TYPE_FILL_VARSEQ_TRA);
+
+	// write the consensus information in the original order
+	for(i=0; i<fill_work_vec.size(); i++){
+		fill_work_opt = fill_work_vec.at(i);
+		for(k=0; k<fill_work_opt->cns_info_vec.size(); k++) cns_info_file << fill_work_opt->cns_info_vec.at(k) << endl;
+		delete fill_work_opt;
+	}
+	vector<fillVarseqTraWork_opt*>().swap(fill_work_vec);
+
 	cns_info_file.close();
 }
 
-void Genome::fillVarseqSingleMateClipReg(mateClipReg_t *clip_reg, ofstream &cns_info_file){
+void Genome::fillVarseqSingleMateClipReg(mateClipReg_t *clip_reg, vector<string> &cns_info_vec){
 	varCand *var_cand_tmp;
 	string tmpdir;
 	reg_t *reg;
@@ -2877,6 +2983,7 @@ void Genome::fillVarseqSingleMateClipReg(mateClipReg_t *clip_reg, ofstream &cns_
 
 				// process monitor killed blat work
 				var_cand_tmp->max_proc_running_minutes = paras->max_proc_running_minutes_call;
+				var_cand_tmp->minimap2_lib_flag = paras->minimap2_lib_flag;
 				var_cand_tmp->killed_blat_work_vec = &paras->killed_blat_work_vec;
 				var_cand_tmp->killed_blat_work_file = &paras->killed_blat_work_file;
 				var_cand_tmp->mtx_killed_blat_work = &paras->mtx_killed_blat_work;
@@ -2890,7 +2997,7 @@ void Genome::fillVarseqSingleMateClipReg(mateClipReg_t *clip_reg, ofstream &cns_
 				for(i=0; i<3; i++){
 					cns_extend_size = paras->cnsSideExtSizeClip * i;
 					// local consensus
-					performLocalCnsTra(var_cand_tmp->readsfilename, var_cand_tmp->ctgfilename, var_cand_tmp->refseqfilename, var_cand_tmp->clusterfilename, tmpdir, paras->technology, paras->min_identity_match, reg->endRefPos-reg->startRefPos+1, paras->num_threads_per_cns_work, var_cand_tmp->varVec, reg->chrname, paras->inBamFile, fai, cns_extend_size, cns_info_file);
+					performLocalCnsTra(var_cand_tmp->readsfilename, var_cand_tmp->ctgfilename, var_cand_tmp->refseqfilename, var_cand_tmp->clusterfilename, tmpdir, paras->technology, paras->min_identity_match, reg->endRefPos-reg->startRefPos+1, paras->num_threads_per_cns_work, var_cand_tmp->varVec, reg->chrname, paras->inBamFile, fai, cns_extend_size, cns_info_vec);
 
 					ref_shift_size_vec = getRefShiftSize(var_cand_tmp->refseqfilename);
 					var_cand_tmp->ref_left_shift_size = ref_shift_size_vec.at(0);
@@ -3001,6 +3108,7 @@ void Genome::fillVarseqSingleMateClipReg(mateClipReg_t *clip_reg, ofstream &cns_
 
 				// process monitor killed blat work
 				var_cand_tmp->max_proc_running_minutes = paras->max_proc_running_minutes_call;
+				var_cand_tmp->minimap2_lib_flag = paras->minimap2_lib_flag;
 				var_cand_tmp->killed_blat_work_vec = &paras->killed_blat_work_vec;
 				var_cand_tmp->killed_blat_work_file = &paras->killed_blat_work_file;
 				var_cand_tmp->mtx_killed_blat_work = &paras->mtx_killed_blat_work;
@@ -3017,7 +3125,7 @@ void Genome::fillVarseqSingleMateClipReg(mateClipReg_t *clip_reg, ofstream &cns_
 				for(i=0; i<3; i++){
 					cns_extend_size = paras->cnsSideExtSizeClip * i;
 					// local consensus
-					performLocalCnsTra(var_cand_tmp->readsfilename, var_cand_tmp->ctgfilename, var_cand_tmp->refseqfilename, var_cand_tmp->clusterfilename, tmpdir, paras->technology, paras->min_identity_match, reg->endRefPos-reg->startRefPos+1, paras->num_threads_per_cns_work, var_cand_tmp->varVec, reg->chrname, paras->inBamFile, fai, cns_extend_size, cns_info_file);
+					performLocalCnsTra(var_cand_tmp->readsfilename, var_cand_tmp->ctgfilename, var_cand_tmp->refseqfilename, var_cand_tmp->clusterfilename, tmpdir, paras->technology, paras->min_identity_match, reg->endRefPos-reg->startRefPos+1, paras->num_threads_per_cns_work, var_cand_tmp->varVec, reg->chrname, paras->inBamFile, fai, cns_extend_size, cns_info_vec);
 
 					ref_shift_size_vec = getRefShiftSize(var_cand_tmp->refseqfilename);
 					var_cand_tmp->ref_left_shift_size = ref_shift_size_vec.at(0);
@@ -3065,9 +3173,9 @@ void Genome::fillVarseqSingleMateClipReg(mateClipReg_t *clip_reg, ofstream &cns_
 }
 
 // perform local consensus
-void Genome::performLocalCnsTra(string &readsfilename, string &contigfilename, string &refseqfilename, string &clusterfilename, string &tmpdir, string &technology, double min_identity_match, int32_t sv_len_est, size_t num_threads_per_cns_work, vector<reg_t*> &varVec, string &chrname, string &inBamFile, faidx_t *fai, size_t cns_extend_size, ofstream &cns_info_file){
+void Genome::performLocalCnsTra(string &readsfilename, string &contigfilename, string &refseqfilename, string &clusterfilename, string &tmpdir, string &technology, double min_identity_match, int32_t sv_len_est, size_t num_threads_per_cns_work, vector<reg_t*> &varVec, string &chrname, string &inBamFile, faidx_t *fai, size_t cns_extend_size, vector<string> &cns_info_vec){
 
-	localCns local_cns(readsfilename, contigfilename, refseqfilename, clusterfilename, tmpdir, technology, min_identity_match, sv_len_est, num_threads_per_cns_work, varVec, chrname, inBamFile, fai, cns_extend_size, paras->expected_cov_cns, paras->min_input_cov_canu, paras->max_ultra_high_cov, paras->minMapQ, paras->minHighMapQ, paras->delete_reads_flag, paras->keep_failed_reads_flag, true, paras->minClipEndSize, paras->minConReadLen, paras->min_sv_size_usr, paras->minReadsNumSupportSV, paras->max_seg_size_ratio_usr);
+	localCns local_cns(readsfilename, contigfilename, refseqfilename, clusterfilename, tmpdir, technology, min_identity_match, sv_len_est, num_threads_per_cns_work, varVec, chrname, inBamFile, fai, cns_extend_size, paras->expected_cov_cns, paras->min_input_cov_canu, paras->max_ultra_high_cov, paras->minMapQ, paras->minHighMapQ, paras->delete_reads_flag, paras->keep_failed_reads_flag, true, paras->minClipEndSize, paras->minConReadLen, paras->min_sv_size_usr, paras->minReadsNumSupportSV, paras->max_seg_size_ratio_usr, paras->max_proc_running_minutes_cns);
 
 	// extract the corresponding refseq from reference
 	local_cns.extractRefseq();
@@ -3080,12 +3188,19 @@ void Genome::performLocalCnsTra(string &readsfilename, string &contigfilename, s
 	local_cns.cnsByPoa();
 
 	// record consensus information
-	local_cns.recordCnsInfo(cns_info_file);
+	cns_info_vec.push_back(local_cns.getCnsInfoLine());
 
 	// empty the varVec
 	//varVec.clear();
 }
 
+// process single work of filling translocation variant sequences
+void* processSingleFillVarseqTraWork(void *arg){
+	fillVarseqTraWork_opt *fill_work_opt = (fillVarseqTraWork_opt *)arg;
+	fill_work_opt->genome->fillVarseqSingleMateClipReg(fill_work_opt->clip_reg, fill_work_opt->cns_info_vec);
+	return NULL;
+}
+
 vector<int32_t> Genome::getRefShiftSize(string &refseqfilename){
 	ifstream infile;
 	string header_str;
@@ -3725,6 +3840,7 @@ void Genome::computeVarNumStatCons(){
 	vector<int32_t> num_vec;
 	Chrome *chr;
 	string filename;
+	cnsCacheStat_t cns_cache_stat;
 
 	total_indel = total_clipReg = total_succ_indel = total_fail_indel = total_succ_clipReg = total_fail_clipReg = 0;
 	for(size_t i=0; i<chromeVector.size(); i++){
@@ -3752,6 +3868,10 @@ void Genome::computeVarNumStatCons(){
 	cout << "There are " << total << " regions in total:" << endl;
 	cout << "\t" << total_indel << " indel regions: " << total_succ_indel << " successful, " << total_fail_indel << " failed" << endl;
 	cout << "\t" << total_clipReg << " clipping regions: " << total_succ_clipReg << " successful, " << total_fail_clipReg << " failed" << endl;
+
+	cns_cache_stat = getCnsCacheStat();
+	if(cns_cache_stat.lookup_num>0)
+		cout << "Consensus cache: " << cns_cache_stat.hit_num << " hits in " << cns_cache_stat.lookup_num << " lookups (" << (double)cns_cache_stat.hit_num / cns_cache_stat.lookup_num * 100 << "%)" << endl;
 }
 
 vector<int32_t> Genome::getSuccFailNumCns(string &filename){
@@ -3881,7 +4001,7 @@ void Genome::sortVarResults(string &infilename, int32_t filetype){
 
 	subsets = constructSubsetByChr(sv_vec);
 	sortSVitem(subsets);
-	rmDupSVitem(subsets, paras->gt_size_ratio_match, paras->gt_min_identity_merge); // remove identical items
+	rmDupSVitem(subsets, paras->gt_size_ratio_match, paras->gt_min_identity_merge, paras->thread_pool, sv_identity_cache); // remove identical items
 	outputResult(outfilename, subsets, filetype);
 
 	remove(infilename.c_str());
@@ -3921,3 +4041,21 @@ void Genome::outputResult(string &outfilename, vector<vector<SV_item*>> &subsets
 	}
 	outfile.close();
 }
+
+// process the batched minimap2 alignment work
+void* processMinimap2BatchAlnWork(void *arg){
+	minimap2BatchAlnWork_opt *batch_work_opt = (minimap2BatchAlnWork_opt *)arg;
+	vector<string> alnfilename_vec, ctgfilename_vec, refseqfilename_vec;
+	varCand *var_cand;
+
+	for(size_t i=0; i<batch_work_opt->var_cand_vec.size(); i++){
+		var_cand = batch_work_opt->var_cand_vec.at(i);
+		alnfilename_vec.push_back(var_cand->alnfilename);
+		ctgfilename_vec.push_back(var_cand->ctgfilename);
+		refseqfilename_vec.push_back(var_cand->refseqfilename);
+	}
+	minimap2AlnBatch(alnfilename_vec, ctgfilename_vec, refseqfilename_vec, batch_work_opt->batch_prefix, batch_work_opt->max_proc_running_minutes);
+
+	delete batch_work_opt;
+	return NULL;
+}
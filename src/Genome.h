@@ -39,6 +39,8 @@ class Genome{
 		string blat_aln_info_filename_tra;
 		vector<varCand*> blat_aligned_tra_varCand_vec;
 
+		svIdentityCache_t sv_identity_cache;	// identities of the duplicated item pairs, shared by the BED and VCF results
+
 	public:
 		Genome(Paras *paras);
 		virtual ~Genome();
@@ -49,6 +51,7 @@ class Genome{
 		int genomeCall();
 		void estimateSVSizeNum();
 		void saveResultVCF();
+		void fillVarseqSingleMateClipReg(mateClipReg_t *clip_reg, vector<string> &cns_info_vec);
 
 	private:
 		void init();
@@ -64,6 +67,7 @@ class Genome{
 		void removeRedundantMateClipReg();
 		void genomeRemoveRedundantClipReg(Chrome *chr, vector<Chrome*> &chr_vec);
 		void removeOverlappedIndelFromMateClipReg();
+		void extractFastPathIndels();
 		void genomeRemoveFPIndelSnvInClipReg(Chrome *chr, vector<Chrome*> &chr_vec);
 		mateClipReg_t* genomeGetOverlappedMateClipReg(mateClipReg_t *clip_reg_given, vector<Chrome*> &chrome_vec);
 		mateClipReg_t* getSameClipRegTRA(mateClipReg_t *clip_reg_given, vector<Chrome*> &chrome_vec);
@@ -81,6 +85,7 @@ class Genome{
 		void genomeCollectCallWork();
 		void genomeFinishCallWork();
 		int processAlnWork();
+		void genomeMinimap2BatchAln();
 		int processBlatAlnWork();
 		int processCallWork();
 		void genomeLoadMateClipRegData();
@@ -107,8 +112,7 @@ class Genome{
 		vector<int32_t> computeDistsTra(mateClipReg_t *clip_reg1, mateClipReg_t *clip_reg2);
 		void genomeFillVarseq();
 		void genomeFillVarseqTra();
-		void fillVarseqSingleMateClipReg(mateClipReg_t *clip_reg, ofstream &cns_info_file);
-		void performLocalCnsTra(string &readsfilename, string &contigfilename, string &refseqfilename, string &clusterfilename, string &tmpdir, string &technology, double min_identity_match, int32_t sv_len_est, size_t num_threads_per_cns_work, vector<reg_t*> &varVec, string &chrname, string &inBamFile, faidx_t *fai, size_t cns_extend_size, ofstream &cns_info_file);
+		void performLocalCnsTra(string &readsfilename, string &contigfilename, string &refseqfilename, string &clusterfilename, string &tmpdir, string &technology, double min_identity_match, int32_t sv_len_est, size_t num_threads_per_cns_work, vector<reg_t*> &varVec, string &chrname, string &inBamFile, faidx_t *fai, size_t cns_extend_size, vector<string> &cns_info_vec);
 		vector<int32_t> getRefShiftSize(string &refseqfilename);
 		vector<size_t> computeQueryLocTra(varCand *var_cand, mateClipReg_t *clip_reg, size_t end_flag);
 		void genomeSaveCallSV2File();
@@ -131,5 +135,28 @@ class Genome{
 		void outputResult(string &outfilename, vector<vector<SV_item*>> &subsets, int32_t filetype);
 };
 
+// work option of filling the variant sequences of single translocation,
+// the consensus information lines are kept in the work and written in the original order
+typedef struct{
+	mateClipReg_t *clip_reg;
+	Genome *genome;
+	vector<string> cns_info_vec;
+}fillVarseqTraWork_opt;
+
+void* processSingleFillVarseqTraWork(void *arg);
+
+// batched minimap2 alignment work of the call works on a chromosome
+typedef struct{
+	vector<varCand*> var_cand_vec;
+	string batch_prefix;	// prefix of the batch refseq, contig and alignment files
+	int32_t max_proc_running_minutes;
+}minimap2BatchAlnWork_opt;
+
+typedef struct{
+	varCand *var_cand;
+	int64_t start_pos, end_pos;	// refseq region
+}minimap2BatchItem_t;
+
+void* processMinimap2BatchAlnWork(void *arg);
 
 #endif /* SRC_GENOME_H_ */
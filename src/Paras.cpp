@@ -37,6 +37,13 @@ void Paras::init(){
 	sample = SAMPLE_DEFAULT;
 	pg_cmd_str = "";
 	num_threads = 0;
+	thread_pool = NULL;
+	numa_flag = false;
+	fast_path_flag = false;
+	minimap2_lib_flag = false;
+	minimap2_batch_size = MINIMAP2_BATCH_SIZE_DEFAULT;
+	scratch_dir = getDefaultScratchDir();
+	cns_cache_dir = "";
 	delete_reads_flag = true;
 	keep_failed_reads_flag = recns_failed_work_flag = false;
 	maskMisAlnRegFlag = false;
@@ -72,29 +79,31 @@ void Paras::init(){
 	max_ultra_high_cov = MAX_ULTRA_HIGH_COV_THRES;
 
 	cns_reg_preDone_num = cns_reg_work_total = cns_reg_workDone_num = 0;
+	detect_indel_num = fast_path_indel_num = 0;
 	num_parts_progress = NUM_PARTS_PROGRESS;
 	num_threads_per_cns_work = NUM_THREADS_PER_CNS_WORK;
 
-	wtdbg2_version = getProgramVersion("wtdbg2 -V | awk '$1 ~/(wtdbg)|(wtdbg2)/' | awk '{print $2}'");
+	wtdbg2_version = getProgramVersion("wtdbg2", "-V", "wtdbg", 1);
 	if(wtdbg2_version.empty()){
 		cerr << "Cannot find the 'wtdbg2', please make sure it is correctly installed and the executable file 'wtdbg2.pl' or its soft link is included in the '$PATH' directory." << endl;
 		exit(1);
 	}
-	minimap2_version = getProgramVersion("minimap2 -V | awk '{print $1}'");
+	minimap2_version = getProgramVersion("minimap2", "-V", "", 0);
 	if(minimap2_version.empty()){
 		cerr << "Cannot find the 'minimap2', please make sure it is correctly installed and the executable file 'minimap2' or its soft link is included in the '$PATH' directory." << endl;
 		exit(1);
 	}
-	abpoa_version = getProgramVersion("abpoa -v | awk '{print $1}'");
+	abpoa_version = getProgramVersion("abpoa", "-v", "", 0);
 	if(minimap2_version.empty()){
 		cerr << "Cannot find the 'abpoa', please make sure it is correctly installed and the executable file 'abpoa' or its soft link is included in the '$PATH' directory." << endl;
 		exit(1);
 	}
 
 	//monitoring_proc_names_cns = DEFAULT_MONITOR_PROC_NAMES_CNS;
-	//max_proc_running_minutes_cns = MAX_PROC_RUNNING_MINUTES_CNS;
+	max_proc_running_minutes_cns = MAX_PROC_RUNNING_MINUTES_CNS;
 	//monitoring_proc_names_call = DEFAULT_MONITOR_PROC_NAMES_CALL;
-	//max_proc_running_minutes_call = MAX_PROC_RUNNING_MINUTES_CALL;
+	max_proc_running_minutes_call = MAX_PROC_RUNNING_MINUTES_CALL;
+	max_proc_mem_gb = MAX_PROC_MEM_GB_DEFAULT;
 
 	mem_total = getMemInfo("MemTotal", 2);
 	swap_total = getMemInfo("SwapTotal", 2);
@@ -112,20 +121,28 @@ void Paras::init(){
 	gt_hete_ratio = GT_HETE_RATIO_THRES;
 }
 
-// get the program version
-string Paras::getProgramVersion(const string &cmd_str){
-	FILE *stream;
-	char tmp[256], info[256] = {0};
-	string pg_version_str = "";
-
-	sprintf(tmp, "%s", cmd_str.c_str());
-	stream = popen(tmp, "r");
-	if(fread(info, 1, sizeof(tmp), stream)>0){
-		pg_version_str = info;
-		if(pg_version_str.at(pg_version_str.size()-1)=='\n') pg_version_str.at(pg_version_str.size()-1) = '\0';
-		if(pg_version_str.at(pg_version_str.size()-1)=='\0') pg_version_str.erase(pg_version_str.begin()+pg_version_str.size()-1);
+// get the program version: the given field of the first output line whose first field contains 'name_pattern'
+string Paras::getProgramVersion(const string &prog_name, const string &version_opt, const string &name_pattern, size_t field_id){
+	vector<string> argv_vec, line_vec, field_vec;
+	procOpt_t proc_opt;
+	procResult_t proc_result;
+	string pg_version_str = "", line;
+
+	argv_vec = {prog_name, version_opt};
+	initProcOpt(proc_opt);
+	proc_opt.capture_out_flag = true;
+	runProcess(argv_vec, proc_opt, proc_result);
+
+	line_vec = split(proc_result.out_str, "\n");
+	for(size_t i=0; i<line_vec.size(); i++){
+		line = line_vec.at(i);
+		replace(line.begin(), line.end(), '\t', ' ');
+		field_vec = split(line, " ");
+		if(field_vec.size()>field_id and field_vec.at(0).find(name_pattern)!=string::npos){
+			pg_version_str = field_vec.at(field_id);
+			break;
+		}
 	}
-	pclose(stream);
 
 	return pg_version_str;
 }
@@ -297,6 +314,8 @@ int Paras::parseDetectParas(int argc, char **argv){
 		//{ "mask-noisy-region", no_argument, NULL, 0 },
 		{ "include-alt", no_argument, NULL, 0 },
 		{ "include-decoy", no_argument, NULL, 0 },
+		{ "numa", no_argument, NULL, 0 },
+		{ "fast-path", no_argument, NULL, 0 },
 		{ "version", no_argument, NULL, 'v' },
 		{ "help", no_argument, NULL, 'h' },
 		{ NULL, 0, NULL, 0 }
@@ -424,7 +443,8 @@ int Paras::parseCnsParas(int argc, char **argv){
 		{ "re-cns-failed-work", no_argument, NULL, 0 },
 		//{ "min-cov-cns", required_argument, NULL, 0 },
 		//{ "monitor-proc-names-cns", required_argument, NULL, 0 },
-		//{ "max_proc_running_minutes_cns", required_argument, NULL, 0 },
+		{ "max-proc-running-minutes-cns", required_argument, NULL, 0 },
+		{ "max-proc-mem", required_argument, NULL, 0 },
 		//{ "technology", required_argument, NULL, 0 },
 		{ "include-alt", no_argument, NULL, 0 },
 		{ "include-decoy", no_argument, NULL, 0 },
@@ -545,7 +565,8 @@ int Paras::parseCallParas(int argc, char **argv){
 //		{ "out", required_argument, NULL, 'o' },
 //		{ "log", required_argument, NULL, 'l' },
 		//{ "monitor-proc-names-call", required_argument, NULL, 0 },
-		//{ "max_proc_running_minutes_call", required_argument, NULL, 0 },
+		{ "max-proc-running-minutes-call", required_argument, NULL, 0 },
+		{ "max-proc-mem", required_argument, NULL, 0 },
 		{ "sample", required_argument, NULL, 0 },
 		{ "include-alt", no_argument, NULL, 0 },
 		{ "include-decoy", no_argument, NULL, 0 },
@@ -554,6 +575,10 @@ int Paras::parseCallParas(int argc, char **argv){
 		{ "gt-min-consist-merge", required_argument, NULL, 0 },
 		{ "gt-homo-ratio", required_argument, NULL, 0 },
 		{ "gt-hete-ratio", required_argument, NULL, 0 },
+		{ "minimap2-lib", no_argument, NULL, 0 },
+		{ "minimap2-batch", required_argument, NULL, 0 },
+		{ "scratch-dir", required_argument, NULL, 0 },
+		{ "cns-cache-dir", required_argument, NULL, 0 },
 		{ "version", no_argument, NULL, 'v' },
 		{ "help", no_argument, NULL, 'h' },
 		{ NULL, 0, NULL, 0 }
@@ -678,16 +703,23 @@ int Paras::parseAllParas(int argc, char **argv, const string &cmd_str){
 		//{ "mask-noisy-region", required_argument, NULL, 0 },
 		//{ "monitor-proc-names-cns", required_argument, NULL, 0 },
 		//{ "monitor_proc_names_call", required_argument, NULL, 0 },
-		//{ "max_proc_running_minutes_cns", required_argument, NULL, 0 },
-		//{ "max_proc_running_minutes_call", required_argument, NULL, 0 },
+		{ "max-proc-running-minutes-cns", required_argument, NULL, 0 },
+		{ "max-proc-running-minutes-call", required_argument, NULL, 0 },
+		{ "max-proc-mem", required_argument, NULL, 0 },
 		//{ "technology", required_argument, NULL, 0 },
 		{ "include-alt", no_argument, NULL, 0 },
 		{ "include-decoy", no_argument, NULL, 0 },
+		{ "numa", no_argument, NULL, 0 },
+		{ "fast-path", no_argument, NULL, 0 },
 		{ "gt-min-sig-size", required_argument, NULL, 0 },
 		{ "gt-size-ratio-match", required_argument, NULL, 0 },
 		{ "gt-min-consist-merge", required_argument, NULL, 0 },
 		{ "gt-homo-ratio", required_argument, NULL, 0 },
 		{ "gt-hete-ratio", required_argument, NULL, 0 },
+		{ "minimap2-lib", no_argument, NULL, 0 },
+		{ "minimap2-batch", required_argument, NULL, 0 },
+		{ "scratch-dir", required_argument, NULL, 0 },
+		{ "cns-cache-dir", required_argument, NULL, 0 },
 		{ "version", no_argument, NULL, 'v' },
 		{ "help", no_argument, NULL, 'h' },
 		{ NULL, 0, NULL, 0 }
@@ -867,6 +899,10 @@ void Paras::showDetectUsage(){
 	cout << "                 include alt chromosomal items in result [False]" << endl;
 	cout << "   --include-decoy" << endl;
 	cout << "                 include decoy chromosomal items in result [False]" << endl;
+	cout << "   --numa        pin worker threads to NUMA nodes and keep neighbouring" << endl;
+	cout << "                 blocks on one node (requires libnuma) [False]" << endl;
+	cout << "   --fast-path   call the simple indels with tightly agreeing signatures" << endl;
+	cout << "                 directly from the reads, without local consensus [False]" << endl;
 	cout << "   --sample STR  Sample name [\"" << SAMPLE_DEFAULT << "\"]" << endl;
 
 	cout << "   -v,--version  show version information" << endl;
@@ -942,9 +978,12 @@ void Paras::showCnsUsage(){
 //	cout << "                 should be terminated in advance if they are computation intensive works." << endl;
 //	cout << "                 Note that the process names should be comma-delimited and without blanks:" << endl;
 //	cout << "                 [\"" << DEFAULT_MONITOR_PROC_NAMES_CNS << "\"]" << endl;
-//	cout << "   --max_proc_running_minutes_cns INT" << endl;
-//	cout << "                 Monitored processes for consensus will be terminated if their CPU running" << endl;
-//	cout << "                 time exceed INT minutes: [" << MAX_PROC_RUNNING_MINUTES_CNS << "]" << endl;
+	cout << "   --max-proc-running-minutes-cns INT" << endl;
+	cout << "                 Consensus processes will be terminated if their running time" << endl;
+	cout << "                 exceed INT minutes, 0 for no limit: [" << MAX_PROC_RUNNING_MINUTES_CNS << "]" << endl;
+	cout << "   --max-proc-mem INT" << endl;
+	cout << "                 memory limit of each external consensus and alignment process" << endl;
+	cout << "                 in GB, 0 for no limit [" << MAX_PROC_MEM_GB_DEFAULT << "]" << endl;
 //	cout << "   --technology STR" << endl;
 //	cout << "                 Sequencing technology [pacbio]:" << endl;
 //	cout << "                   pacbio     : the PacBio CLR sequencing technology;" << endl;
@@ -1002,9 +1041,12 @@ void Paras::showCallUsage(){
 //	cout << "                 should be terminated in advance if they are computation intensive works." << endl;
 //	cout << "                 Note that the process names should be comma-delimited and without blanks:" << endl;
 //	cout << "                 [\"" << DEFAULT_MONITOR_PROC_NAMES_CALL << "\"]" << endl;
-//	cout << "   --max_proc_running_minutes_call INT" << endl;
-//	cout << "                 Monitored processes for call will be terminated if their CPU running time" << endl;
-//	cout << "                 exceed INT minutes: [" << MAX_PROC_RUNNING_MINUTES_CALL << "]" << endl;
+	cout << "   --max-proc-running-minutes-call INT" << endl;
+	cout << "                 Alignment and rescue consensus processes for call will be terminated" << endl;
+	cout << "                 if their running time exceed INT minutes, 0 for no limit: [" << MAX_PROC_RUNNING_MINUTES_CALL << "]" << endl;
+	cout << "   --max-proc-mem INT" << endl;
+	cout << "                 memory limit of each external consensus and alignment process" << endl;
+	cout << "                 in GB, 0 for no limit [" << MAX_PROC_MEM_GB_DEFAULT << "]" << endl;
 	cout << "   --include-alt" << endl;
 	cout << "                 include alt chromosomal items in result [False]" << endl;
 	cout << "   --include-decoy" << endl;
@@ -1026,6 +1068,20 @@ void Paras::showCallUsage(){
 	cout << "   --gt_hete_ratio FLOAT" << endl;
 	cout << "                 minimal allele ratio threshold for heterozygous alleles [" << GT_HETE_RATIO_THRES << "]." << endl;
 	cout << "                 Variant is heterozygous if the ratio of allele count is larger than FLOAT." << endl;
+	cout << "   --minimap2-lib" << endl;
+	cout << "                 align the consensus sequences by the minimap2 library in" << endl;
+	cout << "                 process instead of the 'minimap2' executable [False]" << endl;
+	cout << "   --minimap2-batch INT" << endl;
+	cout << "                 number of call works on a chromosome aligned by a single" << endl;
+	cout << "                 'minimap2' process, e.g. 200; 0 for no batch [" << MINIMAP2_BATCH_SIZE_DEFAULT << "]" << endl;
+	cout << "                 The alignments may slightly differ from those of separate" << endl;
+	cout << "                 processes, as the works in a batch share one index" << endl;
+	cout << "   --scratch-dir DIR" << endl;
+	cout << "                 directory of the transient consensus and alignment files," << endl;
+	cout << "                 'none' for the output directory [$TMPDIR or /dev/shm]" << endl;
+	cout << "   --cns-cache-dir DIR" << endl;
+	cout << "                 directory of the consensus cache shared by reruns, the" << endl;
+	cout << "                 consensus of identical reads is reused from it [none]" << endl;
 
 	cout << "   -v,--version  show version information" << endl;
 	cout << "   -h,--help     show this help message and exit" << endl << endl;
@@ -1116,15 +1172,18 @@ void Paras::showAllUsage(const string &cmd_str){
 //		cout << "                 [\"" << DEFAULT_MONITOR_PROC_NAMES_CALL << "\"]" << endl;
 //	}
 
-//	cout << "   --max_proc_running_minutes_cns INT" << endl;
-//	cout << "                 Monitored processes for consensus will be terminated if their CPU running" << endl;
-//	cout << "                 time exceed INT minutes: [" << MAX_PROC_RUNNING_MINUTES_CNS << "]" << endl;
-//
-//	if(cmd_str.compare(CMD_ALL_STR)==0){
-//		cout << "   --max_proc_running_minutes_call INT" << endl;
-//		cout << "                 Monitored processes for call will be terminated if their CPU running time" << endl;
-//		cout << "                 exceed INT minutes: [" << MAX_PROC_RUNNING_MINUTES_CALL << "]" << endl;
-//	}
+	cout << "   --max-proc-running-minutes-cns INT" << endl;
+	cout << "                 Consensus processes will be terminated if their running time" << endl;
+	cout << "                 exceed INT minutes, 0 for no limit: [" << MAX_PROC_RUNNING_MINUTES_CNS << "]" << endl;
+
+	if(cmd_str.compare(CMD_ALL_STR)==0){
+		cout << "   --max-proc-running-minutes-call INT" << endl;
+		cout << "                 Alignment and rescue consensus processes for call will be terminated" << endl;
+		cout << "                 if their running time exceed INT minutes, 0 for no limit: [" << MAX_PROC_RUNNING_MINUTES_CALL << "]" << endl;
+	}
+	cout << "   --max-proc-mem INT" << endl;
+	cout << "                 memory limit of each external consensus and alignment process" << endl;
+	cout << "                 in GB, 0 for no limit [" << MAX_PROC_MEM_GB_DEFAULT << "]" << endl;
 
 //	cout << "   --technology STR" << endl;
 //	cout << "                 Sequencing technology [pacbio]:" << endl;
@@ -1135,6 +1194,10 @@ void Paras::showAllUsage(const string &cmd_str){
 	cout << "                 include alt chromosomal items in result [False]" << endl;
 	cout << "   --include-decoy" << endl;
 	cout << "                 include decoy chromosomal items in result [False]" << endl;
+	cout << "   --numa        pin worker threads to NUMA nodes and keep neighbouring" << endl;
+	cout << "                 blocks on one node (requires libnuma) [False]" << endl;
+	cout << "   --fast-path   call the simple indels with tightly agreeing signatures" << endl;
+	cout << "                 directly from the reads, without local consensus [False]" << endl;
 	cout << "   --sample STR  Sample name [\"" << SAMPLE_DEFAULT << "\"]" << endl;
 
 if(cmd_str.compare(CMD_CALL_STR)==0 or cmd_str.compare(CMD_ALL_STR)==0){
@@ -1153,6 +1216,20 @@ if(cmd_str.compare(CMD_CALL_STR)==0 or cmd_str.compare(CMD_ALL_STR)==0){
 	cout << "   --gt_hete_ratio FLOAT" << endl;
 	cout << "                 minimal allele ratio threshold for heterozygous alleles [" << GT_HETE_RATIO_THRES << "]." << endl;
 	cout << "                 Variant is heterozygous if the ratio of allele count is larger than FLOAT." << endl;
+	cout << "   --minimap2-lib" << endl;
+	cout << "                 align the consensus sequences by the minimap2 library in" << endl;
+	cout << "                 process instead of the 'minimap2' executable [False]" << endl;
+	cout << "   --minimap2-batch INT" << endl;
+	cout << "                 number of call works on a chromosome aligned by a single" << endl;
+	cout << "                 'minimap2' process, e.g. 200; 0 for no batch [" << MINIMAP2_BATCH_SIZE_DEFAULT << "]" << endl;
+	cout << "                 The alignments may slightly differ from those of separate" << endl;
+	cout << "                 processes, as the works in a batch share one index" << endl;
+	cout << "   --scratch-dir DIR" << endl;
+	cout << "                 directory of the transient consensus and alignment files," << endl;
+	cout << "                 'none' for the output directory [$TMPDIR or /dev/shm]" << endl;
+	cout << "   --cns-cache-dir DIR" << endl;
+	cout << "                 directory of the consensus cache shared by reruns, the" << endl;
+	cout << "                 consensus of identical reads is reused from it [none]" << endl;
 }
 
 	cout << "   -v,--version  show version information" << endl;
@@ -1239,10 +1316,11 @@ void Paras::outputParas(){
 //		cout << "Monitored process names for consensus: " << monitoring_proc_names_cns << endl;
 //	if(command.compare("call")==0 or command.compare("all")==0)
 //		cout << "Monitored process names for call: " << monitoring_proc_names_call << endl;
-//	if(command.compare("cns")==0 or command.compare("all")==0 or command.compare("det-cns")==0)
-//		cout << "Maximum monitored process running minutes for consensus: " << max_proc_running_minutes_cns << endl;
-//	if(command.compare("call")==0 or command.compare("all")==0)
-//		cout << "Maximum monitored process running minutes for call: " << max_proc_running_minutes_call << endl;
+	if(command.compare("cns")==0 or command.compare("all")==0 or command.compare("det-cns")==0)
+		cout << "Maximum process running minutes for consensus: " << max_proc_running_minutes_cns << endl;
+	if(command.compare("call")==0 or command.compare("all")==0)
+		cout << "Maximum process running minutes for call: " << max_proc_running_minutes_call << endl;
+	if(max_proc_mem_gb>0) cout << "Memory limit of each external process: " << max_proc_mem_gb << " GB" << endl;
 
 	cout << "Maximal number of align segments per read: " << max_seg_num_per_read << endl;
 	cout << "Minimal sequence identity threshold for SV match: " << min_identity_match << endl;
@@ -1254,6 +1332,12 @@ void Paras::outputParas(){
 
 	if(include_alt) cout << "Include reference alt items: yes" << endl;
 	if(include_decoy) cout << "Include decoy items: yes" << endl;
+	if(numa_flag) cout << "NUMA mode: yes" << endl;
+	if(fast_path_flag) cout << "Fast path of simple indels: yes" << endl;
+	if(minimap2_lib_flag) cout << "In-process minimap2 alignment: yes" << endl;
+	if(minimap2_batch_size>1) cout << "Call works per minimap2 batch: " << minimap2_batch_size << endl;
+	if(scratch_dir.size()>0) cout << "Scratch directory: " << scratch_dir << endl;
+	if(cns_cache_dir.size()>0) cout << "Consensus cache directory: " << cns_cache_dir << endl;
 	cout << "Sequencing technology: " << technology << endl;
 	cout << "abPOA version: " << abpoa_version << endl;
 	cout << "minimap2 version: " << minimap2_version << endl;
@@ -1516,6 +1600,54 @@ int Paras::parse_long_opt(int32_t option_index, const char *optarg, const struct
 	}
 	else if(opt_name_str.compare("include-decoy")==0){ // include-decoy
 		include_decoy = true;
+	}else if(opt_name_str.compare("numa")==0){ // numa
+		numa_flag = true;
+	}else if(opt_name_str.compare("fast-path")==0){ // fast-path
+		fast_path_flag = true;
+	}else if(opt_name_str.compare("minimap2-lib")==0){ // minimap2-lib
+#ifdef HAVE_LIBMINIMAP2
+		minimap2_lib_flag = true;
+#else
+		cout << "Warning: the program was built without the minimap2 library, '--minimap2-lib' is ignored." << endl;
+#endif
+	}else if(opt_name_str.compare("minimap2-batch")==0){ // minimap2-batch
+		minimap2_batch_size = stoi(optarg);
+		if(minimap2_batch_size<0){
+			cout << "Error: Please specify the correct number of call works per minimap2 batch using '--minimap2-batch' option." << endl << endl;
+			ret = 1;
+		}
+	}else if(opt_name_str.compare("scratch-dir")==0){ // scratch-dir
+		scratch_dir = optarg;
+		if(scratch_dir.compare("none")==0) scratch_dir = "";
+		else{
+			scratch_dir = deleteTailPathChar(scratch_dir);
+			if(access(scratch_dir.c_str(), W_OK | X_OK)!=0){
+				cout << "Error: Please specify the writable scratch directory using '--scratch-dir' option." << endl << endl;
+				ret = 1;
+			}
+		}
+	}else if(opt_name_str.compare("cns-cache-dir")==0){ // cns-cache-dir
+		cns_cache_dir = optarg;
+		cns_cache_dir = deleteTailPathChar(cns_cache_dir);
+	}else if(opt_name_str.compare("max-proc-running-minutes-cns")==0){ // max-proc-running-minutes-cns
+		max_proc_running_minutes_cns = stoi(optarg);
+		if(max_proc_running_minutes_cns<0 or (max_proc_running_minutes_cns>0 and max_proc_running_minutes_cns<ULTRA_LOW_PROC_RUNNING_MINUTES)){
+			cout << "Error: The specified maximum process running minutes is too small '" << max_proc_running_minutes_cns << "', please specify 0 or a larger one at least " << ULTRA_LOW_PROC_RUNNING_MINUTES << "." << endl << endl;
+			ret = 1;
+		}
+	}else if(opt_name_str.compare("max-proc-running-minutes-call")==0){ // max-proc-running-minutes-call
+		max_proc_running_minutes_call = stoi(optarg);
+		if(max_proc_running_minutes_call<0 or (max_proc_running_minutes_call>0 and max_proc_running_minutes_call<ULTRA_LOW_PROC_RUNNING_MINUTES)){
+			cout << "Error: The specified maximum process running minutes is too small '" << max_proc_running_minutes_call << "', please specify 0 or a larger one at least " << ULTRA_LOW_PROC_RUNNING_MINUTES << "." << endl << endl;
+			ret = 1;
+		}
+	}else if(opt_name_str.compare("max-proc-mem")==0){ // max-proc-mem
+		max_proc_mem_gb = stoi(optarg);
+		if(max_proc_mem_gb<0){
+			cout << "Error: Please specify the correct memory limit of the external processes using '--max-proc-mem' option." << endl << endl;
+			ret = 1;
+		}
+		proc_max_mem_bytes = (int64_t)max_proc_mem_gb << 30;
 	}
 //	else if(opt_name_str.compare("gt-min-sig-size")==0){ // "gt-min-sig-size"
 //		gt_min_sig_size = stoi(optarg);
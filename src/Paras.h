@@ -10,6 +10,7 @@
 
 #include "structures.h"
 #include "meminfo.h"
+#include "cpuinfo.h"
 
 
 using namespace std;
@@ -144,11 +145,14 @@ using namespace std;
 #define MAX_CNS_MINUTES						15
 #define MAX_ALN_MINUTES						15
 
+#define MINIMAP2_BATCH_SIZE_DEFAULT			0		// number of call works aligned by a single minimap2 process, 0 for no batch
+#define MINIMAP2_BATCH_NAME_SEP				"|"		// separator between the work index and the sequence name in batch files
+
 //#define MAX_PROC_RUNNING_MINUTES				120
 #define MAX_PROC_RUNNING_MINUTES_CNS			30	//300
 #define MAX_PROC_RUNNING_MINUTES_CALL			30  //120
-#define MONITOR_WAIT_SECONDS					60
 #define ULTRA_LOW_PROC_RUNNING_MINUTES			30
+#define MAX_PROC_MEM_GB_DEFAULT					0		// memory limit of each external process in GB, 0 for no limit
 
 //#define DEFAULT_MONITOR_PROC_NAMES				"overlapInCore,falconsense,blat"
 #define DEFAULT_MONITOR_PROC_NAMES_CNS			"overlapInCore,falconsense"
@@ -161,6 +165,8 @@ using namespace std;
 
 #define MAX_RESCUE_VAR_SIZE					40000
 
+class ThreadPool;
+
 // program parameters
 class Paras
 {
@@ -184,7 +190,7 @@ class Paras
 		
 		// process monitor
 		string monitoring_proc_names_cns, monitoring_proc_names_call;
-		int32_t max_proc_running_minutes_cns, max_proc_running_minutes_call;
+		int32_t max_proc_running_minutes_cns, max_proc_running_minutes_call, max_proc_mem_gb;
 
 		// limit SV regions, item format: CHR | CHR:START-END
 		vector<simpleReg_t*> limit_reg_vec;
@@ -222,6 +228,16 @@ class Paras
 		int16_t num_parts_progress, num_threads_per_cns_work;
 		pthread_mutex_t mtx_cns_reg_workDone_num;
 
+		// process-wide thread pool shared by all stages, created in main
+		ThreadPool *thread_pool;
+		bool numa_flag;		// pin workers to NUMA nodes and keep neighbouring blocks on one node
+		bool fast_path_flag;	// call the simple indels directly from the read evidence, without local consensus
+		int64_t detect_indel_num, fast_path_indel_num;	// detected indel candidates and the ones called by the fast path
+		bool minimap2_lib_flag;		// align the consensus sequences by the minimap2 library in process
+		int32_t minimap2_batch_size;	// number of call works aligned by a single minimap2 process
+		string scratch_dir;		// directory of the transient consensus and alignment files, empty for the output directory
+		string cns_cache_dir;	// directory of the content-addressed consensus cache, empty for disabling it
+
 		// call works for thread pool
 		vector<varCand*> call_work_vec;
 		int32_t call_work_num, call_workDone_num;
@@ -255,7 +271,7 @@ class Paras
 
 	private:
 		void init();
-		string getProgramVersion(const string &cmd_str);
+		string getProgramVersion(const string &prog_name, const string &version_opt, const string &name_pattern, size_t field_id);
 		bool isRecommendCanuVersion(string &canu_version, const string &recommend_version);
 //		string getMinimap2Version();
 //		string getAbpoaVersion();
@@ -1,171 +1,239 @@
 #include "Thread.h"
+#ifdef HAVE_LIBNUMA
+#include <numa.h>
+#endif
+#include <sys/time.h>
 
-
-Thread::Thread()
+ThreadPool::ThreadPool(int32_t num_threads, bool numa_flag)
 {
-	tid = 0;
-	user_tid = 0;
-	blockVector = NULL;
-	var_cand_vec = NULL;
-	var_cand_clipReg_vec = NULL;
-	blat_aln_tra_vec = NULL;
-}
+	pthread_t tid;
+
+	if(num_threads<1) num_threads = 1;
+	this->num_threads = num_threads;
+	max_queued_num = num_threads * MAX_QUEUED_TASK_FACTOR;
+	next_task_type = 0;
+	shutdown_flag = false;
+	for(int32_t i=0; i<TASK_TYPE_NUM; i++){
+		running_num_arr[i] = 0;
+		max_running_num_arr[i] = num_threads;
+	}
 
-Thread::~Thread(){
+	// NUMA nodes, the workers are assigned to the nodes in contiguous chunks
+	num_numa_nodes = 1;
+	this->numa_flag = false;
+	if(numa_flag){
+#ifdef HAVE_LIBNUMA
+		if(numa_available()!=-1){
+			num_numa_nodes = numa_max_node() + 1;
+			this->numa_flag = true;
+		}else cout << "Warning: NUMA is not available on this machine, NUMA mode is disabled." << endl;
+#else
+		cout << "Warning: the program was built without libnuma, NUMA mode is disabled." << endl;
+#endif
+	}
+	for(int32_t i=0; i<num_threads; i++) worker_node_vec.push_back((int64_t)i * num_numa_nodes / num_threads);
+	for(int32_t i=0; i<TASK_TYPE_NUM; i++) node_stat_vec[i].resize(num_numa_nodes, (numaNodeStat_t){0, 0, 0});
+	started_worker_num = 0;
+
+	pthread_mutex_init(&mtx_pool, NULL);
+	pthread_cond_init(&cond_task, NULL);
+	pthread_cond_init(&cond_space, NULL);
+	pthread_cond_init(&cond_done, NULL);
+
+	for(int32_t i=0; i<num_threads; i++){
+		if(pthread_create(&tid, NULL, runWorker0, this)!=0){
+			cerr << __func__ << ", line=" << __LINE__ << ": unable to create thread, error!" << endl;
+			exit(1);
+		}
+		tid_vec.push_back(tid);
+	}
 }
 
-void* Thread::runDetect0(void* pVoid)
-{
-	Thread* p = (Thread*) pVoid;
-	p->runDetect1();
-	return p;
-}
+ThreadPool::~ThreadPool(){
+	pthread_mutex_lock(&mtx_pool);
+	shutdown_flag = true;
+	pthread_cond_broadcast(&cond_task);
+	pthread_mutex_unlock(&mtx_pool);
 
-void* Thread::runDetect1()
-{
-	runDetect();
-	pthread_exit(NULL);
-}
+	for(size_t i=0; i<tid_vec.size(); i++){
+		if(pthread_join(tid_vec.at(i), NULL)!=0){
+			cerr << __func__ << ", line=" << __LINE__ << ": unable to join, error!" << endl;
+			exit(1);
+		}
+	}
 
-bool Thread::startDetect()
-{
-	return pthread_create(&tid, NULL, runDetect0, this) == 0;
+	pthread_mutex_destroy(&mtx_pool);
+	pthread_cond_destroy(&cond_task);
+	pthread_cond_destroy(&cond_space);
+	pthread_cond_destroy(&cond_done);
 }
 
-void* Thread::runGenConsWorkOpt0(void* pVoid)
+void* ThreadPool::runWorker0(void* pVoid)
 {
-	Thread* p = (Thread*) pVoid;
-	p->runGenConsWorkOpt1();
-	return p;
+	ThreadPool* p = (ThreadPool*) pVoid;
+	p->runWorker();
+	return NULL;
+}
+
+// worker loop: take the tasks in round-robin order of the task types under their running limits;
+// in NUMA mode, the tasks preferring the node of the worker are taken first, otherwise the first queued task is stolen
+void ThreadPool::runWorker(){
+	int32_t task_type, numa_node;
+	poolTask_t task;
+	deque<poolTask_t>::iterator it;
+	struct timeval start_time, end_time;
+	double busy_seconds;
+
+	pthread_mutex_lock(&mtx_pool);
+	numa_node = worker_node_vec.at(started_worker_num++);
+	pthread_mutex_unlock(&mtx_pool);
+
+	if(numa_flag) bindWorkerToNumaNode(numa_node);
+
+	while(1){
+		pthread_mutex_lock(&mtx_pool);
+		while((task_type=getRunnableTaskType())==-1 and shutdown_flag==false) pthread_cond_wait(&cond_task, &mtx_pool);
+		if(task_type==-1){ // shutdown and no task left
+			pthread_mutex_unlock(&mtx_pool);
+			break;
+		}
+		it = task_queue_arr[task_type].begin();
+		if(numa_flag){
+			for(; it!=task_queue_arr[task_type].end(); it++) if(it->numa_node==-1 or it->numa_node==numa_node) break;
+			if(it==task_queue_arr[task_type].end()) it = task_queue_arr[task_type].begin();
+		}
+		task = *it;
+		task_queue_arr[task_type].erase(it);
+		running_num_arr[task_type] ++;
+		pthread_cond_broadcast(&cond_space);
+		pthread_mutex_unlock(&mtx_pool);
+
+		gettimeofday(&start_time, NULL);
+		task.func(task.arg);
+		gettimeofday(&end_time, NULL);
+		busy_seconds = (end_time.tv_sec - start_time.tv_sec) + (end_time.tv_usec - start_time.tv_usec) / 1000000.0;
+
+		pthread_mutex_lock(&mtx_pool);
+		running_num_arr[task_type] --;
+		node_stat_vec[task_type].at(numa_node).task_num ++;
+		if(task.numa_node!=-1 and task.numa_node!=numa_node) node_stat_vec[task_type].at(numa_node).remote_task_num ++;
+		node_stat_vec[task_type].at(numa_node).busy_seconds += busy_seconds;
+		pthread_cond_broadcast(&cond_done);
+		pthread_cond_broadcast(&cond_task);  // a task of the limited type may be runnable now
+		pthread_mutex_unlock(&mtx_pool);
+	}
 }
 
-void* Thread::runGenConsWorkOpt1()
-{
-	runGenConsWorkOpt();
-	pthread_exit(NULL);
+// pin the calling worker to the CPUs of the given node, and allocate its memory on the local node
+void ThreadPool::bindWorkerToNumaNode(int32_t numa_node){
+#ifdef HAVE_LIBNUMA
+	if(numa_run_on_node(numa_node)!=0)
+		cerr << __func__ << ", line=" << __LINE__ << ": unable to bind the thread to NUMA node " << numa_node << endl;
+	numa_set_localalloc();
+#endif
 }
 
-bool Thread::startGenConsWorkOpt()
-{
-	return pthread_create(&tid, NULL, runGenConsWorkOpt0, this) == 0;
-}
+// get the type of the next runnable task, -1 for none; the pool mutex should be held by the caller
+int32_t ThreadPool::getRunnableTaskType(){
+	int32_t i, task_type;
 
-void* Thread::runCall0(void* pVoid)
-{
-	Thread* p = (Thread*) pVoid;
-	p->runCall1();
-	return p;
+	for(i=0; i<TASK_TYPE_NUM; i++){
+		task_type = (next_task_type + i) % TASK_TYPE_NUM;
+		if(task_queue_arr[task_type].empty()==false and running_num_arr[task_type]<max_running_num_arr[task_type]){
+			next_task_type = (task_type + 1) % TASK_TYPE_NUM;
+			return task_type;
+		}
+	}
+	return -1;
 }
 
-void* Thread::runCall1()
-{
-	runCall();
-	pthread_exit(NULL);
+int32_t ThreadPool::getNumThreads(){
+	return num_threads;
 }
 
-bool Thread::startCall()
-{
-	return pthread_create(&tid, NULL, runCall0, this) == 0;
+int32_t ThreadPool::getNumNumaNodes(){
+	return num_numa_nodes;
 }
 
-void* Thread::runBlatAlnTra0(void* pVoid)
-{
-	Thread* p = (Thread*) pVoid;
-	p->runBlatAlnTra1();
-	return p;
+bool ThreadPool::isNumaEnabled(){
+	return numa_flag;
 }
 
-void* Thread::runBlatAlnTra1()
-{
-	runBlatAlnTra();
-	pthread_exit(NULL);
-}
+// set the maximal number of concurrently running tasks of the given type, it is limited by the number of threads
+void ThreadPool::setMaxRunningNum(int32_t task_type, int32_t max_running_num){
+	if(max_running_num<1) max_running_num = 1;
+	else if(max_running_num>num_threads) max_running_num = num_threads;
 
-bool Thread::startBlatAlnTra()
-{
-	return pthread_create(&tid, NULL, runBlatAlnTra0, this) == 0;
+	pthread_mutex_lock(&mtx_pool);
+	max_running_num_arr[task_type] = max_running_num;
+	pthread_cond_broadcast(&cond_task);
+	pthread_mutex_unlock(&mtx_pool);
 }
 
-pthread_t Thread::getThreadID()
-{
-	return tid;
-}
+// submit a task of the given type with its preferred NUMA node, and block if too many tasks of this type are queued
+void ThreadPool::dispatch(int32_t task_type, taskFunc_t func, void *arg, int32_t numa_node){
+	poolTask_t task;
 
-void Thread::setUserThreadID(size_t user_tid){
-	this->user_tid = user_tid;
-}
+	task.func = func;
+	task.arg = arg;
+	task.numa_node = (numa_flag and numa_node>=0 and numa_node<num_numa_nodes) ? numa_node : -1;
 
-void Thread::setBlockVec(vector<Block*> *blockVector){
-	this->blockVector = blockVector;
-}
-void Thread::setVarCandVec(vector<varCand*> *var_cand_vec, vector<varCand*> *var_cand_clipReg_vec){
-	this->var_cand_vec = var_cand_vec;
-	this->var_cand_clipReg_vec = var_cand_clipReg_vec;
+	pthread_mutex_lock(&mtx_pool);
+	while((int32_t)task_queue_arr[task_type].size()>=max_queued_num) pthread_cond_wait(&cond_space, &mtx_pool);
+	task_queue_arr[task_type].push_back(task);
+	pthread_cond_broadcast(&cond_task);
+	pthread_mutex_unlock(&mtx_pool);
 }
 
-void Thread::setBlatAlnTraVec(vector<blatAlnTra*> *blat_aln_tra_vec){
-	this->blat_aln_tra_vec = blat_aln_tra_vec;
+// wait until all submitted tasks of the given type are finished, it should not be called by the worker threads
+void ThreadPool::wait(int32_t task_type){
+	pthread_mutex_lock(&mtx_pool);
+	while(task_queue_arr[task_type].empty()==false or running_num_arr[task_type]>0) pthread_cond_wait(&cond_done, &mtx_pool);
+	pthread_mutex_unlock(&mtx_pool);
 }
 
-size_t Thread::getUserThreadID(){
-	return user_tid;
-}
+// print the per-node task throughput and the ratio of stolen remote tasks
+void ThreadPool::printNumaStat(int32_t task_type, const string &description){
+	numaNodeStat_t *node_stat;
+	double throughput, remote_ratio;
 
-bool Thread::join()
-{
-	return pthread_join(tid, NULL) == 0;
-}
+	if(numa_flag==false) return;
 
-void MultiThread::setNumThreads(size_t n){
-	num_threads = n;
+	pthread_mutex_lock(&mtx_pool);
+	cout << "NUMA statistics for " << description << ":" << endl;
+	for(int32_t i=0; i<num_numa_nodes; i++){
+		node_stat = &node_stat_vec[task_type].at(i);
+		throughput = (node_stat->busy_seconds>0) ? node_stat->task_num / node_stat->busy_seconds : 0;
+		remote_ratio = (node_stat->task_num>0) ? (double)node_stat->remote_task_num / node_stat->task_num : 0;
+		cout << "\tnode " << i << ": tasks=" << node_stat->task_num << ", busy_seconds=" << node_stat->busy_seconds << ", throughput=" << throughput << " tasks/s, remote_ratio=" << remote_ratio << endl;
+	}
+	pthread_mutex_unlock(&mtx_pool);
 }
 
-void MultiThread::runDetect(){
-	size_t user_tid_tmp = getUserThreadID();
-	Block *bloc;
-	for (size_t i=0; i < blockVector->size(); i++){
-		if(i%num_threads==user_tid_tmp){
-			bloc = blockVector->at(i);
-			if(bloc->process_flag) bloc->blockDetect();
-		}
-	}
+// process single block detection work
+void* processSingleBlockDetectWork(void *arg){
+	Block *bloc = (Block *)arg;
+	bloc->blockDetect();
+	return NULL;
 }
 
-void MultiThread::runGenConsWorkOpt(){
-	size_t user_tid_tmp = getUserThreadID();
-	Block *bloc;
-	for (size_t i=0; i < blockVector->size(); i++){
-		if(i%num_threads==user_tid_tmp){
-			bloc = blockVector->at(i);
-			if(bloc->process_flag) bloc->blockGenerateLocalConsWorkOpt();
-		}
-	}
+// process single block work for generating consensus work options
+void* processSingleBlockGenConsWorkOptWork(void *arg){
+	Block *bloc = (Block *)arg;
+	bloc->blockGenerateLocalConsWorkOpt();
+	return NULL;
 }
 
-void MultiThread::runCall(){
-	size_t i, user_tid_tmp = getUserThreadID();
-	varCand *var_cand;
-	for (i=0; i < var_cand_vec->size(); i++){
-		if(i%num_threads==user_tid_tmp){
-			var_cand = var_cand_vec->at(i);
-			var_cand->callVariants();
-		}
-	}
-	for (i=0; i < var_cand_clipReg_vec->size(); i++){
-		if(i%num_threads==user_tid_tmp){
-			var_cand = var_cand_clipReg_vec->at(i);
-			var_cand->callVariants();
-		}
-	}
+// process single variant candidate call work
+void* processSingleVarCandCallWork(void *arg){
+	varCand *var_cand = (varCand *)arg;
+	var_cand->callVariants();
+	return NULL;
 }
 
-void MultiThread::runBlatAlnTra(){
-	size_t i, user_tid_tmp = getUserThreadID();
-	blatAlnTra *blat_aln_tra;
-	for (i=0; i < blat_aln_tra_vec->size(); i++){
-		if(i%num_threads==user_tid_tmp){
-			blat_aln_tra = blat_aln_tra_vec->at(i);
-			blat_aln_tra->generateBlatResult();
-		}
-	}
+// process single blat alignment work for translocations
+void* processSingleBlatAlnTraWork(void *arg){
+	blatAlnTra *blat_aln_tra = (blatAlnTra *)arg;
+	blat_aln_tra->generateBlatResult();
+	return NULL;
 }
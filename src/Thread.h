@@ -4,6 +4,7 @@
 #include <iostream>
 #include <string>
 #include <vector>
+#include <deque>
 
 #include <pthread.h>
 #include <unistd.h>
@@ -12,56 +13,71 @@
 
 using namespace std;
 
-class Thread
+// task types of the process-wide thread pool
+#define TASK_TYPE_DETECT				0	// block detection
+#define TASK_TYPE_MATE_CLIP_REG			1	// mate clipping region detection
+#define TASK_TYPE_GEN_CNS_WORK			2	// generate consensus work options of block
+#define TASK_TYPE_CNS					3	// local consensus
+#define TASK_TYPE_ALN					4	// consensus alignment
+#define TASK_TYPE_CALL					5	// variant call
+#define TASK_TYPE_BLAT_TRA				6	// blat alignment for translocations
+#define TASK_TYPE_FILL_VARSEQ_TRA		7	// fill variant sequences for translocations
+#define TASK_TYPE_RM_DUP_SV				8	// identity of duplicated variant items
+#define TASK_TYPE_NUM					9
+
+#define MAX_QUEUED_TASK_FACTOR			2	// maximal number of queued tasks of each type: factor * num_threads
+
+typedef void *(*taskFunc_t)(void *arg);
+
+typedef struct{
+	taskFunc_t func;
+	void *arg;
+	int32_t numa_node;	// preferred NUMA node, -1 for any node
+}poolTask_t;
+
+// per-node statistics of tasks, used as the proxy of remote memory access in NUMA mode
+typedef struct{
+	int64_t task_num, remote_task_num;	// remote tasks: preferred by other nodes but stolen by this node
+	double busy_seconds;
+}numaNodeStat_t;
+
+// process-wide thread pool: the worker threads are created once in main and shared by all stages,
+// tasks are submitted with their types, and each type can be limited to a maximal number of running tasks
+class ThreadPool
 {
 	private:
-		pthread_t tid;
-		size_t user_tid;   // 0-based: 0, 1, 2, 3, ...
-		static void* runDetect0(void* pVoid);  // the pointer to executing function
-		void* runDetect1();  // inner executing method
-		static void* runGenConsWorkOpt0(void* pVoid);  // the pointer to executing function
-		void* runGenConsWorkOpt1();  // inner executing method
-		static void* runCall0(void* pVoid);  // the pointer to executing function
-		void* runCall1();  // inner executing method
-		static void* runBlatAlnTra0(void* pVoid);  // the pointer to executing function
-		void* runBlatAlnTra1();  // inner executing method
-
-	public:
-		vector<Block*> *blockVector;
-		vector<varCand*> *var_cand_vec;
-		vector<varCand*> *var_cand_clipReg_vec;
-		vector<blatAlnTra*> *blat_aln_tra_vec;
-		Thread();
-		virtual ~Thread();
-		virtual void runDetect() = 0;  // thread running entity
-		virtual void runGenConsWorkOpt() = 0;  // thread running entity
-		virtual void runCall() = 0;  // thread running entity
-		virtual void runBlatAlnTra() = 0;  // thread running entity
-		bool startDetect();  // start the thread for detection
-		bool startGenConsWorkOpt();  // start the thread for detection
-		bool startCall();  // start the thread for detection
-		bool startBlatAlnTra();  // start the thread for detection
-		pthread_t getThreadID();
-		void setUserThreadID(size_t user_tid); // set user tid
-		void setBlockVec(vector<Block*> *vec);
-		void setVarCandVec(vector<varCand*> *var_cand_vec, vector<varCand*> *var_cand_clipReg_vec);
-		void setBlatAlnTraVec(vector<blatAlnTra*> *blat_aln_tra_vec);
-		size_t getUserThreadID();
-		bool join();
-};
+		int32_t num_threads, max_queued_num, next_task_type, num_numa_nodes;
+		bool numa_flag;
+		vector<pthread_t> tid_vec;
+		vector<int32_t> worker_node_vec;	// NUMA node of each worker
+		vector<numaNodeStat_t> node_stat_vec[TASK_TYPE_NUM];
+		int32_t started_worker_num;
+		deque<poolTask_t> task_queue_arr[TASK_TYPE_NUM];
+		int32_t running_num_arr[TASK_TYPE_NUM], max_running_num_arr[TASK_TYPE_NUM];
+		bool shutdown_flag;
+		pthread_mutex_t mtx_pool;
+		pthread_cond_t cond_task, cond_space, cond_done;
 
+		static void* runWorker0(void* pVoid);  // the pointer to executing function
+		void runWorker();  // inner executing method
+		int32_t getRunnableTaskType();
+		void bindWorkerToNumaNode(int32_t numa_node);
 
-// multi-thread
-class MultiThread: public Thread {
 	public:
-		size_t num_threads = 0;
-		void runDetect();
-		void runGenConsWorkOpt();
-		void runCall();
-		void runBlatAlnTra();
-		//void runFillVarSeq();
-		void setNumThreads(size_t n);
+		ThreadPool(int32_t num_threads, bool numa_flag=false);
+		virtual ~ThreadPool();
+		int32_t getNumThreads();
+		int32_t getNumNumaNodes();
+		bool isNumaEnabled();
+		void setMaxRunningNum(int32_t task_type, int32_t max_running_num);
+		void dispatch(int32_t task_type, taskFunc_t func, void *arg, int32_t numa_node=-1);
+		void wait(int32_t task_type);
+		void printNumaStat(int32_t task_type, const string &description);
 };
 
+void* processSingleBlockDetectWork(void *arg);
+void* processSingleBlockGenConsWorkOptWork(void *arg);
+void* processSingleVarCandCallWork(void *arg);
+void* processSingleBlatAlnTraWork(void *arg);
 
 #endif /* _THREAD_H */
@@ -297,11 +297,9 @@ void alnDataLoader::computeAlnDataNumFromIter(samFile *in, bam_hdr_t *header, ht
 void alnDataLoader::loadAlnDataFromIter(vector<bam1_t*> &alnDataVector, samFile *in, bam_hdr_t *header, hts_itr_t *iter, string& reg, double max_ultra_high_cov, vector<string> qname_vec, vector<int32_t> &qlen_vec, vector<int32_t> &qual_vec, size_t total_len, size_t total_num){
 	int result;
 	bam1_t *b;
-	double expected_total_bases;//, sampled_cov;
 	double compensation_coefficient, local_cov_original;
-	size_t i, index, reg_size, num, max_reads_num, total_bases;
+	size_t i;
 	int8_t *selected_flag_array;
-	set<string> selected_qname_vec;
 	//int32_t k, min_id, max_id;
 	//string qname;
 	//vector<int32_t> high_qual_id_vec;
@@ -320,10 +318,6 @@ void alnDataLoader::loadAlnDataFromIter(vector<bam1_t*> &alnDataVector, samFile
 	compensation_coefficient = computeCompensationCoefficient(startRefPos, endRefPos);
 	local_cov_original = computeLocalCov(total_len, compensation_coefficient);
 	if(max_ultra_high_cov>0 and local_cov_original>max_ultra_high_cov){  // down sample
-		reg_size = endRefPos - startRefPos + 1 + mean_read_len;
-		expected_total_bases = reg_size * max_ultra_high_cov;
-		max_reads_num = qlen_vec.size();
-
 //		for(i=0; i<qual_vec.size(); i++) if(qual_vec.at(i)>=minHighMapQ and qual_vec.at(i)!=255) high_qual_id_vec.push_back(i);
 //
 //		num = total_bases = 0;
@@ -421,31 +415,7 @@ void alnDataLoader::loadAlnDataFromIter(vector<bam1_t*> &alnDataVector, samFile
 //			}
 //		}
 
-		// make sure each down-sampling is equivalent
-		//pthread_mutex_lock(&mutex_down_sample);
-		num = total_bases = 0;
-		srand(1);
-		while(total_bases <= expected_total_bases and num < max_reads_num){
-			index = rand() % max_reads_num;
-			if(selected_flag_array[index]==0){
-				selected_flag_array[index] = 1;
-				if(selected_qname_vec.find(qname_vec.at(index))==selected_qname_vec.end()){ // new item
-					selected_qname_vec.insert(qname_vec.at(index));
-					total_bases += qlen_vec.at(index);
-				}
-				num ++;
-//				cout << "index=" << index << " selected_flag_array[index]=" << selected_flag_array[index] << " total_bases=" << total_bases << ", num=" << num << endl;
-			}
-		}
-		//pthread_mutex_unlock(&mutex_down_sample);
-
-		// append remaining align items of the selected reads
-		for(i=0; i<qname_vec.size(); i++){
-			if(selected_flag_array[i]==0){
-				if(selected_qname_vec.find(qname_vec.at(i))!=selected_qname_vec.end()) // found, then add item
-					selected_flag_array[i] = 1;
-			}
-		}
+		selectDownSampledItems(selected_flag_array, qname_vec, qlen_vec, max_ultra_high_cov);
 		//sampled_cov = total_bases / reg_size;
 		//cout << "sampled_cov=" << sampled_cov << endl;
 
@@ -738,6 +708,80 @@ double alnDataLoader::computeCompensationCoefficient(size_t startRefPos, size_t
 	return comp_coefficient;
 }
 
+// select the items of the reads down-sampled to max_ultra_high_cov, the reads are drawn by the same
+// random sequence to make sure each down-sampling is equivalent
+void alnDataLoader::selectDownSampledItems(int8_t *selected_flag_array, vector<string> &qname_vec, vector<int32_t> &qlen_vec, double max_ultra_high_cov){
+	double expected_total_bases;
+	size_t i, index, reg_size, num, max_reads_num, total_bases;
+	set<string> selected_qname_vec;
+
+	reg_size = endRefPos - startRefPos + 1 + mean_read_len;
+	expected_total_bases = reg_size * max_ultra_high_cov;
+	max_reads_num = qlen_vec.size();
+
+	//pthread_mutex_lock(&mutex_down_sample);
+	num = total_bases = 0;
+	srand(1);
+	while(total_bases <= expected_total_bases and num < max_reads_num){
+		index = rand() % max_reads_num;
+		if(selected_flag_array[index]==0){
+			selected_flag_array[index] = 1;
+			if(selected_qname_vec.find(qname_vec.at(index))==selected_qname_vec.end()){ // new item
+				selected_qname_vec.insert(qname_vec.at(index));
+				total_bases += qlen_vec.at(index);
+			}
+			num ++;
+		}
+	}
+	//pthread_mutex_unlock(&mutex_down_sample);
+
+	// append remaining align items of the selected reads
+	for(i=0; i<qname_vec.size(); i++){
+		if(selected_flag_array[i]==0){
+			if(selected_qname_vec.find(qname_vec.at(i))!=selected_qname_vec.end()) // found, then add item
+				selected_flag_array[i] = 1;
+		}
+	}
+}
+
+// select the align items of the region from the align data loaded for a larger region, the same items as
+// loadAlnData() for the region are selected, including the down-sampling; the items are not copied
+void alnDataLoader::selectAlnData(vector<bam1_t*> &selectedAlnDataVector, vector<bam1_t*> &alnDataVector, double max_ultra_high_cov){
+	bam1_t *b;
+	vector<bam1_t*> reg_aln_vec;
+	vector<string> qname_vec;
+	vector<int32_t> qlen_vec;
+	size_t i, total_len = 0;
+	double compensation_coefficient, local_cov_original;
+	int8_t *selected_flag_array;
+
+	// the items overlapped with the region, the same as the region iteration of loadAlnData()
+	for(i=0; i<alnDataVector.size(); i++){
+		b = alnDataVector.at(i);
+		if(b->core.pos<endRefPos and bam_endpos(b)>=startRefPos and b->core.l_qseq>0 and (b->core.qual>=minMapQ and b->core.qual!=255)){
+			reg_aln_vec.push_back(b);
+			qname_vec.push_back(bam_get_qname(b));
+			qlen_vec.push_back(b->core.l_qseq);
+			total_len += b->core.l_qseq;
+		}
+	}
+	if(reg_aln_vec.empty()) return;
+	mean_read_len = (double) total_len / reg_aln_vec.size();
+
+	compensation_coefficient = computeCompensationCoefficient(startRefPos, endRefPos);
+	local_cov_original = computeLocalCov(total_len, compensation_coefficient);
+	if(max_ultra_high_cov>0 and local_cov_original>max_ultra_high_cov){  // down sample
+		selected_flag_array = (int8_t*) calloc(qlen_vec.size(), sizeof(int8_t));
+		if(selected_flag_array==NULL){
+			cerr << __func__ << ", line=" << __LINE__ << ": cannot allocate memory, error!" << endl;
+			exit(1);
+		}
+		selectDownSampledItems(selected_flag_array, qname_vec, qlen_vec, max_ultra_high_cov);
+		for(i=0; i<reg_aln_vec.size(); i++) if(selected_flag_array[i]==1) selectedAlnDataVector.push_back(reg_aln_vec.at(i));
+		free(selected_flag_array);
+	}else selectedAlnDataVector.insert(selectedAlnDataVector.end(), reg_aln_vec.begin(), reg_aln_vec.end());
+}
+
 // release the memory
 void alnDataLoader::freeAlnData(vector<bam1_t*> &alnDataVector){
 	if(!alnDataVector.empty()){
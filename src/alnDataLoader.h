@@ -30,6 +30,7 @@ class alnDataLoader {
 		void loadAlnData(vector<bam1_t*> &alnDataVector, double max_ultra_high_cov);
 		void loadAlnData(vector<bam1_t*> &alnDataVector, double max_ultra_high_cov, vector<string> &qname_vec);
 		void loadAlnData(vector<bam1_t*> &alnDataVector, vector<string> &qname_vec);
+		void selectAlnData(vector<bam1_t*> &selectedAlnDataVector, vector<bam1_t*> &alnDataVector, double max_ultra_high_cov);
 		void freeAlnData(vector<bam1_t*> &alnDataVector);
 
 	private:
@@ -39,6 +40,7 @@ class alnDataLoader {
 		void loadAlnDataFromIter(vector<bam1_t*> &alnDataVector, samFile *in, bam_hdr_t *header, hts_itr_t *iter, string& reg, double max_ultra_high_cov, vector<string> qname_vec, vector<int32_t> &qlen_vec, vector<int32_t> &qual_vec, size_t total_len, size_t total_num);
 		void loadAlnDataFromIter(vector<bam1_t*> &alnDataVector, samFile *in, bam_hdr_t *header, hts_itr_t *iter, string& reg, double max_ultra_high_cov, vector<string> &target_qname_vec, vector<string> &qname_vec, vector<int32_t> &qlen_vec, vector<int32_t> &qual_vec, size_t total_len, size_t total_num);
 		void loadAlnDataFromIter(vector<bam1_t*> &alnDataVector, samFile *in, bam_hdr_t *header, hts_itr_t *iter, string& reg, vector<string> &qname_vec);
+		void selectDownSampledItems(int8_t *selected_flag_array, vector<string> &qname_vec, vector<int32_t> &qlen_vec, double max_ultra_high_cov);
 		double computeLocalCov(size_t total_len, double compensation_coefficient);
 		double computeCompensationCoefficient(size_t startRefPos, size_t endRefPos);
 };
@@ -1,6 +1,7 @@
 #include "Paras.h"
 #include "Genome.h"
 #include "util.h"
+#include "Thread.h"
 
 int main(int argc, char **argv) {
 	Time time;
@@ -12,6 +13,10 @@ int main(int argc, char **argv) {
 	// output parameters
 	paras.outputParas();
 
+	// thread pool shared by all stages
+	ThreadPool thread_pool(paras.num_threads, paras.numa_flag);
+	paras.thread_pool = &thread_pool;
+
 	Genome genome(&paras);
 
 	// estimate the parameters for noisy background
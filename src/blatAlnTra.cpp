@@ -17,28 +17,22 @@ blatAlnTra::~blatAlnTra() {
 
 void blatAlnTra::generateBlatResult(){
 	int32_t ret;
-	killedBlatWork_t *killed_blat_work;
+	killedWorkRecord_t killed_work_rec;
 
 	if(killed_flag==false) killed_flag = getBlatWorkKilledFlag();
 
 	if(isFileExist(ctgfilename) and isFileExist(refseqfilename) and !isFileExist(alnfilename)){
 		if(killed_flag==false){
-			ret = blatAln(alnfilename, ctgfilename, refseqfilename, max_proc_running_minutes);
-			if(ret==-2){ // killed work, then add it to vector and record it to file
-				if(killed_blat_work_vec and killed_blat_work_file and mtx_killed_blat_work){ // pointer should not be NULL
-					killed_flag = true;
-
-					killed_blat_work = new killedBlatWork_t();
-					killed_blat_work->alnfilename = alnfilename;
-					killed_blat_work->ctgfilename = ctgfilename;
-					killed_blat_work->refseqfilename = refseqfilename;
-
-					pthread_mutex_lock(mtx_killed_blat_work);
-					(*killed_blat_work_vec).push_back(killed_blat_work);
-					*killed_blat_work_file << alnfilename << "\t" << ctgfilename << "\t" << refseqfilename << endl;
-					pthread_mutex_unlock(mtx_killed_blat_work);
-				}
-			}
+			killed_work_rec.alnfilename = alnfilename;
+			killed_work_rec.ctgfilename = ctgfilename;
+			killed_work_rec.refseqfilename = refseqfilename;
+			killed_work_rec.killed_minimap2_work_vec = NULL;
+			killed_work_rec.killed_blat_work_vec = killed_blat_work_vec;
+			killed_work_rec.killed_work_file = killed_blat_work_file;
+			killed_work_rec.mtx_killed_work = mtx_killed_blat_work;
+
+			ret = blatAln(alnfilename, ctgfilename, refseqfilename, max_proc_running_minutes, &killed_work_rec);
+			if(ret==PROC_RET_TIMEOUT) killed_flag = true; // killed work, it was recorded by the watchdog
 		}
 	}
 }
@@ -48,6 +42,7 @@ bool blatAlnTra::getBlatWorkKilledFlag(){
 	bool killed_flag = false;
 
 	if(killed_blat_work_vec and killed_blat_work_file and mtx_killed_blat_work){ // pointer should not be NULL
+		pthread_mutex_lock(mtx_killed_blat_work);  // the vector is also appended by the watchdog thread
 		for(size_t i=0; i<killed_blat_work_vec->size(); i++){
 			killed_blat_work = killed_blat_work_vec->at(i);
 			if(alnfilename.compare(killed_blat_work->alnfilename)==0 and ctgfilename.compare(killed_blat_work->ctgfilename)==0 and refseqfilename.compare(killed_blat_work->refseqfilename)==0){
@@ -55,6 +50,7 @@ bool blatAlnTra::getBlatWorkKilledFlag(){
 				break;
 			}
 		}
+		pthread_mutex_unlock(mtx_killed_blat_work);
 	}
 	return killed_flag;
 }
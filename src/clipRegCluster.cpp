@@ -1092,7 +1092,7 @@ vector<int8_t> clipRegCluster::computeQcMatchProfileSingleQueryClipReg(qcSigList
 	int32_t scoreIJ, tmp_gapScore1, tmp_gapScore2, maxValue, path_val, maxValue_ul, maxValue_l, maxValue_u;
 	struct alnScoreNode *scoreArr;
 	int64_t i, j, arrSize;
-	qcSig_t *qc_sig1, *qc_sig2;
+	int8_t *match_arr;
 	bool matchFlag;
 
 	matchScore = GT_SIG_MATCH_SCORE;
@@ -1116,13 +1116,13 @@ vector<int8_t> clipRegCluster::computeQcMatchProfileSingleQueryClipReg(qcSigList
 		for(j=1; j<colsNum; j++) scoreArr[j].path_val = 2;
 		for(i=1; i<rowsNum; i++) scoreArr[i*colsNum].path_val = 1;
 
+		// only the signature pairs within the matching distance are compared
+		match_arr = computeQcSigMatchArrClipReg(queryCluSig, seed_qcQuery, MAX_DIST_MATCH_CLIP_POS);
+
 		// compute the scores of each element
 		for(i=1; i<rowsNum; i++){
 			for(j=1; j<colsNum; j++){
-				qc_sig1 = queryCluSig->qcSig_vec.at(i-1);
-				qc_sig2 = seed_qcQuery->qcSig_vec.at(j-1);
-				//matchFlag = isQcSigMatchClipReg(qc_sig1, qc_sig2, MAX_DIST_MATCH_CLIP_POS, MIN_SIZE_RATIO_MATCH_CLIP_POS, QC_SIZE_RATIO_MATCH_THRES_INDEL, QC_IDENTITY_RATIO_MATCH_THRES);
-				matchFlag = isQcSigMatchClipReg(qc_sig1, qc_sig2, MAX_DIST_MATCH_CLIP_POS, MIN_SIZE_RATIO_MATCH_CLIP_POS, QC_SIZE_RATIO_MATCH_THRES_INDEL, min_identity_match);
+				matchFlag = match_arr[(i-1)*(colsNum-1)+j-1];
 				if(matchFlag) scoreIJ = matchScore;
 				else scoreIJ = mismatchScore;//
 
@@ -1170,11 +1170,67 @@ vector<int8_t> clipRegCluster::computeQcMatchProfileSingleQueryClipReg(qcSigList
 		// compute signature match profile
 		match_profile_vec = qComputeSigMatchProfileClipReg(scoreArr, rowsNum, colsNum, queryCluSig, seed_qcQuery);
 		free(scoreArr);
+		free(match_arr);
 	}
 
 	return match_profile_vec;
 }
 
+// order of the signatures by chromosome and reference position
+static bool isQcSigPosIdxLess(const qcSigPosIdx_t &sig_idx1, const qcSigPosIdx_t &sig_idx2){
+	int32_t cmp_val = sig_idx1.qc_sig->chrname.compare(sig_idx2.qc_sig->chrname);
+	if(cmp_val!=0) return cmp_val<0;
+	return sig_idx1.qc_sig->ref_pos<sig_idx2.qc_sig->ref_pos;
+}
+
+// get the first indexed signature not before the position of the chromosome
+static size_t getFirstQcSigPosIdx(vector<qcSigPosIdx_t> &sig_idx_vec, string &chrname, int64_t ref_pos){
+	size_t low = 0, high = sig_idx_vec.size(), mid;
+	int32_t cmp_val;
+
+	while(low<high){
+		mid = (low + high) / 2;
+		cmp_val = sig_idx_vec.at(mid).qc_sig->chrname.compare(chrname);
+		if(cmp_val<0 or (cmp_val==0 and sig_idx_vec.at(mid).qc_sig->ref_pos<ref_pos)) low = mid + 1;
+		else high = mid;
+	}
+	return low;
+}
+
+// match flags of all signature pairs, (rowsNum-1)*(colsNum-1) items: the signatures of the seed are indexed by
+// position, and only the pairs within the matching distance on the same chromosome are checked, as both the
+// indels and the clippings cannot match beyond it
+int8_t* clipRegCluster::computeQcSigMatchArrClipReg(qcSigList_t *queryCluSig, qcSigList_t *seed_qcQuery, int64_t max_dist_match_clip_pos){
+	int8_t *match_arr;
+	vector<qcSigPosIdx_t> sig_idx_vec;
+	qcSigPosIdx_t sig_idx;
+	qcSig_t *qc_sig;
+	size_t i, k, rows = queryCluSig->qcSig_vec.size(), cols = seed_qcQuery->qcSig_vec.size();
+
+	match_arr = (int8_t*) calloc(rows * cols + 1, sizeof(int8_t));
+	if(match_arr==NULL){
+		cerr << __func__ << ", line=" << __LINE__ << ", rows=" << rows << ", cols=" << cols << ", cannot allocate memory, error!" << endl;
+		exit(1);
+	}
+
+	for(k=0; k<cols; k++){
+		sig_idx.qc_sig = seed_qcQuery->qcSig_vec.at(k);
+		sig_idx.sig_idx = k;
+		sig_idx_vec.push_back(sig_idx);
+	}
+	sort(sig_idx_vec.begin(), sig_idx_vec.end(), isQcSigPosIdxLess);
+
+	for(i=0; i<rows; i++){
+		qc_sig = queryCluSig->qcSig_vec.at(i);
+		for(k=getFirstQcSigPosIdx(sig_idx_vec, qc_sig->chrname, qc_sig->ref_pos-max_dist_match_clip_pos); k<cols; k++){
+			if(sig_idx_vec.at(k).qc_sig->chrname.compare(qc_sig->chrname)!=0 or sig_idx_vec.at(k).qc_sig->ref_pos>qc_sig->ref_pos+max_dist_match_clip_pos) break;
+			match_arr[i*cols+sig_idx_vec.at(k).sig_idx] = isQcSigMatchClipReg(qc_sig, sig_idx_vec.at(k).qc_sig, max_dist_match_clip_pos, MIN_SIZE_RATIO_MATCH_CLIP_POS, QC_SIZE_RATIO_MATCH_THRES_INDEL, min_identity_match);
+		}
+	}
+
+	return match_arr;
+}
+
 bool clipRegCluster::isQcSigMatchClipReg(qcSig_t *qc_sig, qcSig_t *seed_qc_sig, int64_t max_dist_match_clip_pos, double min_size_ratio_match_thres_clip, double size_ratio_match_thres, double identity_ratio_match_thres){
 	bool match_flag = false;
 	double size_ratio;
@@ -16,6 +16,12 @@ using namespace std;
 #define QC_IDENTITY_RATIO_MATCH_THRES		(0.9f)
 #define QC_IDENTITY_RATIO_MATCH_THRES2		(0.75f)
 
+// signature indexed by chromosome and reference position, to find the candidate pairs within the matching distance
+typedef struct{
+	qcSig_t *qc_sig;
+	int32_t sig_idx;	// index in the signature vector
+}qcSigPosIdx_t;
+
 class clipRegCluster {
 private:
 	string chrname, technology;
@@ -44,6 +50,7 @@ private:
 	struct seedQueryInfo* chooseSeedClusterQueryClipReg(qcSigList_t* qcSigList_node, vector<qcSigList_t*> &q_cluster);
 	double computeMatchRatioClipReg(qcSigList_t* query_seq_info_node, qcSigList_t* q_cluster_node, int64_t startSpanPos, int64_t endSpanPos);
 	vector<int8_t> computeQcMatchProfileSingleQueryClipReg(qcSigList_t *queryCluSig, qcSigList_t *seed_qcQuery);
+	int8_t* computeQcSigMatchArrClipReg(qcSigList_t *queryCluSig, qcSigList_t *seed_qcQuery, int64_t max_dist_match_clip_pos);
 	bool isQcSigMatchClipReg(qcSig_t *qc_sig, qcSig_t *seed_qc_sig, int64_t max_dist_match_clip_pos, double min_size_ratio_match_thres_clip, double size_ratio_match_thres, double identity_ratio_match_thres);
 	vector<int8_t> qComputeSigMatchProfileClipReg(struct alnScoreNode *scoreArr, int32_t rowsNum, int32_t colsNum, qcSigList_t *queryCluSig, qcSigList_t *seed_qcQuery);
 };
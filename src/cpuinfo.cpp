@@ -0,0 +1,143 @@
+#include "cpuinfo.h"
+
+// CPU budget shared by the worker threads and the external jobs launched by them:
+// a worker running an external job passes its own CPU to the job, and the job gets the
+// fair share of the budget among the active workers, which grows when the work queue drains
+int32_t cpu_total = CPU_JOB_MAX_THREADS_DEFAULT;	// total CPU tokens of the stage
+int32_t cpu_used = 0;				// CPU tokens held by the running external jobs
+int32_t cpu_job_num = 0;			// running external jobs
+int32_t cpu_worker_num = 1;			// concurrent workers of the stage
+int64_t cpu_work_remain = 0;		// unfinished works of the stage
+int32_t cpu_job_max_threads = CPU_JOB_MAX_THREADS_DEFAULT;
+
+pthread_mutex_t mutex_cpu = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t cond_cpu = PTHREAD_COND_INITIALIZER;
+
+int64_t cpu_next_ticket = 0, cpu_serving_ticket = 0;
+cpuTokenStat_t cpu_token_stat;
+
+// get the number of CPUs available to this process, limited by the affinity mask and the cgroup-v2 cpu.max
+int32_t getAvailCpuNum(){
+	cpu_set_t cpu_set;
+	int32_t cpu_num, cg_cpu_num;
+	int64_t cg_quota, cg_period;
+	string cgroup_dir, line;
+	FILE *fp;
+	char buf[256];
+
+	cpu_num = sysconf(_SC_NPROCESSORS_ONLN);
+	CPU_ZERO(&cpu_set);
+	if(sched_getaffinity(0, sizeof(cpu_set), &cpu_set)==0 and CPU_COUNT(&cpu_set)>0) cpu_num = CPU_COUNT(&cpu_set);
+
+	// cpu.max: "$QUOTA $PERIOD", or "max $PERIOD" for no limit
+	cgroup_dir = getCgroupV2Dir();
+	if(cgroup_dir.size()>0){
+		fp = fopen((cgroup_dir + "/cpu.max").c_str(), "r");
+		if(fp){
+			if(fgets(buf, sizeof(buf), fp) and strncmp(buf, "max", 3)!=0){
+				cg_quota = cg_period = 0;
+				if(sscanf(buf, "%ld %ld", &cg_quota, &cg_period)==2 and cg_quota>0 and cg_period>0){
+					cg_cpu_num = (cg_quota + cg_period - 1) / cg_period;
+					if(cg_cpu_num<cpu_num) cpu_num = cg_cpu_num;
+				}
+			}
+			fclose(fp);
+		}
+	}
+	if(cpu_num<1) cpu_num = 1;
+
+	return cpu_num;
+}
+
+// initialize the CPU tokens for a stage having 'num_work' works processed by 'num_workers' concurrent workers
+void initCpuTokens(int32_t cpu_budget, int32_t num_workers, size_t num_work, int32_t max_job_threads){
+	int32_t cpu_num = getAvailCpuNum();
+
+	pthread_mutex_lock(&mutex_cpu);
+	cpu_total = (cpu_budget>0 and cpu_budget<cpu_num) ? cpu_budget : cpu_num;
+	cpu_worker_num = (num_workers>0) ? num_workers : 1;
+	cpu_work_remain = num_work;
+	cpu_job_max_threads = (max_job_threads>0) ? max_job_threads : CPU_JOB_MAX_THREADS_DEFAULT;
+	cpu_token_stat = (cpuTokenStat_t){0, 0, 0, 0, 0};
+	pthread_mutex_unlock(&mutex_cpu);
+}
+
+// get the CPU tokens which can be granted to a new external job, the mutex_cpu should be held by the caller
+static int32_t getGrantableCpuTokens(){
+	int32_t active_workers, idle_workers, cpu_free, fair_share, tokens;
+
+	// the workers not running external jobs keep one CPU each
+	active_workers = (cpu_work_remain<cpu_worker_num) ? cpu_work_remain : cpu_worker_num;
+	if(active_workers<cpu_job_num+1) active_workers = cpu_job_num + 1;
+	idle_workers = active_workers - cpu_job_num - 1;
+	cpu_free = cpu_total - cpu_used - idle_workers;
+
+	fair_share = cpu_total / active_workers;
+	if(fair_share<1) fair_share = 1;
+
+	tokens = (fair_share<cpu_free) ? fair_share : cpu_free;
+	if(tokens>cpu_job_max_threads) tokens = cpu_job_max_threads;
+	if(tokens<1 and cpu_job_num==0) tokens = 1;  // always admit a single job to avoid deadlock
+
+	return tokens;
+}
+
+// acquire CPU tokens for an external job, and block on cond_cpu until at least one token is available;
+// the return value is the thread number of the job
+int32_t acquireCpuTokens(){
+	int64_t ticket;
+	int32_t tokens;
+
+	pthread_mutex_lock(&mutex_cpu);
+	ticket = cpu_next_ticket ++;
+	tokens = getGrantableCpuTokens();
+	if(ticket!=cpu_serving_ticket or tokens<1){
+		cpu_token_stat.wait_num ++;
+		while(ticket!=cpu_serving_ticket or (tokens=getGrantableCpuTokens())<1) pthread_cond_wait(&cond_cpu, &mutex_cpu);
+	}
+	cpu_serving_ticket ++;
+	cpu_used += tokens;
+	cpu_job_num ++;
+
+	cpu_token_stat.grant_num ++;
+	cpu_token_stat.token_sum += tokens;
+	if(cpu_token_stat.min_grant==0 or cpu_token_stat.min_grant>tokens) cpu_token_stat.min_grant = tokens;
+	if(cpu_token_stat.max_grant<tokens) cpu_token_stat.max_grant = tokens;
+	pthread_cond_broadcast(&cond_cpu);  // the next ticket may be admitted
+	pthread_mutex_unlock(&mutex_cpu);
+
+	return tokens;
+}
+
+// release the CPU tokens of a finished external job
+void releaseCpuTokens(int32_t cpu_tokens){
+	pthread_mutex_lock(&mutex_cpu);
+	cpu_used -= cpu_tokens;
+	cpu_job_num --;
+	if(cpu_used<0 or cpu_job_num<0){
+		cerr << "line=" << __LINE__ << ", cpu_used=" << cpu_used << ", cpu_job_num=" << cpu_job_num << ", error." << endl;
+		exit(1);
+	}
+	pthread_cond_broadcast(&cond_cpu);
+	pthread_mutex_unlock(&mutex_cpu);
+}
+
+// a work of the stage is finished, then the later external jobs may get more tokens
+void finishCpuTokenWork(){
+	pthread_mutex_lock(&mutex_cpu);
+	if(cpu_work_remain>0) cpu_work_remain --;
+	pthread_cond_broadcast(&cond_cpu);
+	pthread_mutex_unlock(&mutex_cpu);
+}
+
+// print the CPU tokens granted to the external jobs
+void printCpuTokenStat(const char *stage_name){
+	double mean_grant;
+
+	pthread_mutex_lock(&mutex_cpu);
+	if(cpu_token_stat.grant_num>0){
+		mean_grant = (double)cpu_token_stat.token_sum / cpu_token_stat.grant_num;
+		cout << "CPU tokens of external jobs in " << stage_name << ": budget=" << cpu_total << ", jobs=" << cpu_token_stat.grant_num << ", blocked=" << cpu_token_stat.wait_num << ", threads per job=" << mean_grant << " (min " << cpu_token_stat.min_grant << ", max " << cpu_token_stat.max_grant << ")" << endl;
+	}
+	pthread_mutex_unlock(&mutex_cpu);
+}
@@ -0,0 +1,29 @@
+#ifndef SRC_CPUINFO_H_
+#define SRC_CPUINFO_H_
+
+#include <iostream>
+#include <string>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+#include "meminfo.h"
+
+using namespace std;
+
+#define CPU_JOB_MAX_THREADS_DEFAULT		8		// maximal threads of an external consensus job if not limited by user
+
+// statistics of the CPU tokens granted to the external jobs
+typedef struct{
+	int64_t grant_num, wait_num, token_sum;
+	int32_t min_grant, max_grant;
+}cpuTokenStat_t;
+
+int32_t getAvailCpuNum();
+void initCpuTokens(int32_t cpu_budget, int32_t num_workers, size_t num_work, int32_t max_job_threads);
+int32_t acquireCpuTokens();
+void releaseCpuTokens(int32_t cpu_tokens);
+void finishCpuTokenWork();
+void printCpuTokenStat(const char *stage_name);
+
+#endif /* SRC_CPUINFO_H_ */
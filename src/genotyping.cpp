@@ -19,11 +19,21 @@ genotyping::genotyping(reg_t *reg, faidx_t *fai, string &inBamFile, int32_t sig_
 	this->minMapQ = minMapQ;
 	this->minHighMapQ = minHighMapQ;
 	this->max_ultra_high_cov = max_ultra_high_cov;
+	sig_startPos = sig_endPos = -1;
+	own_dp_scratch.score_arr = NULL;
+	own_dp_scratch.arr_size = 0;
+	dp_scratch = &own_dp_scratch;
 }
 
 genotyping::~genotyping(){
 	destroyQueryGtSigVec(queryGtSig_vec);
 	destroyMatchProfilePatVec(match_profile_pat_vec);
+	destroyGtDpScratch(&own_dp_scratch);
+}
+
+// use the DP scratch buffer shared by the alleles of a work
+void genotyping::setDpScratch(gtDpScratch_t *dp_scratch){
+	this->dp_scratch = dp_scratch;
 }
 
 // free match profile pattern memory
@@ -39,11 +49,18 @@ void genotyping::computeGenotype(){
 	alnDataLoader data_loader(reg->chrname, reg->startRefPos, reg->endRefPos, inBamFile, minMapQ, minHighMapQ);
 	data_loader.loadAlnData(alnDataVector, max_ultra_high_cov);
 
-	filterInvalidAlnData(alnDataVector, valid_summed_size_ratio_read);
+	filterInvalidAlnData(alnDataVector, valid_summed_size_ratio_read, true);
 
 	// extract genotyping signatures
 	queryGtSig_vec = extractGtSigVec();
 
+	computeGenotypeFromGtSigs();
+
+	data_loader.freeAlnData(alnDataVector);
+}
+
+// compute genotype from the extracted signatures of the queries
+void genotyping::computeGenotypeFromGtSigs(){
 	// matching
 	gtSigMatch(queryGtSig_vec);
 
@@ -62,44 +79,62 @@ void genotyping::computeGenotype(){
 	// recover variants
 	if(queryGtSig_vec.size()>(size_t)min_sup_num_recover)
 		recoverVariants(reg, match_profile_pat_vec, seed_gtQuery, queryGtSig_vec, validGtSigFlagVec);
+}
 
-	data_loader.freeAlnData(alnDataVector);
+// compute the region of the extracted signatures: the variant region extended by the clipping match distance
+void genotyping::computeGtSigRegion(int64_t chrlen){
+	sig_startPos = reg->startRefPos - clip_extend_match_thres;
+	sig_endPos = reg->endRefPos + clip_extend_match_thres;
+	if(sig_startPos<1) sig_startPos = 1;
+	if(sig_endPos>chrlen) sig_endPos = chrlen;
 }
 
-// filter invalid short reads
-void genotyping::filterInvalidAlnData(vector<bam1_t*> &alnDataVector, double valid_summed_size_ratio_read){
-	bam1_t *b, *b2;
-	string queryname, queryname2;
-	int64_t aln_size, querylen;
-	double len_ratio;
-	vector<bam1_t*> query_aln_segs;
+// add the genotyping signatures of a query from its align segments
+void genotyping::addQueryGtSig(bam1_t *b, vector<struct alnSeg*> &alnSegs, string &refseq){
+	queryGtSig_t *queryGtSig;
 
-	for(size_t i=0; i<alnDataVector.size(); ){
-		b = alnDataVector.at(i);
-		queryname = bam_get_qname(b);
+	queryGtSig = new queryGtSig_t();
+	queryGtSig->group_id = -1;
+	//queryGtSig->score = -1;
+	queryGtSig->seed_flag = false;
+	queryGtSig->queryname = bam_get_qname(b);
+	queryGtSig->gtSig_vec = extractGtSigsFromAlnSegsSingleQuery(alnSegs, sig_startPos, sig_endPos, refseq, sig_size_thres, clip_size_thres);
+	queryGtSig_vec.push_back(queryGtSig);
+}
 
-		query_aln_segs = getQueryAlnSegs(alnDataVector, queryname);
-		aln_size = getAlnSizeSingleQuery(query_aln_segs);
-		querylen = getOriginalQueryLen(b);
-		len_ratio = (double)aln_size / querylen;
+// filter invalid short reads: the summed align sizes of all queries are computed in one pass,
+// and the segments of the queries with low ratio of the summed align size are removed, and also destroyed if destroy_flag is true
+void genotyping::filterInvalidAlnData(vector<bam1_t*> &alnDataVector, double valid_summed_size_ratio_read, bool destroy_flag){
+	bam1_t *b;
+	string queryname;
+	int64_t querylen;
+	double len_ratio;
+	size_t i, valid_num;
+	map<string, int64_t> aln_size_map;		// summed align size of each query
+	map<string, bool> valid_flag_map;		// decided by the first segment of each query
+	map<string, bool>::iterator flag_it;
 
-		if(len_ratio<valid_summed_size_ratio_read){ // invalid segments, then delete them
+	for(i=0; i<alnDataVector.size(); i++){
+		b = alnDataVector.at(i);
+		aln_size_map[bam_get_qname(b)] += getAlnSizeSingleSeg(b).at(0);
+	}
 
-			//cout << "--------- deleted [" << i << "], queryname=" << queryname << ", querylen=" << querylen << ", align_size=" << aln_size << ", len_ratio=" << len_ratio << ", start_pos=" << start_pos << ", end_pos=" << end_pos << endl;
+	valid_num = 0;
+	for(i=0; i<alnDataVector.size(); i++){
+		b = alnDataVector.at(i);
+		queryname = bam_get_qname(b);
 
-			for(size_t j=i; j<alnDataVector.size(); ){
-				b2 = alnDataVector.at(j);
-				queryname2 = bam_get_qname(b2);
-				if(queryname.compare(queryname2)==0){
-					bam_destroy1(b2);
-					alnDataVector.erase(alnDataVector.begin()+j);
-				}else j++;
-			}
-		}else{
-			//cout << "[" << i << "], queryname=" << queryname << ", querylen=" << querylen << ", align_size=" << aln_size << ", len_ratio=" << len_ratio << ", start_pos=" << start_pos << ", end_pos=" << end_pos << endl;
-			i++;
+		flag_it = valid_flag_map.find(queryname);
+		if(flag_it==valid_flag_map.end()){
+			querylen = getOriginalQueryLen(b);
+			len_ratio = (double)aln_size_map[queryname] / querylen;
+			flag_it = valid_flag_map.insert(make_pair(queryname, len_ratio>=valid_summed_size_ratio_read)).first;
 		}
+
+		if(flag_it->second) alnDataVector.at(valid_num++) = b;
+		else if(destroy_flag) bam_destroy1(b); // invalid segments, then delete them
 	}
+	alnDataVector.resize(valid_num);
 }
 
 vector<bam1_t*> genotyping::getQueryAlnSegs(vector<bam1_t*> &alnDataVector, string &queryname){
@@ -167,25 +202,17 @@ vector<int32_t> genotyping::getAlnSizeSingleSeg(bam1_t *b){
 // extract CIGAR signatures
 vector<queryGtSig_t*> genotyping::extractGtSigVec(){
 	bam1_t *b;
-	queryGtSig_t *queryGtSig;
-	vector<gtSig_t*> sigVec_singleQuery;
 	vector<struct alnSeg*> alnSegs;
 	int32_t bam_type, seq_len;
-	int64_t startPos, endPos, chrlen_tmp;
+	int64_t chrlen_tmp;
 	string refseq, reg_str;
 	char *seq;
 
 	if(alnDataVector.size()>0){
 		chrlen_tmp = faidx_seq_len(fai, reg->chrname.c_str()); // get the reference length
+		computeGtSigRegion(chrlen_tmp);
 
-	//	startPos = reg->startRefPos - VAR_ALN_EXTEND_SIZE;
-	//	endPos = reg->endRefPos + VAR_ALN_EXTEND_SIZE;
-		startPos = reg->startRefPos - clip_extend_match_thres;
-		endPos = reg->endRefPos + clip_extend_match_thres;
-		if(startPos<1) startPos = 1;
-		if(endPos>chrlen_tmp) endPos = chrlen_tmp;
-
-		reg_str = reg->chrname + ":" + to_string(startPos) + "-" + to_string(endPos);
+		reg_str = reg->chrname + ":" + to_string(sig_startPos) + "-" + to_string(sig_endPos);
 		pthread_mutex_lock(&mutex_fai);
 		seq = fai_fetch(fai, reg_str.c_str(), &seq_len);
 		pthread_mutex_unlock(&mutex_fai);
@@ -202,30 +229,8 @@ vector<queryGtSig_t*> genotyping::extractGtSigVec(){
 			b = alnDataVector.at(i);
 
 			if(!(b->core.flag & BAM_FUNMAP)){ // aligned
-				switch(bam_type){
-					case BAM_CIGAR_NO_DIFF_MD:
-						//alnSegs = generateAlnSegs(b);
-						alnSegs = generateAlnSegs2(b, startPos, endPos);
-						break;
-					case BAM_CIGAR_NO_DIFF_NO_MD:
-					case BAM_CIGAR_DIFF_MD:
-					case BAM_CIGAR_DIFF_NO_MD:
-						//alnSegs = generateAlnSegs_no_MD(b, refseq, startPos, endPos);
-						alnSegs = generateAlnSegs_no_MD2(b, refseq, startPos, endPos);
-						break;
-					default:
-						cerr << __func__ << ": unknown bam type, error!" << endl;
-						exit(1);
-				}// generate align segments
-
-				queryGtSig = new queryGtSig_t();
-				queryGtSig->group_id = -1;
-				//queryGtSig->score = -1;
-				queryGtSig->seed_flag = false;
-				queryGtSig->queryname = bam_get_qname(b);
-				queryGtSig->gtSig_vec = extractGtSigsFromAlnSegsSingleQuery(alnSegs, startPos, endPos, refseq, sig_size_thres, clip_size_thres);
-				queryGtSig_vec.push_back(queryGtSig);
-
+				alnSegs = generateGtAlnSegs(b, bam_type, refseq, sig_startPos, sig_endPos);
+				addQueryGtSig(b, alnSegs, refseq);
 				destroyAlnSegs(alnSegs);
 			}
 		}
@@ -472,17 +477,20 @@ vector<int8_t> genotyping::computeGtMatchProfileSingleQuery(queryGtSig_t *queryG
 	rowsNum = queryGtSig->gtSig_vec.size() + 1;
 	colsNum = seed_gtQuery->gtSig_vec.size() + 1;
 
-	arrSize = rowsNum * colsNum;
-	scoreArr = (struct alnScoreNode*) calloc (arrSize, sizeof(struct alnScoreNode));
-	if(scoreArr==NULL){
-		cerr << "line=" << __LINE__ << ", rowsNum=" << rowsNum << ", colsNum=" << colsNum << ", cannot allocate memory, error!" << endl;
-		exit(1);
-	}
+	arrSize = (int64_t)rowsNum * colsNum;
+	scoreArr = getGtDpScoreArr(dp_scratch, arrSize);
 
-	// set the elements of the first row and the first column to be zero
+	// set the elements of the first row and the first column to be zero, the others are all computed below
+	scoreArr[0].score = 0;
 	scoreArr[0].path_val = 0;
-	for(j=1; j<colsNum; j++) scoreArr[j].path_val = 2;
-	for(i=1; i<rowsNum; i++) scoreArr[i*colsNum].path_val = 1;
+	for(j=1; j<colsNum; j++){
+		scoreArr[j].score = 0;
+		scoreArr[j].path_val = 2;
+	}
+	for(i=1; i<rowsNum; i++){
+		scoreArr[i*colsNum].score = 0;
+		scoreArr[i*colsNum].path_val = 1;
+	}
 
 	// compute the scores of each element
 	for(i=1; i<rowsNum; i++){
@@ -1160,3 +1168,181 @@ void genotyping::compareAndUpdateVarReg(reg_t *reg, gtSig_t *target_sig, vector<
 		}
 	}
 }
+
+gtEngine::gtEngine(vector<reg_t*> &reg_vec, faidx_t *fai, string &inBamFile, int32_t sig_size_thres, double size_ratio_match_thres, double min_alle_ratio_thres, double max_alle_ratio_thres, int32_t min_sup_num_recover, int32_t minMapQ, int32_t minHighMapQ, double max_ultra_high_cov){
+	this->reg_vec = reg_vec;
+	this->fai = fai;
+	this->inBamFile = inBamFile;
+	this->sig_size_thres = sig_size_thres;
+	this->size_ratio_match_thres = size_ratio_match_thres;
+	this->min_alle_ratio_thres = min_alle_ratio_thres;
+	this->max_alle_ratio_thres = max_alle_ratio_thres;
+	this->min_sup_num_recover = min_sup_num_recover;
+	this->minMapQ = minMapQ;
+	this->minHighMapQ = minHighMapQ;
+	this->max_ultra_high_cov = max_ultra_high_cov;
+	dp_scratch.score_arr = NULL;
+	dp_scratch.arr_size = 0;
+}
+
+gtEngine::~gtEngine(){
+	destroyGtDpScratch(&dp_scratch);
+}
+
+// compute the genotypes of all the alleles, chromosome by chromosome
+void gtEngine::computeGenotypes(){
+	size_t i, j;
+	genotyping *gt;
+	vector<genotyping*> gt_vec;
+	vector<bool> done_flag_vec(reg_vec.size(), false);
+
+	for(i=0; i<reg_vec.size(); i++){
+		if(done_flag_vec.at(i)) continue;
+
+		for(j=i; j<reg_vec.size(); j++){
+			if(done_flag_vec.at(j)==false and reg_vec.at(j)->chrname.compare(reg_vec.at(i)->chrname)==0){
+				gt = new genotyping(reg_vec.at(j), fai, inBamFile, sig_size_thres, size_ratio_match_thres, min_alle_ratio_thres, max_alle_ratio_thres, min_sup_num_recover, minMapQ, minHighMapQ, max_ultra_high_cov);
+				gt->setDpScratch(&dp_scratch);
+				gt_vec.push_back(gt);
+				done_flag_vec.at(j) = true;
+			}
+		}
+
+		computeGenotypesSingleChr(gt_vec);
+
+		for(j=0; j<gt_vec.size(); j++) delete gt_vec.at(j);
+		gt_vec.clear();
+	}
+}
+
+// compute the genotypes of the alleles on the same chromosome in a single pass over the reads: the reads of
+// all the alleles are loaded once, and each allele selects its reads from them as if they were loaded for it
+// alone, i.e. the down-sampling and the filtering of short reads are computed on the reads overlapping it
+void gtEngine::computeGenotypesSingleChr(vector<genotyping*> &gt_vec){
+	size_t i, j;
+	string chrname, refseq, reg_str;
+	int64_t startRefPos, endRefPos, startPos, endPos, chrlen;
+	int32_t bam_type, seq_len;
+	vector<bam1_t*> alnDataVector;
+	vector<vector<bam1_t*>> gt_aln_vecs;	// reads selected by each allele, in the same order as alnDataVector
+	vector<size_t> gt_aln_idx_vec;
+	vector<struct alnSeg*> alnSegs;
+	genotyping *gt;
+	bam1_t *b;
+	char *seq;
+	bool aln_segs_flag;
+
+	chrname = gt_vec.at(0)->reg->chrname;
+	startRefPos = gt_vec.at(0)->reg->startRefPos;
+	endRefPos = gt_vec.at(0)->reg->endRefPos;
+	for(i=1; i<gt_vec.size(); i++){
+		if(startRefPos>gt_vec.at(i)->reg->startRefPos) startRefPos = gt_vec.at(i)->reg->startRefPos;
+		if(endRefPos<gt_vec.at(i)->reg->endRefPos) endRefPos = gt_vec.at(i)->reg->endRefPos;
+	}
+
+	// load the reads of all the alleles once without down-sampling
+	alnDataLoader data_loader(chrname, startRefPos, endRefPos, inBamFile, minMapQ, minHighMapQ);
+	data_loader.loadAlnData(alnDataVector, 0);
+
+	// select the reads of each allele
+	gt_aln_vecs.resize(gt_vec.size());
+	gt_aln_idx_vec.resize(gt_vec.size(), 0);
+	for(i=0; i<gt_vec.size(); i++){
+		gt = gt_vec.at(i);
+		alnDataLoader gt_data_loader(chrname, gt->reg->startRefPos, gt->reg->endRefPos, inBamFile, minMapQ, minHighMapQ);
+		gt_data_loader.selectAlnData(gt_aln_vecs.at(i), alnDataVector, max_ultra_high_cov);
+		gt->filterInvalidAlnData(gt_aln_vecs.at(i), gt->valid_summed_size_ratio_read, false);
+	}
+
+	if(alnDataVector.size()>0){
+		chrlen = faidx_seq_len(fai, chrname.c_str()); // get the reference length
+		startPos = endPos = -1;
+		for(i=0; i<gt_vec.size(); i++){
+			gt = gt_vec.at(i);
+			gt->computeGtSigRegion(chrlen);
+			if(startPos<0 or startPos>gt->sig_startPos) startPos = gt->sig_startPos;
+			if(endPos<gt->sig_endPos) endPos = gt->sig_endPos;
+		}
+
+		reg_str = chrname + ":" + to_string(startPos) + "-" + to_string(endPos);
+		pthread_mutex_lock(&mutex_fai);
+		seq = fai_fetch(fai, reg_str.c_str(), &seq_len);
+		pthread_mutex_unlock(&mutex_fai);
+		refseq = seq;
+		free(seq);
+
+		bam_type = getBamType(alnDataVector);
+		if(bam_type==BAM_INVALID){
+			cerr << __func__ << ": unknown bam type, error!" << endl;
+			exit(1);
+		}
+
+		// each read is assigned to the alleles having selected it, and its align segments are generated once
+		for(i=0; i<alnDataVector.size(); i++){
+			b = alnDataVector.at(i);
+			aln_segs_flag = false;
+			for(j=0; j<gt_vec.size(); j++){
+				if(gt_aln_idx_vec.at(j)<gt_aln_vecs.at(j).size() and gt_aln_vecs.at(j).at(gt_aln_idx_vec.at(j))==b){
+					gt_aln_idx_vec.at(j) ++;
+					if(b->core.flag & BAM_FUNMAP) continue; // unaligned
+					if(aln_segs_flag==false){
+						alnSegs = generateGtAlnSegs(b, bam_type, refseq, startPos, endPos);
+						aln_segs_flag = true;
+					}
+					gt_vec.at(j)->addQueryGtSig(b, alnSegs, refseq);
+				}
+			}
+			if(aln_segs_flag) destroyAlnSegs(alnSegs);
+		}
+	}
+
+	for(i=0; i<gt_vec.size(); i++) gt_vec.at(i)->computeGenotypeFromGtSigs();
+
+	data_loader.freeAlnData(alnDataVector);
+}
+
+// get the score matrix of at least 'arr_size' elements from the scratch buffer
+struct alnScoreNode *getGtDpScoreArr(gtDpScratch_t *dp_scratch, int64_t arr_size){
+	struct alnScoreNode *score_arr;
+
+	if(arr_size>dp_scratch->arr_size){
+		score_arr = (struct alnScoreNode*) realloc(dp_scratch->score_arr, arr_size * sizeof(struct alnScoreNode));
+		if(score_arr==NULL){
+			cerr << __func__ << ", line=" << __LINE__ << ", arr_size=" << arr_size << ", cannot allocate memory, error!" << endl;
+			exit(1);
+		}
+		dp_scratch->score_arr = score_arr;
+		dp_scratch->arr_size = arr_size;
+	}
+
+	return dp_scratch->score_arr;
+}
+
+void destroyGtDpScratch(gtDpScratch_t *dp_scratch){
+	if(dp_scratch->score_arr) free(dp_scratch->score_arr);
+	dp_scratch->score_arr = NULL;
+	dp_scratch->arr_size = 0;
+}
+
+// generate the align segments of a read in the region for genotyping
+vector<struct alnSeg*> generateGtAlnSegs(bam1_t *b, int32_t bam_type, string &refseq, int64_t startPos, int64_t endPos){
+	vector<struct alnSeg*> alnSegs;
+
+	switch(bam_type){
+		case BAM_CIGAR_NO_DIFF_MD:
+			//alnSegs = generateAlnSegs(b);
+			alnSegs = generateAlnSegs2(b, startPos, endPos);
+			break;
+		case BAM_CIGAR_NO_DIFF_NO_MD:
+		case BAM_CIGAR_DIFF_MD:
+		case BAM_CIGAR_DIFF_NO_MD:
+			//alnSegs = generateAlnSegs_no_MD(b, refseq, startPos, endPos);
+			alnSegs = generateAlnSegs_no_MD2(b, refseq, startPos, endPos);
+			break;
+		default:
+			cerr << __func__ << ": unknown bam type, error!" << endl;
+			exit(1);
+	}
+
+	return alnSegs;
+}
@@ -5,6 +5,7 @@
 #include <cstring>
 #include <vector>
 #include <algorithm>
+#include <map>
 #include <htslib/faidx.h>
 
 #include "structures.h"
@@ -37,6 +38,12 @@ using namespace std;
 
 #define GT_STR_DEFAULT						"GT:AD:DP\t./.:.,.:."
 
+// score matrix of the signature matching, grown on demand and reused by all the queries and alleles of a work
+typedef struct{
+	struct alnScoreNode *score_arr;
+	int64_t arr_size;
+}gtDpScratch_t;
+
 
 class genotyping{
 	public:
@@ -53,12 +60,19 @@ class genotyping{
 		vector<queryGtSig_t*> queryGtSig_vec;
 		vector<profile_pat_t*> match_profile_pat_vec;
 
+		int64_t sig_startPos, sig_endPos;	// region of the extracted signatures
+		gtDpScratch_t *dp_scratch, own_dp_scratch;
+
 	public:
 		genotyping(reg_t *reg, faidx_t *fai, string &inBamFile, int32_t sig_size_thres, double size_ratio_match_thres, double min_alle_ratio_thres, double max_alle_ratio_thres, int32_t min_sup_num_recover, int32_t minMapQ, int32_t minHighMapQ, double max_ultra_high_cov);
 		virtual ~genotyping();
 		void destroyMatchProfilePatVec(vector<profile_pat_t*> &match_profile_pat_vec);
 		void computeGenotype();
-		void filterInvalidAlnData(vector<bam1_t*> &alnDataVector, double valid_summed_size_ratio_read);
+		void setDpScratch(gtDpScratch_t *dp_scratch);
+		void computeGtSigRegion(int64_t chrlen);
+		void addQueryGtSig(bam1_t *b, vector<struct alnSeg*> &alnSegs, string &refseq);
+		void computeGenotypeFromGtSigs();
+		void filterInvalidAlnData(vector<bam1_t*> &alnDataVector, double valid_summed_size_ratio_read, bool destroy_flag);
 		vector<bam1_t*> getQueryAlnSegs(vector<bam1_t*> &alnDataVector, string &queryname);
 		int32_t getAlnSizeSingleQuery(vector<bam1_t*> &query_aln_segs);
 		vector<int32_t> getAlnSizeSingleSeg(bam1_t *b);
@@ -85,4 +99,29 @@ class genotyping{
 		void compareAndUpdateVarReg(reg_t *reg, gtSig_t *target_sig, vector<int64_t> &aver_pos_vec);
 };
 
+// genotyping of all the alleles of a call work: the reads of the alleles on each chromosome are loaded once,
+// each read is converted to the align segments once and assigned to the overlapped alleles in a single pass,
+// and the DP scratch buffer is shared by the alleles
+class gtEngine{
+	public:
+		vector<reg_t*> reg_vec;
+		faidx_t *fai;
+		string inBamFile;
+		int32_t sig_size_thres, min_sup_num_recover, minMapQ, minHighMapQ;
+		double size_ratio_match_thres, min_alle_ratio_thres, max_alle_ratio_thres, max_ultra_high_cov;
+		gtDpScratch_t dp_scratch;
+
+	public:
+		gtEngine(vector<reg_t*> &reg_vec, faidx_t *fai, string &inBamFile, int32_t sig_size_thres, double size_ratio_match_thres, double min_alle_ratio_thres, double max_alle_ratio_thres, int32_t min_sup_num_recover, int32_t minMapQ, int32_t minHighMapQ, double max_ultra_high_cov);
+		virtual ~gtEngine();
+		void computeGenotypes();
+
+	private:
+		void computeGenotypesSingleChr(vector<genotyping*> &gt_vec);
+};
+
+struct alnScoreNode *getGtDpScoreArr(gtDpScratch_t *dp_scratch, int64_t arr_size);
+void destroyGtDpScratch(gtDpScratch_t *dp_scratch);
+vector<struct alnSeg*> generateGtAlnSegs(bam1_t *b, int32_t bam_type, string &refseq, int64_t startPos, int64_t endPos);
+
 #endif /* SRC_GENOTYPING_H_ */
@@ -3,73 +3,209 @@
 int max(int a, int b, int c) {
     return max(a, max(b, c));
 }
+// columns of the row in the band around the slanted diagonal, the band covers the full row if band_width>=colsNum
+static inline void getNwBandRange(int32_t i, int32_t rowsNum, int32_t colsNum, int32_t band_width, int32_t &lo, int32_t &hi) {
+    int32_t center = (rowsNum > 0) ? (int64_t)i * colsNum / rowsNum : 0;
+    lo = (center - band_width > 0) ? center - band_width : 0;
+    hi = (center + band_width < colsNum) ? center + band_width : colsNum;
+}
+
+// global alignment with traceback: the scores are kept in two rows, and the traceback directions
+// in a 2-bit matrix; the full matrix is used unless its directions exceed NW_MAX_DIR_MATRIX_BYTES,
+// then only the band around the diagonal fitting into the ceiling is computed;
+// the aligned sequences are appended and then reversed
 void needleman_wunschOp(const string& seq1, const string& seq2, int32_t match_score, int32_t mismatch_score, int32_t gap_penalty, string& seq1_new, string& seq2_new) {
-    int64_t rowsNum = seq1.size() + 1, colsNum = seq2.size() + 1, arrSize;
-    int32_t i, j, * score_matrix;
-    int32_t score, diag_score, up_score;
-
-    // Initialize the score matrix
-    arrSize = rowsNum * colsNum;
-    score_matrix = (int32_t*)calloc(arrSize, sizeof(int32_t));
-    if (score_matrix == NULL) {
-        cerr << "line=" << __LINE__ << ", rowsNum=" << rowsNum << ", colsNum=" << colsNum << ", cannot allocate memory, error!" << endl;
+    int32_t rowsNum = seq1.size(), colsNum = seq2.size(), i, j, lo, hi, prev_lo, prev_hi, band_width, row_size;
+    int32_t *prev_row, *cur_row, *tmp_row;
+    int32_t score, match, delete_gap, insert_gap, dir;
+    int64_t idx;
+    uint8_t *dir_matrix;
+    string aln_seq1, aln_seq2;
+
+    band_width = colsNum;
+    if (rowsNum > 0 and (int64_t)(rowsNum + 1) * (colsNum + 1) > NW_MAX_DIR_MATRIX_BYTES * 4) {
+        band_width = (NW_MAX_DIR_MATRIX_BYTES * 4 / (rowsNum + 1) - 1) / 2;
+        if (band_width < colsNum / rowsNum + 1) band_width = colsNum / rowsNum + 1;  // keep the band connected
+    }
+    row_size = (2 * (int64_t)band_width < colsNum) ? 2 * band_width + 1 : colsNum + 1;
+
+    prev_row = (int32_t*)malloc((colsNum + 1) * sizeof(int32_t));
+    cur_row = (int32_t*)malloc((colsNum + 1) * sizeof(int32_t));
+    dir_matrix = (uint8_t*)calloc(((int64_t)(rowsNum + 1) * row_size + 3) / 4, sizeof(uint8_t));
+    if (prev_row == NULL or cur_row == NULL or dir_matrix == NULL) {
+        cerr << "line=" << __LINE__ << ", rowsNum=" << rowsNum << ", colsNum=" << colsNum << ", band_width=" << band_width << ", cannot allocate memory, error!" << endl;
         exit(1);
     }
 
-    // Initialize the first row and first column
-    for (i = 1; i < rowsNum; i++) score_matrix[i * colsNum] = score_matrix[(i - 1) * colsNum] + gap_penalty;
-    for (j = 1; j < colsNum; j++) score_matrix[j] = score_matrix[j - 1] + gap_penalty;
-
-    // Fill in the rest of the score matrix
-    int32_t match, delete_gap, insert_gap;
-    for (i = 1; i < rowsNum; i++) {
-        for (j = 1; j < colsNum; j++) {
-            match = score_matrix[(i - 1) * colsNum + j - 1] + (seq1[i - 1] == seq2[j - 1] ? match_score : mismatch_score);
-            delete_gap = score_matrix[(i - 1) * colsNum + j] + gap_penalty;
-            insert_gap = score_matrix[i * colsNum + j - 1] + gap_penalty;
-            score_matrix[i * colsNum + j] = max(match, delete_gap, insert_gap);
+    // the first row is gaps
+    getNwBandRange(0, rowsNum, colsNum, band_width, prev_lo, prev_hi);
+    prev_row[0] = 0;
+    for (j = 1; j <= prev_hi; j++) {
+        prev_row[j] = prev_row[j - 1] + gap_penalty;
+        dir_matrix[j >> 2] |= NW_DIR_LEFT << ((j & 3) << 1);
+    }
+
+    // fill in the rest of the rows, the direction is chosen in the same order as the traceback: diagonal, up, left
+    for (i = 1; i <= rowsNum; i++) {
+        getNwBandRange(i, rowsNum, colsNum, band_width, lo, hi);
+        for (j = lo; j <= hi; j++) {
+            match = (j > 0 and j - 1 >= prev_lo and j - 1 <= prev_hi) ? prev_row[j - 1] + (seq1[i - 1] == seq2[j - 1] ? match_score : mismatch_score) : NW_NEG_INF;
+            delete_gap = (j >= prev_lo and j <= prev_hi) ? prev_row[j] + gap_penalty : NW_NEG_INF;
+            insert_gap = (j > lo) ? cur_row[j - 1] + gap_penalty : NW_NEG_INF;
+            score = max(match, delete_gap, insert_gap);
+            cur_row[j] = score;
+
+            if (j > 0 and score == match) dir = NW_DIR_DIAG;
+            else if (score == delete_gap) dir = NW_DIR_UP;
+            else dir = NW_DIR_LEFT;
+            idx = (int64_t)i * row_size + j - lo;
+            dir_matrix[idx >> 2] |= dir << ((idx & 3) << 1);
         }
+        tmp_row = prev_row; prev_row = cur_row; cur_row = tmp_row;
+        prev_lo = lo;
+        prev_hi = hi;
     }
 
-    // Traceback to find the alignment
-    i = rowsNum - 1, j = colsNum - 1;
-    while (i > 0 && j > 0) {
-        score = score_matrix[i * colsNum + j];
-        diag_score = score_matrix[(i - 1) * colsNum + j - 1];
-        //left_score = score_matrix[i*colsNum+j-1];
-        up_score = score_matrix[(i - 1) * colsNum + j];
-
-        if (score == diag_score + (seq1[i - 1] == seq2[j - 1] ? match_score : mismatch_score)) {
-            seq1_new = seq1[i - 1] + seq1_new;
-            seq2_new = seq2[j - 1] + seq2_new;
+    // traceback to find the alignment
+    aln_seq1.reserve(rowsNum + colsNum);
+    aln_seq2.reserve(rowsNum + colsNum);
+    i = rowsNum, j = colsNum;
+    getNwBandRange(i, rowsNum, colsNum, band_width, lo, hi);
+    while (i > 0 or j > 0) {
+        idx = (int64_t)i * row_size + j - lo;
+        dir = (dir_matrix[idx >> 2] >> ((idx & 3) << 1)) & 3;
+        if (dir == NW_DIR_DIAG) {
+            aln_seq1.push_back(seq1[i - 1]);
+            aln_seq2.push_back(seq2[j - 1]);
             i--;
             j--;
         }
-        else if (score == up_score + gap_penalty) {
-            seq1_new = seq1[i - 1] + seq1_new;
-            seq2_new = "-" + seq2_new;
+        else if (dir == NW_DIR_UP) {
+            aln_seq1.push_back(seq1[i - 1]);
+            aln_seq2.push_back('-');
             i--;
         }
         else {
-            seq1_new = "-" + seq1_new;
-            seq2_new = seq2[j - 1] + seq2_new;
+            aln_seq1.push_back('-');
+            aln_seq2.push_back(seq2[j - 1]);
             j--;
         }
+        if (dir != NW_DIR_LEFT) getNwBandRange(i, rowsNum, colsNum, band_width, lo, hi);
+    }
+    reverse(aln_seq1.begin(), aln_seq1.end());
+    reverse(aln_seq2.begin(), aln_seq2.end());
+    seq1_new = aln_seq1 + seq1_new;
+    seq2_new = aln_seq2 + seq2_new;
+
+    free(prev_row);
+    free(cur_row);
+    free(dir_matrix);
+}
+
+// extend the alignment path of the cell by one column
+static inline void extendNwIdentityCell(nwIdentityCell_t &cell, const nwIdentityCell_t &pre_cell, int32_t score, bool gap_flag, bool match_flag) {
+    cell = pre_cell;
+    cell.score = score;
+    cell.aln_len ++;
+    if (gap_flag) cell.gap_run ++;
+    else {
+        if (match_flag) cell.match_num ++;
+        if (cell.gap_run >= 3) cell.relief += (cell.gap_run * RELIEF_FACTOR);
+        cell.gap_run = 0;
+    }
+}
+
+// half width of the band of the identity-only alignment: the full matrix is used if band_width<=0,
+// and the band is narrowed to keep the computed cells within NW_MAX_IDENTITY_CELLS
+static int32_t getNwIdentityBandWidth(int32_t rowsNum, int32_t colsNum, int32_t band_width) {
+    if (band_width <= 0 or band_width > colsNum or rowsNum == 0) band_width = colsNum;
+    if (rowsNum > 0 and (int64_t)rowsNum * min(2 * (int64_t)band_width + 1, (int64_t)colsNum + 1) > NW_MAX_IDENTITY_CELLS) band_width = (NW_MAX_IDENTITY_CELLS / rowsNum - 1) / 2;
+    if (rowsNum > 0 and band_width < colsNum / rowsNum + 1) band_width = colsNum / rowsNum + 1;  // keep the band connected
+    return band_width;
+}
+
+// minimal number of gap columns of the global alignment paths through the cell (i, j)
+static inline int64_t getNwMinGapNum(int32_t i, int32_t j, int32_t rowsNum, int32_t colsNum) {
+    return abs(j - i) + abs((colsNum - j) - (rowsNum - i));
+}
+
+// identity of the global alignment without building the aligned sequences: the same path as the
+// traceback of needleman_wunschOp() is followed by keeping its statistics in each cell of two rows;
+// only the cells in the band around the diagonal are computed, see getNwIdentityBandWidth();
+// the band misses the paths with large leading or trailing indels, so unless the banded score beats
+// the best possible score of any path leaving the band, the alignment is redone with a doubled band
+double needleman_wunschIdentity(const string& seq1, const string& seq2, int32_t match_score, int32_t mismatch_score, int32_t gap_penalty, int32_t band_width) {
+    int32_t rowsNum = seq1.size(), colsNum = seq2.size(), i, j, lo, hi, prev_lo, prev_hi, wider_band_width;
+    int32_t match, delete_gap, insert_gap, score;
+    int64_t out_gap_num, out_score_bound, band_score;
+    nwIdentityCell_t *prev_row, *cur_row, *tmp_row, invalid_cell, init_cell;
+    const nwIdentityCell_t *diag_cell, *up_cell, *left_cell;
+    double relief;
+
+    band_width = getNwIdentityBandWidth(rowsNum, colsNum, band_width);
+
+    prev_row = (nwIdentityCell_t*)malloc((colsNum + 1) * sizeof(nwIdentityCell_t));
+    cur_row = (nwIdentityCell_t*)malloc((colsNum + 1) * sizeof(nwIdentityCell_t));
+    if (prev_row == NULL or cur_row == NULL) {
+        cerr << "line=" << __LINE__ << ", colsNum=" << colsNum << ", cannot allocate memory, error!" << endl;
+        exit(1);
     }
+    invalid_cell = (nwIdentityCell_t){NW_NEG_INF, 0, 0, 0, 0};
+    init_cell = (nwIdentityCell_t){0, 0, 0, 0, 0};
+
+    // the first row
+    getNwBandRange(0, rowsNum, colsNum, band_width, prev_lo, prev_hi);
+    prev_row[0] = init_cell;
+    for (j = 1; j <= prev_hi; j++) extendNwIdentityCell(prev_row[j], prev_row[j - 1], prev_row[j - 1].score + gap_penalty, true, false);
+    out_gap_num = LLONG_MAX;  // minimal gap columns of the paths leaving the band
+    if (prev_hi < colsNum) out_gap_num = getNwMinGapNum(0, prev_hi + 1, rowsNum, colsNum);
+
+    for (i = 1; i <= rowsNum; i++) {
+        getNwBandRange(i, rowsNum, colsNum, band_width, lo, hi);
+        if (lo > 0) out_gap_num = min(out_gap_num, getNwMinGapNum(i, lo - 1, rowsNum, colsNum));
+        if (hi < colsNum) out_gap_num = min(out_gap_num, getNwMinGapNum(i, hi + 1, rowsNum, colsNum));
+
+        for (j = lo; j <= hi; j++) {
+            diag_cell = (j > 0 and j - 1 >= prev_lo and j - 1 <= prev_hi) ? &prev_row[j - 1] : &invalid_cell;
+            up_cell = (j >= prev_lo and j <= prev_hi) ? &prev_row[j] : &invalid_cell;
+            left_cell = (j > lo) ? &cur_row[j - 1] : &invalid_cell;
+
+            match = (diag_cell->score == NW_NEG_INF) ? NW_NEG_INF : diag_cell->score + (seq1[i - 1] == seq2[j - 1] ? match_score : mismatch_score);
+            delete_gap = (up_cell->score == NW_NEG_INF) ? NW_NEG_INF : up_cell->score + gap_penalty;
+            insert_gap = (left_cell->score == NW_NEG_INF) ? NW_NEG_INF : left_cell->score + gap_penalty;
+            score = max(match, delete_gap, insert_gap);
+
+            if (j > 0 and score == match) extendNwIdentityCell(cur_row[j], *diag_cell, score, false, seq1[i - 1] == seq2[j - 1]);
+            else if (score == delete_gap) extendNwIdentityCell(cur_row[j], *up_cell, score, true, false);
+            else extendNwIdentityCell(cur_row[j], *left_cell, score, true, false);
+        }
 
-    while (i > 0) {
-        seq1_new = seq1[i - 1] + seq1_new;
-        seq2_new = "-" + seq2_new;
-        i--;
+        tmp_row = prev_row; prev_row = cur_row; cur_row = tmp_row;
+        prev_lo = lo;
+        prev_hi = hi;
     }
 
-    while (j > 0) {
-        seq1_new = "-" + seq1_new;
-        seq2_new = seq2[j - 1] + seq2_new;
-        j--;
+    // the same as calculate_identity()
+    relief = prev_row[colsNum].relief;
+    if (prev_row[colsNum].gap_run >= 3) relief += (prev_row[colsNum].gap_run * RELIEF_FACTOR);
+    score = prev_row[colsNum].match_num;
+    i = prev_row[colsNum].aln_len;
+    band_score = prev_row[colsNum].score;
+
+    free(prev_row);
+    free(cur_row);
+
+    // a path leaving the band has at least out_gap_num gap columns and matches in all the others,
+    // the bound is doubled to stay integral
+    if (out_gap_num != LLONG_MAX) {
+        out_score_bound = (rowsNum + colsNum - out_gap_num) * (int64_t)max(match_score, mismatch_score) + 2 * out_gap_num * gap_penalty;
+        if (2 * band_score <= out_score_bound) {
+            wider_band_width = getNwIdentityBandWidth(rowsNum, colsNum, 2 * band_width);
+            if (wider_band_width > band_width) return needleman_wunschIdentity(seq1, seq2, match_score, mismatch_score, gap_penalty, wider_band_width);
+        }
     }
 
-    free(score_matrix);
+    return static_cast<double>(score + relief) / i;
 }
 
 double calculate_identity(const string& seq1, const string& seq2) {
@@ -102,71 +238,6 @@ double calculate_identity(const string& seq1, const string& seq2) {
     return identity;
 }
 
-size_t customHashFunction(const string& kmer, size_t kmerSize) {
-    size_t hashValue = 0;
-    size_t base = 4; 
-
-    for (size_t i = 0; i < kmer.length(); ++i) {
-        char baseChar = kmer[i];
-
-        size_t baseValue;
-        switch (baseChar) {
-        case 'A':
-            baseValue = 0;
-            break;
-        case 'C':
-            baseValue = 1;
-            break;
-        case 'G':
-            baseValue = 2;
-            break;
-        case 'T':
-            baseValue = 3;
-            break;
-        default:
-            //cerr << "Error: Invalid character in kmer." << "   kmer " << kmer << endl;
-            hashValue = INT_MAX;
-            return hashValue;
-        }
-        hashValue += baseValue * pow(base, kmerSize - i - 1);
-    }
-    return hashValue;
-}
-
-vector<Minimizer> findMinimizers(const string& sequence, size_t windowSize, size_t kmerSize) {
-    vector<Minimizer> minimizers;
-
-    for (size_t i = 0; i <= sequence.length() - windowSize - kmerSize + 1; ++i) {
-        string window = sequence.substr(i, windowSize + kmerSize - 1);
-        size_t minHash = INT_MAX;
-        string minKmer = "";
-        size_t pos;
-
-        for (size_t j = 0; j <= window.size() - kmerSize; ++j) {
-            string kmer = window.substr(j, kmerSize);
-            size_t hashValue = customHashFunction(kmer, kmerSize);
-
-            if (hashValue < minHash) {
-                minHash = hashValue;
-                minKmer = kmer;
-                pos = i + j;
-
-            }
-        }
-        Minimizer minimizer(pos, minHash, minKmer, false);
-        if (!minimizers.empty()) {
-            const Minimizer& lastMinimizer = minimizers.back();
-            if (minHash != lastMinimizer.hashValue or pos != lastMinimizer.position)
-                minimizers.push_back(minimizer);
-        }
-        else {
-            minimizers.push_back(minimizer);
-        }
-    }
-
-    return minimizers;
-}
-
 void retainCommonHashValuesMinimizers(vector<Minimizer>& containerA, vector<Minimizer>& containerB) {
 
     unordered_multiset<size_t> setB;
@@ -308,8 +379,8 @@ void LongSequenceSplitAlignment(vector<Minimizer>& minimizers, vector<Minimizer>
 
 
         if (i != Length) {
-            temporarily_seq = temporarily_seq + minimizers[i].sequence;
-            temporarily_seq1 = temporarily_seq1 + minimizers1[i].sequence;
+            temporarily_seq = temporarily_seq + sequence.substr(minimizers[i].position, k);
+            temporarily_seq1 = temporarily_seq1 + sequence1.substr(minimizers1[i].position, k);
             AlignSeq += temporarily_seq;
             AlignSeq1 += temporarily_seq1;
 
@@ -325,17 +396,34 @@ void LongSequenceSplitAlignment(vector<Minimizer>& minimizers, vector<Minimizer>
 
 }
 
+// upper bound of the identity of two sequences in any global alignment: at most the shorter sequence is
+// matched, and the gap columns of the other bases are relieved by at most RELIEF_FACTOR
+double getIdentityUpperBound(size_t len1, size_t len2) {
+    size_t min_len = min(len1, len2), max_len = max(len1, len2);
+    if (max_len == 0) return 1;
+    return RELIEF_FACTOR + (1 - RELIEF_FACTOR) * min_len / max_len;
+}
+
 // computeVarseqIdentity		upperSeq
-double computeVarseqIdentity(const string& seq, const string& seq1) {
-    string  seq1_new, seq2_new, seq_tmp, seq1_tmp, AlignSeq, AlignSeq1;
+// if min_identity>0, the alignment is skipped and the upper bound is returned when the lengths
+// are too unequal to reach min_identity
+double computeVarseqIdentity(const string& seq, const string& seq1, double min_identity) {
+    string  seq_tmp, seq1_tmp, AlignSeq, AlignSeq1;
+    int32_t band_width;
     double result;
+
+    if (min_identity > 0) {
+        result = getIdentityUpperBound(seq.size(), seq1.size());
+        if (result < min_identity) return result;
+    }
+
     if (seq.size() < MAX_SEQ_LEN or seq1.size() < MAX_SEQ_LEN) {
     	seq_tmp = seq;
     	seq1_tmp = seq1;
     	upperSeq(seq_tmp);
     	upperSeq(seq1_tmp);
-        needleman_wunschOp(seq, seq1, MATCHSCORE, MISMATCHSCORE, GAPPENALTY, seq1_new, seq2_new);
-        result = calculate_identity(seq1_new, seq2_new);
+        band_width = NW_BAND_MIN_WIDTH + NW_BAND_RATIO * max(seq.size(), seq1.size());
+        result = needleman_wunschIdentity(seq, seq1, MATCHSCORE, MISMATCHSCORE, GAPPENALTY, band_width);
     }
     else {
         vector<Minimizer> minimizers = findMinimizers(seq, WINDOWSIZE, KMERSIZE);
@@ -344,10 +432,8 @@ double computeVarseqIdentity(const string& seq, const string& seq1) {
         findSimilarityPosMinimizers(minimizers, minimizers1);
         FilterDissimilaPosMinimizers(minimizers, minimizers1);
         LongSequenceSplitAlignment(minimizers, minimizers1, KMERSIZE, AlignSeq, AlignSeq1, seq, seq1);
-        if (minimizers.empty() or minimizers1.empty()) {
-            needleman_wunschOp(seq, seq1, MATCHSCORE, MISMATCHSCORE, GAPPENALTY, seq1_new, seq2_new);
-            result = calculate_identity(seq1_new, seq2_new);
-        }
+        if (minimizers.empty() or minimizers1.empty())  // no anchors, the same alignment without traceback
+            result = needleman_wunschIdentity(seq, seq1, MATCHSCORE, MISMATCHSCORE, GAPPENALTY, 0);
         else
             result = calculate_identity(AlignSeq, AlignSeq1);
     }
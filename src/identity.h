@@ -10,6 +10,7 @@
 #include <fstream>
 #include <unordered_map>
 #include "util.h"
+#include "minimizer.h"
 
 using namespace std;
 
@@ -24,23 +25,31 @@ using namespace std;
 
 #define RELIEF_FACTOR		0.1
 
+#define NW_BAND_MIN_WIDTH	100		// minimal half width of the band of identity-only alignment
+#define NW_BAND_RATIO		0.1		// half width of the band relative to the longer sequence
+#define NW_NEG_INF			(INT_MIN / 2)
 
-struct Minimizer {
-    size_t position;
-    size_t hashValue;
-    string sequence;
-    bool matchflag;
+// hard memory ceilings of a single alignment, the band is narrowed to fit them
+#define NW_MAX_DIR_MATRIX_BYTES		(64LL << 20)	// directions of the traceback alignment, 2 bits per cell
+#define NW_MAX_IDENTITY_CELLS		(64LL << 20)	// computed cells of the identity-only alignment
 
-    Minimizer(size_t pos, size_t hash, const string& seq, bool match)
-        : position(pos), hashValue(hash), sequence(seq), matchflag(match) {}
-};
+// traceback directions, 2 bits per cell
+#define NW_DIR_DIAG			0
+#define NW_DIR_UP			1
+#define NW_DIR_LEFT			2
+
+// cell of the identity-only alignment, the statistics of the alignment path ending at the cell
+typedef struct{
+	int32_t score, match_num, aln_len, gap_run;		// gap_run: length of the trailing gap run
+	double relief;		// relief of the closed gap runs, the same as calculate_identity()
+}nwIdentityCell_t;
 
 int max(int a, int b, int c);
-double computeVarseqIdentity(const string& seq, const string& seq1);
+double computeVarseqIdentity(const string& seq, const string& seq1, double min_identity=0);
+double getIdentityUpperBound(size_t len1, size_t len2);
 void needleman_wunschOp(const string& seq1, const string& seq2, int32_t match_score, int32_t mismatch_score, int32_t gap_penalty, string& seq1_new, string& seq2_new);
+double needleman_wunschIdentity(const string& seq1, const string& seq2, int32_t match_score, int32_t mismatch_score, int32_t gap_penalty, int32_t band_width);
 double calculate_identity(const string& seq1, const string& seq2);
-vector<Minimizer> findMinimizers(const string& sequence, size_t windowSize, size_t kmerSize);
-size_t customHashFunction(const string& kmer, size_t kmerSize);
 void retainCommonHashValuesMinimizers(vector<Minimizer>& containerA, vector<Minimizer>& containerB);
 void findSimilarityPosMinimizers(vector<Minimizer>& minimizers, vector<Minimizer>& minimizers1);
 void FilterDissimilaPosMinimizers(vector<Minimizer>& minimizers, vector<Minimizer>& minimizers1);
@@ -0,0 +1,140 @@
+// regression benchmark of the early exit of computeVarseqIdentity(): the identity with and without the
+// identity threshold is computed for random pairs of unequal lengths, and the merge decisions (identity>=threshold)
+// of both must be the same; build and run: make identity_bench && ./identity_bench [pair_num] [seed]
+
+#include <random>
+#include <numeric>
+#include <sys/time.h>
+#include "identity.h"
+#include "util.h"
+
+#define BENCH_PAIR_NUM_DEFAULT		2000
+#define BENCH_SEED_DEFAULT			1
+#define BENCH_MIN_SEQ_LEN			50
+#define BENCH_MAX_SEQ_LEN			8000		// longer than MAX_SEQ_LEN to cover the minimizer alignment
+
+const double bench_thres_arr[] = { 0.5, 0.75, 0.9, 0.95 };	// thresholds used by the merge and genotyping callers
+
+// highly unequal lengths, the band of the full alignment exceeds NW_MAX_IDENTITY_CELLS in both orders
+const int32_t bench_unequal_len_arr[][2] = { {40000, 4000}, {4000, 90000}, {80000, 4900}, {4900, 80000} };
+
+mt19937 bench_rng;
+
+// wall-clock time in seconds, the Time class only has a resolution of one second
+double getBenchSeconds(){
+	struct timeval time_val;
+	gettimeofday(&time_val, NULL);
+	return time_val.tv_sec + time_val.tv_usec / 1000000.0;
+}
+
+string getRandomSeq(int32_t len){
+	string seq;
+	for(int32_t i=0; i<len; i++) seq.push_back("ACGT"[bench_rng()%4]);
+	return seq;
+}
+
+string getMutatedSeq(const string &seq, double mut_ratio){
+	string mut_seq;
+	int32_t val;
+
+	for(size_t i=0; i<seq.size(); i++){
+		val = bench_rng() % 1000;
+		if(val<mut_ratio*1000/3) continue;  // deletion
+		else if(val<mut_ratio*1000*2/3) mut_seq.push_back("ACGT"[bench_rng()%4]);  // mismatch
+		else {
+			mut_seq.push_back(seq.at(i));
+			if(val<mut_ratio*1000) mut_seq.push_back("ACGT"[bench_rng()%4]);  // insertion
+		}
+	}
+	return mut_seq;
+}
+
+// a pair of related sequences of unequal lengths: the second one is a mutated copy of the first one
+// with a part removed or a random part added at either end
+void getBenchSeqPair(string &seq1, string &seq2){
+	int32_t len1, len2, type;
+
+	len1 = BENCH_MIN_SEQ_LEN + bench_rng() % (BENCH_MAX_SEQ_LEN - BENCH_MIN_SEQ_LEN);
+	seq1 = getRandomSeq(len1);
+	len2 = BENCH_MIN_SEQ_LEN + bench_rng() % (len1 - BENCH_MIN_SEQ_LEN + 1);  // not longer than the first one
+	type = bench_rng() % 4;
+	if(type==0) seq2 = getMutatedSeq(seq1.substr(0, len2), 0.03);
+	else if(type==1) seq2 = getMutatedSeq(seq1.substr(len1-len2), 0.03);
+	else if(type==2) seq2 = getMutatedSeq(seq1, 0.03) + getRandomSeq(len2 / 4);
+	else seq2 = getRandomSeq(len2 / 4) + getMutatedSeq(seq1, 0.03);
+}
+
+// a pair of highly unequal lengths: the shorter one is a mutated part of the longer one
+void getUnequalBenchSeqPair(string &seq1, string &seq2, int32_t len1, int32_t len2){
+	string long_seq, short_seq;
+
+	long_seq = getRandomSeq(max(len1, len2));
+	short_seq = getMutatedSeq(long_seq.substr(bench_rng() % (long_seq.size() - min(len1, len2) + 1), min(len1, len2)), 0.03);
+	seq1 = (len1>=len2) ? long_seq : short_seq;
+	seq2 = (len1>=len2) ? short_seq : long_seq;
+}
+
+// compare the identity with and without the identity threshold, and return the number of differing decisions
+int32_t compareBenchDecisions(const string &seq1, const string &seq2, int32_t thres_num, vector<int32_t> &exit_num_vec, vector<int32_t> &diff_num_vec, double &full_seconds, double &early_seconds){
+	double full_val, early_val, start_seconds;
+	int32_t j, diff_num = 0;
+
+	start_seconds = getBenchSeconds();
+	full_val = computeVarseqIdentity(seq1, seq2);
+	full_seconds += getBenchSeconds() - start_seconds;
+
+	for(j=0; j<thres_num; j++){
+		start_seconds = getBenchSeconds();
+		early_val = computeVarseqIdentity(seq1, seq2, bench_thres_arr[j]);
+		early_seconds += getBenchSeconds() - start_seconds;
+
+		if(getIdentityUpperBound(seq1.size(), seq2.size())<bench_thres_arr[j]) exit_num_vec.at(j) ++;
+		if((full_val>=bench_thres_arr[j])!=(early_val>=bench_thres_arr[j])){
+			diff_num_vec.at(j) ++;
+			diff_num ++;
+			cerr << "decision differs: threshold=" << bench_thres_arr[j] << ", len1=" << seq1.size() << ", len2=" << seq2.size() << ", full=" << full_val << ", early=" << early_val << endl;
+		}
+	}
+
+	return diff_num;
+}
+
+int main(int argc, char *argv[]){
+	int32_t pair_num, thres_num, unequal_num, unequal_diff_num, i, j;
+	vector<int32_t> exit_num_vec, diff_num_vec, unequal_exit_num_vec;
+	double full_seconds = 0, early_seconds = 0, unequal_full_seconds = 0, unequal_early_seconds = 0;
+	string seq1, seq2;
+
+	pair_num = (argc>1) ? atoi(argv[1]) : BENCH_PAIR_NUM_DEFAULT;
+	bench_rng.seed((argc>2) ? atoi(argv[2]) : BENCH_SEED_DEFAULT);
+	thres_num = sizeof(bench_thres_arr) / sizeof(bench_thres_arr[0]);
+	exit_num_vec.resize(thres_num, 0);
+	diff_num_vec.resize(thres_num, 0);
+	unequal_exit_num_vec.resize(thres_num, 0);
+
+	for(i=0; i<pair_num; i++){
+		getBenchSeqPair(seq1, seq2);
+		compareBenchDecisions(seq1, seq2, thres_num, exit_num_vec, diff_num_vec, full_seconds, early_seconds);
+	}
+
+	// the highly unequal cases, all of them should exit early
+	unequal_num = sizeof(bench_unequal_len_arr) / sizeof(bench_unequal_len_arr[0]);
+	unequal_diff_num = 0;
+	for(i=0; i<unequal_num; i++){
+		getUnequalBenchSeqPair(seq1, seq2, bench_unequal_len_arr[i][0], bench_unequal_len_arr[i][1]);
+		unequal_diff_num += compareBenchDecisions(seq1, seq2, thres_num, unequal_exit_num_vec, diff_num_vec, unequal_full_seconds, unequal_early_seconds);
+	}
+	for(j=0; j<thres_num; j++){
+		if(unequal_exit_num_vec.at(j)!=unequal_num){
+			diff_num_vec.at(j) ++;
+			cerr << "missing early exits of the unequal pairs: threshold=" << bench_thres_arr[j] << ", early exits=" << unequal_exit_num_vec.at(j) << "/" << unequal_num << endl;
+		}
+	}
+
+	cout << "pairs=" << pair_num << ", full alignment seconds=" << full_seconds << ", early exit seconds=" << early_seconds / thres_num << " (mean of the thresholds)" << endl;
+	cout << "unequal pairs=" << unequal_num << ", full alignment seconds=" << unequal_full_seconds << ", early exit seconds=" << unequal_early_seconds / thres_num << ", differing decisions=" << unequal_diff_num << endl;
+	for(j=0; j<thres_num; j++)
+		cout << "threshold=" << bench_thres_arr[j] << ": early exits=" << exit_num_vec.at(j) << ", differing decisions=" << diff_num_vec.at(j) << endl;
+
+	return (accumulate(diff_num_vec.begin(), diff_num_vec.end(), 0)==0) ? 0 : 1;
+}
@@ -102,71 +102,6 @@ double calculate_consistency(const string& seq1, const string& seq2) {
     return consistency;
 }
 
-size_t customHashFunction(const string& kmer, size_t kmerSize) {
-    size_t hashValue = 0;
-    size_t base = 4; 
-
-    for (size_t i = 0; i < kmer.length(); ++i) {
-        char baseChar = kmer[i];
-
-        size_t baseValue;
-        switch (baseChar) {
-        case 'A':
-            baseValue = 0;
-            break;
-        case 'C':
-            baseValue = 1;
-            break;
-        case 'G':
-            baseValue = 2;
-            break;
-        case 'T':
-            baseValue = 3;
-            break;
-        default:
-            //cerr << "Error: Invalid character in kmer." << "   kmer " << kmer << endl;
-            hashValue = INT_MAX;
-            return hashValue;
-        }
-        hashValue += baseValue * pow(base, kmerSize - i - 1);
-    }
-    return hashValue;
-}
-
-vector<Minimizer> findMinimizers(const string& sequence, size_t windowSize, size_t kmerSize) {
-    vector<Minimizer> minimizers;
-
-    for (size_t i = 0; i <= sequence.length() - windowSize - kmerSize + 1; ++i) {
-        string window = sequence.substr(i, windowSize + kmerSize - 1);
-        size_t minHash = INT_MAX;
-        string minKmer = "";
-        size_t pos;
-
-        for (size_t j = 0; j <= window.size() - kmerSize; ++j) {
-            string kmer = window.substr(j, kmerSize);
-            size_t hashValue = customHashFunction(kmer, kmerSize);
-
-            if (hashValue < minHash) {
-                minHash = hashValue;
-                minKmer = kmer;
-                pos = i + j;
-
-            }
-        }
-        Minimizer minimizer(pos, minHash, minKmer, false);
-        if (!minimizers.empty()) {
-            const Minimizer& lastMinimizer = minimizers.back();
-            if (minHash != lastMinimizer.hashValue or pos != lastMinimizer.position)
-                minimizers.push_back(minimizer);
-        }
-        else {
-            minimizers.push_back(minimizer);
-        }
-    }
-
-    return minimizers;
-}
-
 void retainCommonHashValuesMinimizers(vector<Minimizer>& containerA, vector<Minimizer>& containerB) {
 
     unordered_multiset<size_t> setB;
@@ -304,8 +239,8 @@ void LongSequenceSplitAlignment(vector<Minimizer>& minimizers, vector<Minimizer>
 
 
         if (i != Length) {
-            temporarily_seq = temporarily_seq + minimizers[i].sequence;
-            temporarily_seq1 = temporarily_seq1 + minimizers1[i].sequence;
+            temporarily_seq = temporarily_seq + sequence.substr(minimizers[i].position, k);
+            temporarily_seq1 = temporarily_seq1 + sequence1.substr(minimizers1[i].position, k);
             AlignSeq += temporarily_seq;
             AlignSeq1 += temporarily_seq1;
 
@@ -10,6 +10,7 @@
 #include <fstream>
 #include <unordered_map>
 #include "util.h"
+#include "minimizer.h"
 
 using namespace std;
 
@@ -24,23 +25,10 @@ using namespace std;
 
 #define RELIEF_FACTOR		0.1
 
-
-struct Minimizer {
-    size_t position;
-    size_t hashValue;
-    string sequence;
-    bool matchflag;
-
-    Minimizer(size_t pos, size_t hash, const string& seq, bool match)
-        : position(pos), hashValue(hash), sequence(seq), matchflag(match) {}
-};
-
 int max(int a, int b, int c);
 double computeVarseqIndentity(const string& seq, const string& seq1);
 void needleman_wunschOp(const string& seq1, const string& seq2, int32_t match_score, int32_t mismatch_score, int32_t gap_penalty, string& seq1_new, string& seq2_new);
 double calculate_consistency(const string& seq1, const string& seq2);
-vector<Minimizer> findMinimizers(const string& sequence, size_t windowSize, size_t kmerSize);
-size_t customHashFunction(const string& kmer, size_t kmerSize);
 void retainCommonHashValuesMinimizers(vector<Minimizer>& containerA, vector<Minimizer>& containerB);
 void findSimilarityPosMinimizers(vector<Minimizer>& minimizers, vector<Minimizer>& minimizers1);
 void FilterDissimilaPosMinimizers(vector<Minimizer>& minimizers, vector<Minimizer>& minimizers1);
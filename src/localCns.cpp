@@ -3,10 +3,40 @@
 #include "clipAlnDataLoader.h"
 
 pthread_mutex_t mutex_write = PTHREAD_MUTEX_INITIALIZER;
+pthread_mutex_t mutex_poa_stat = PTHREAD_MUTEX_INITIALIZER;
+poaLatencyStat_t poa_latency_stat_arr[POA_PATH_NUM];
+
+// content-addressed consensus cache shared by reruns, disabled by the empty directory
+string cns_cache_dir = "";
+string cns_cache_tool_versions = "";	// versions of abPOA and wtdbg2, probed once at startup
+cnsCacheStat_t cns_cache_stat = {0, 0};
+pthread_mutex_t mutex_cns_cache_stat = PTHREAD_MUTEX_INITIALIZER;
+
+#ifdef HAVE_LIBABPOA
+// nucleotide to abPOA code: A-0, C-1, G-2, T-3, others-4
+static const uint8_t poa_nt4_table[256] = {
+	4, 4, 4, 4,  4, 4, 4, 4,  4, 4, 4, 4,  4, 4, 4, 4,
+	4, 4, 4, 4,  4, 4, 4, 4,  4, 4, 4, 4,  4, 4, 4, 4,
+	4, 4, 4, 4,  4, 4, 4, 4,  4, 4, 4, 4,  4, 4, 4, 4,
+	4, 4, 4, 4,  4, 4, 4, 4,  4, 4, 4, 4,  4, 4, 4, 4,
+	4, 0, 4, 1,  4, 4, 4, 2,  4, 4, 4, 4,  4, 4, 4, 4,
+	4, 4, 4, 4,  3, 3, 4, 4,  4, 4, 4, 4,  4, 4, 4, 4,
+	4, 0, 4, 1,  4, 4, 4, 2,  4, 4, 4, 4,  4, 4, 4, 4,
+	4, 4, 4, 4,  3, 3, 4, 4,  4, 4, 4, 4,  4, 4, 4, 4,
+	4, 4, 4, 4,  4, 4, 4, 4,  4, 4, 4, 4,  4, 4, 4, 4,
+	4, 4, 4, 4,  4, 4, 4, 4,  4, 4, 4, 4,  4, 4, 4, 4,
+	4, 4, 4, 4,  4, 4, 4, 4,  4, 4, 4, 4,  4, 4, 4, 4,
+	4, 4, 4, 4,  4, 4, 4, 4,  4, 4, 4, 4,  4, 4, 4, 4,
+	4, 4, 4, 4,  4, 4, 4, 4,  4, 4, 4, 4,  4, 4, 4, 4,
+	4, 4, 4, 4,  4, 4, 4, 4,  4, 4, 4, 4,  4, 4, 4, 4,
+	4, 4, 4, 4,  4, 4, 4, 4,  4, 4, 4, 4,  4, 4, 4, 4,
+	4, 4, 4, 4,  4, 4, 4, 4,  4, 4, 4, 4,  4, 4, 4, 4
+};
+#endif
 //extern pthread_mutex_t mutex_down_sample;
 extern pthread_mutex_t mutex_fai;
 
-localCns::localCns(string &readsfilename, string &contigfilename, string &refseqfilename, string &clusterfilename, string &tmpdir, string &technology, double min_identity_match, int32_t sv_len_est, size_t num_threads_per_cns_work, vector<reg_t*> &varVec, string &chrname, string &inBamFile, faidx_t *fai, size_t cns_extend_size, double expected_cov, double min_input_cov, double max_ultra_high_cov, int32_t minMapQ, int32_t minHighMapQ, bool delete_reads_flag, bool keep_failed_reads_flag, bool clip_reg_flag, int32_t minClipEndSize, int32_t minConReadLen, int32_t min_sv_size, int32_t min_supp_num, double max_seg_size_ratio){
+localCns::localCns(string &readsfilename, string &contigfilename, string &refseqfilename, string &clusterfilename, string &tmpdir, string &technology, double min_identity_match, int32_t sv_len_est, size_t num_threads_per_cns_work, vector<reg_t*> &varVec, string &chrname, string &inBamFile, faidx_t *fai, size_t cns_extend_size, double expected_cov, double min_input_cov, double max_ultra_high_cov, int32_t minMapQ, int32_t minHighMapQ, bool delete_reads_flag, bool keep_failed_reads_flag, bool clip_reg_flag, int32_t minClipEndSize, int32_t minConReadLen, int32_t min_sv_size, int32_t min_supp_num, double max_seg_size_ratio, int32_t max_proc_running_minutes){
 
 	this->chrname = chrname;
 	this->chrlen = faidx_seq_len(fai, chrname.c_str()); // get reference size
@@ -14,7 +44,7 @@ localCns::localCns(string &readsfilename, string &contigfilename, string &refseq
 	this->contigfilename = preprocessPipeChar(contigfilename);
 	this->refseqfilename = preprocessPipeChar(refseqfilename);
 	this->clusterfilename = preprocessPipeChar(clusterfilename);
-	this->tmpdir = preprocessPipeChar(tmpdir);
+	this->tmpdir = getScratchFilename(preprocessPipeChar(tmpdir));  // transient files of the external tools
 	this->technology = technology;
 	this->sv_len_est = sv_len_est;
 	this->num_threads_per_cns_work = num_threads_per_cns_work;
@@ -25,6 +55,7 @@ localCns::localCns(string &readsfilename, string &contigfilename, string &refseq
 	this->min_sv_size = min_sv_size;
 	this->min_supp_num = min_supp_num;
 	this->max_seg_size_ratio = max_seg_size_ratio;
+	this->max_proc_running_minutes = max_proc_running_minutes;
 	this->max_ultra_high_cov = max_ultra_high_cov;
 	this->min_identity_match = min_identity_match;
 	this->varVec = varVec;
@@ -64,6 +95,8 @@ localCns::localCns(string &readsfilename, string &contigfilename, string &refseq
 }
 
 localCns::~localCns() {
+	string out_reads_filename;
+
 	if(delete_reads_flag){
 		if(keep_failed_reads_flag==false or (keep_failed_reads_flag and cns_success_flag)){
 //			if(clip_reg_flag==false){ // indel region
@@ -71,8 +104,14 @@ localCns::~localCns() {
 //			}else{
 //				remove(readsfilename.c_str());	// delete the reads file to save disk space
 //			}
+		}else{ // keep the failed reads in the output directory
+			for(size_t i=0; i<readsfilename_vec.size(); i++){
+				out_reads_filename = readsfilename.substr(0, readsfilename.find_last_of("/")+1) + readsfilename_vec.at(i).substr(readsfilename_vec.at(i).find_last_of("/")+1);
+				if(out_reads_filename.compare(readsfilename_vec.at(i))!=0) moveFile(readsfilename_vec.at(i), out_reads_filename);
+			}
 		}
 	}
+	clearQcSigCache();
 }
 
 // destroy the alignment data of the block
@@ -387,6 +426,7 @@ vector<struct querySeqInfoVec*> localCns::queryCluster(vector<struct querySeqInf
 	bool flag, q_cluster_b_null_valid_flag;
 
 	for(i=0; i<query_seq_info_all.size(); i++) query_seq_info_all.at(i)->cluster_finished_flag = false;
+	clearQcSigCache();
 
 	prepareQueryInfoForCluster(query_seq_info_all); // prepare query information for cluster
 
@@ -613,6 +653,8 @@ vector<struct querySeqInfoVec*> localCns::queryCluster(vector<struct querySeqInf
 		query_clu_vec.push_back(q_cluster_node_b);
 	}
 
+	clearQcSigCache();
+
 	return query_clu_vec;
 }
 
@@ -829,42 +871,57 @@ double localCns::computeScoreRatio(struct querySeqInfoNode* query_seq_info_node,
 	int32_t score_sum;
 	size_t i;
 	queryCluSig_t *queryCluSig, *seed_qcQuery;
+	vector<int8_t> match_profile_vec;
 
 #if POA_ALIGN_DEBUG
 	cout << "qname1=" << query_seq_info_node->qname << ", qname2=" << q_cluster_node->qname << endl;
 #endif
 
 	score_ratio = 0;
-	//matching prepare
-	queryCluSig = new queryCluSig_t();
-	queryCluSig->qcSig_vec = extractQcSigsFromAlnSegsSingleQuery(query_seq_info_node, query_seq_info_node->clip_aln->chrname, startSpanPos, endSpanPos, min_sv_size);
-	seed_qcQuery = new queryCluSig_t();
-	seed_qcQuery->qcSig_vec = extractQcSigsFromAlnSegsSingleQuery(q_cluster_node, q_cluster_node->clip_aln->chrname, startSpanPos, endSpanPos, min_sv_size);
-
-	//merge queryCluSig->qcSig_vec and seed_qcQuery->qcSig_vec
-	mergeNeighbouringSigs(query_seq_info_node, queryCluSig->qcSig_vec, 100, 0.7, fai);
-	mergeNeighbouringSigs(q_cluster_node, seed_qcQuery->qcSig_vec, 100, 0.7, fai);
+	//matching prepare: the merged signatures are shared by the comparisons in the same span window
+	queryCluSig = getQcSigsInSpan(query_seq_info_node, startSpanPos, endSpanPos, min_sv_size);
+	seed_qcQuery = getQcSigsInSpan(q_cluster_node, startSpanPos, endSpanPos, min_sv_size);
 
 	//matching
-	queryCluSig->match_profile_vec = computeQcMatchProfileSingleQuery(queryCluSig, seed_qcQuery);
-	if(queryCluSig->match_profile_vec.size()==0){
+	match_profile_vec = computeQcMatchProfileSingleQuery(queryCluSig, seed_qcQuery);
+	if(match_profile_vec.size()==0){
 		//score_ratio = 2;//have no varsig
 		score_ratio = 0; //0.99
 	}else{
 		score_sum = 0;
-		for(i=0; i<queryCluSig->match_profile_vec.size(); i++) score_sum += queryCluSig->match_profile_vec.at(i);
-		score_ratio = (double)score_sum / queryCluSig->match_profile_vec.size();
+		for(i=0; i<match_profile_vec.size(); i++) score_sum += match_profile_vec.at(i);
+		score_ratio = (double)score_sum / match_profile_vec.size();
 	}
 #if POA_ALIGN_DEBUG
 	cout << "score_ratio=" << score_ratio << endl;
 #endif
 
-	destroyQueryQcSig(queryCluSig);
-	destroyQueryQcSig(seed_qcQuery);
-
 	return score_ratio;
 }
 
+// get the merged signatures of the query within the span window, they are extracted only at the first time
+queryCluSig_t* localCns::getQcSigsInSpan(struct querySeqInfoNode *query_seq_info_node, int64_t startSpanPos, int64_t endSpanPos, int32_t min_sv_size){
+	queryCluSig_t *queryCluSig;
+	qcSigCacheKey_t cache_key = make_pair(query_seq_info_node, make_pair(startSpanPos, endSpanPos));
+	map<qcSigCacheKey_t, queryCluSig_t*>::iterator it;
+
+	it = qc_sig_cache.find(cache_key);
+	if(it!=qc_sig_cache.end()) return it->second;
+
+	queryCluSig = new queryCluSig_t();
+	queryCluSig->qcSig_vec = extractQcSigsFromAlnSegsSingleQuery(query_seq_info_node, query_seq_info_node->clip_aln->chrname, startSpanPos, endSpanPos, min_sv_size);
+	mergeNeighbouringSigs(query_seq_info_node, queryCluSig->qcSig_vec, 100, 0.7, fai);
+	qc_sig_cache[cache_key] = queryCluSig;
+
+	return queryCluSig;
+}
+
+void localCns::clearQcSigCache(){
+	map<qcSigCacheKey_t, queryCluSig_t*>::iterator it;
+	for(it=qc_sig_cache.begin(); it!=qc_sig_cache.end(); it++) destroyQueryQcSig(it->second);
+	qc_sig_cache.clear();
+}
+
 vector<int8_t> localCns::computeQcMatchProfileSingleQuery(queryCluSig_t *queryCluSig, queryCluSig_t *seed_qcQuery){
 	vector<int8_t> match_profile_vec;
 	int32_t rowsNum, colsNum, matchScore, mismatchScore, gapScore, gapOpenScore;
@@ -1527,7 +1584,7 @@ vector<string> localCns::joinQueryAlnSegs(vector<clipAlnData_t*> &query_aln_segs
 			qual_int = bam_get_qual(clip_aln->bam);
 
 			qseq = qual = "";
-			for(j=0; j<clip_aln->bam->core.l_qseq; j++) qseq += "=ACMGRSVTWYHKDBN"[bam_seqi(seq_int, j)];  // seq
+			decodeBamSeq(seq_int, 0, clip_aln->bam->core.l_qseq, qseq);  // seq
 			for(j=0; j<clip_aln->bam->core.l_qseq; j++) qual += qual_int[j] + 33;  // qual
 
 			cout << "qseq=" << qseq << endl;
@@ -1620,6 +1677,14 @@ int32_t localCns::getLeftMostAlnSeg(vector<clipAlnData_t*> &query_aln_segs){
 
 bool localCns::localConsensus(){
 	bool flag;
+	string cache_key;
+
+	// the consensus of the identical reads is loaded from the cache
+	cache_key = getCnsCacheKey();
+	if(cache_key.size()>0 and loadCnsFromCache(cache_key)){
+		destorySeqsVec(seqs_vec);
+		return true;
+	}
 
 	//if(local_cns.clip_reg_flag==false){
 	if(use_poa_flag){
@@ -1636,26 +1701,120 @@ bool localCns::localConsensus(){
 		// }
 	}
 
+	if(flag and cache_key.size()>0) saveCnsToCache(cache_key);
+
 	destorySeqsVec(seqs_vec);
 
 	return flag;
 }
 
-// get heter local consensus using abPOA
+// get the cache key of the consensus work: hash of the tool, its version and parameters, and the sorted read names and trimmed sequences
+// of each cluster; empty string if the cache is disabled
+string localCns::getCnsCacheKey(){
+	uint64_t hash_a, hash_b;
+	vector<pair<string, size_t>> name_idx_vec;
+	string params_str;
+	struct seqsVec *seqs;
+	char key_str[40];
+	size_t i, k;
+
+	if(cns_cache_dir.empty()) return "";
+
+	params_str = string(CNS_CACHE_KEY_VERSION) + "|" + (use_poa_flag ? "abpoa" : "wtdbg2") + "|" + cns_cache_tool_versions + "|" + technology + "|" + to_string(min_supp_num*READS_NUM_SUPPORT_FACTOR) + "|" + to_string(mean_read_len>=MIN_SEQ_LEN_USING_MINIMIZER);
+#ifdef HAVE_LIBABPOA
+	params_str += "|lib";
+#endif
+
+	hash_a = hash_b = 0;
+	hashStrFnv1a(params_str, hash_a, hash_b);
+	for(k=0; k<seqs_vec.size(); k++){
+		seqs = seqs_vec.at(k);
+		name_idx_vec.clear();
+		for(i=0; i<seqs->qname.size(); i++) name_idx_vec.push_back(make_pair(seqs->qname.at(i), i));
+		sort(name_idx_vec.begin(), name_idx_vec.end());
+
+		hashStrFnv1a("#cluster", hash_a, hash_b);
+		for(i=0; i<name_idx_vec.size(); i++){
+			hashStrFnv1a(name_idx_vec.at(i).first, hash_a, hash_b);
+			hashStrFnv1a(seqs->seqs.at(name_idx_vec.at(i).second), hash_a, hash_b);
+		}
+	}
+
+	snprintf(key_str, sizeof(key_str), "%016lx%016lx", (unsigned long)hash_a, (unsigned long)hash_b);
+
+	return key_str;
+}
+
+// load the consensus from cache, and return true for a hit
+bool localCns::loadCnsFromCache(string &cache_key){
+	string cache_filename;
+	bool flag = false;
+
+	cache_filename = cns_cache_dir + "/" + cache_key.substr(0, 2) + "/" + cache_key + ".fa";
+	if(isFileExist(cache_filename) and copyFile(cache_filename, contigfilename)){
+		cns_success_flag = true;
+		flag = true;
+	}
+
+	pthread_mutex_lock(&mutex_cns_cache_stat);
+	cns_cache_stat.lookup_num ++;
+	if(flag) cns_cache_stat.hit_num ++;
+	pthread_mutex_unlock(&mutex_cns_cache_stat);
+
+	return flag;
+}
+
+// save the consensus to cache, the file is renamed after being fully written to tolerate the concurrent works
+void localCns::saveCnsToCache(string &cache_key){
+	string cache_subdir, cache_filename, tmp_filename;
+
+	if(!isFileExist(contigfilename)) return;
+
+	cache_subdir = cns_cache_dir + "/" + cache_key.substr(0, 2);
+	cache_filename = cache_subdir + "/" + cache_key + ".fa";
+	tmp_filename = cache_filename + ".tmp_" + to_string(getpid()) + "_" + to_string(pthread_self());
+	mkdir(cache_subdir.c_str(), S_IRWXU | S_IRGRP | S_IXGRP | S_IROTH | S_IXOTH);
+	if(copyFile(contigfilename, tmp_filename)==false or rename(tmp_filename.c_str(), cache_filename.c_str())!=0) remove(tmp_filename.c_str());
+}
+
+// get the reads file name of the cluster, it is put into the scratch directory unless the reads are retained
+string localCns::getClusterReadsFilename(size_t cluster_id){
+	string reads_filename = readsfilename_prefix + "_" + to_string(cluster_id) + readsfilename_suffix;
+	if(delete_reads_flag) reads_filename = getScratchFilename(reads_filename);
+	return reads_filename;
+}
+
+// save the reads of the cluster into file, and an empty file is generated for insufficient reads
+void localCns::saveClusterReads(string &reads_filename, size_t cluster_id, bool save_seqs_flag){
+	ofstream reads_file;
+	struct seqsVec *seqs = seqs_vec.at(cluster_id);
+
+	readsfilename_vec.push_back(reads_filename);  // save read file names
+	reads_file.open(reads_filename);
+	if(!reads_file.is_open()){
+		cerr << __func__ << ", line=" << __LINE__ << ": cannot open file " << reads_filename << endl;
+		exit(1);
+	}
+	if(save_seqs_flag)
+		for(size_t i=0; i<seqs->seqs.size(); i++) reads_file << ">" << seqs->qname[i] << endl << seqs->seqs[i] << endl;
+	reads_file.close();
+}
+
+// get heter local consensus using abPOA, the abPOA library is used if available, otherwise the external 'abpoa' is used
 bool localCns::cnsByPoa(){
-	bool flag, abpoa_flag;
-	string tmp_cons_filename, tmp_reads_filename, cons_header, cmd1, cmd2, cmd4;
-	ofstream cons_file, reads_file;
+	bool flag, seeding_flag, poa_flag, tmpdir_flag, lib_flag, reads_kept_flag;
+	string tmp_reads_filename, cons_header;
+	ofstream cons_file;
 	size_t k, i, j, n_seqs, serial_number;
-	int64_t mem_avail;
+	int64_t mem_cost;
+	vector<string> cons_seq_vec;
+	struct timeval start_time, end_time;
+
 	// check the file
 	flag = isFileExist(contigfilename);
 	if(flag) return true; // cons was generated successfully previously
 
-	cmd1 = "mkdir -p " + tmpdir;
-	cmd4 = "rm -rf " + tmpdir;  // delete files
-
-	system(cmd1.c_str());
+	gettimeofday(&start_time, NULL);
 
 	// save the cons to file
 	cons_file.open(contigfilename);
@@ -1664,83 +1823,56 @@ bool localCns::cnsByPoa(){
 		exit(1);
 	}
 
+	seeding_flag = (mean_read_len>=MIN_SEQ_LEN_USING_MINIMIZER);
+	reads_kept_flag = (delete_reads_flag==false or keep_failed_reads_flag);
+	tmpdir_flag = false;
+	lib_flag = true;
 	serial_number = 1;
 	for(k=0; k<seqs_vec.size(); k++){
-		tmp_reads_filename = readsfilename_prefix + "_" + to_string(k) + readsfilename_suffix;
-		readsfilename_vec.push_back(tmp_reads_filename);  // save read file names
-		reads_file.open(tmp_reads_filename);
-		if(!reads_file.is_open()){
-			cerr << __func__ << ", line=" << __LINE__ << ": cannot open file " << tmp_reads_filename << endl;
-			exit(1);
-		}
+		tmp_reads_filename = getClusterReadsFilename(k);
 
+		// the reads file is only needed by the external binary, or when it is retained
 		n_seqs = seqs_vec.at(k)->seqs.size();
-		if(n_seqs>=(size_t)min_supp_num*READS_NUM_SUPPORT_FACTOR){ // only use sufficient reads data to generate consensus sequence
-			for (i = 0; i < n_seqs; ++i) reads_file << ">" << seqs_vec.at(k)->qname[i] << endl << seqs_vec.at(k)->seqs[i] << endl;
-			reads_file.close();
-
-			abpoa_flag = false;
-			while(1){
-				pthread_mutex_lock(&mutex_mem);
-				mem_avail = getMemInfo("MemAvailable", 2);
-				// prepare for alignment computation
-				if(mem_avail>=min_mem_avail and mem_total-mem_avail<=mem_total*mem_use_block_factor+extend_total*extend_use_block_factor){
-//				if(mem_seqAln+mem_cost<=mem_total*mem_use_block_factor+extend_total*extend_use_block_factor){
-					work_num ++;
-					abpoa_flag = true;
-				}
-				pthread_mutex_unlock(&mutex_mem);
+		if(reads_kept_flag) saveClusterReads(tmp_reads_filename, k, n_seqs>=(size_t)min_supp_num*READS_NUM_SUPPORT_FACTOR);
 
-				if(abpoa_flag==false){ // block the alignment computation
-					//cout << "\t" << __func__ << ": wait " << mem_wait_seconds << " seconds, mem_avail=" << (mem_avail >> 10) << " MB, work_num=" << work_num << ", " << contigfilename << endl;
-					sleep(mem_wait_seconds);
-				}else{
-					tmp_cons_filename = tmpdir + "/consensus_" + to_string(k) + ".fa";
-					// cmd2 = "abpoa -o " + tmp_cons_filename + " " + tmp_reads_filename + " > /dev/null 2>&1";
-					cmd2 = "abpoa";
-					if(mean_read_len>=MIN_SEQ_LEN_USING_MINIMIZER) cmd2 =+ " -S";
-					cmd2 += " -o " + tmp_cons_filename + " " + tmp_reads_filename + " > /dev/null 2>&1";
-
-					//cout << cmd2 << endl;
-					system(cmd2.c_str());
-
-					pthread_mutex_lock(&mutex_mem);
-					work_num --;
-					if(work_num<0){
-						cerr << "line=" << __LINE__ << ", work_num=" << work_num << ", error." << endl;
-						exit(1);
-					}
-					pthread_mutex_unlock(&mutex_mem);
-
-					break;
+		if(n_seqs>=(size_t)min_supp_num*READS_NUM_SUPPORT_FACTOR){ // only use sufficient reads data to generate consensus sequence
+			// reserve the memory tokens before launching abPOA
+			mem_cost = estimateMemCostByReads(MEM_JOB_POA, seqs_vec.at(k)->seqs.size(), getTotalSeqLen(seqs_vec.at(k)->seqs));
+			acquireMemTokens(MEM_JOB_POA, mem_cost);
+
+			cons_seq_vec.clear();
+			poa_flag = poaConsByLib(seqs_vec.at(k)->seqs, seeding_flag, cons_seq_vec);
+			if(poa_flag==false){ // fall back to the external binary
+				if(reads_kept_flag==false) saveClusterReads(tmp_reads_filename, k, true);
+				if(tmpdir_flag==false){
+					mkdir(tmpdir.c_str(), S_IRWXU | S_IRWXG | S_IROTH | S_IXOTH);
+					tmpdir_flag = true;
 				}
+				poaConsByCmd(tmp_reads_filename, k, seeding_flag, cons_seq_vec);
+				lib_flag = false;
 			}
 
-			flag = isFileExist(tmp_cons_filename);
-			if(flag){
-				FastaSeqLoader fa_loader(tmp_cons_filename);
-				for(i=0; i<fa_loader.getFastaSeqCount(); i++){
-					if(fa_loader.getFastaSeqLen(i)>0){
-						cons_header = ">abpoa_cns_";
-						cons_header += to_string(serial_number) + "_"; //serial number
-						cons_header += to_string(fa_loader.getFastaSeqLen(i)) + "_"; //consensus sequence length
-						cons_header += to_string(seqs_vec.at(k)->seqs.size()) + "-";  // reads count
+			releaseMemTokens(mem_cost);
 
-						for(j=0; j<seqs_vec.at(k)->qname.size()-1; j++) cons_header += seqs_vec.at(k)->qname.at(j) + "-";
-						cons_header += seqs_vec.at(k)->qname.at(seqs_vec.at(k)->qname.size()-1);
+			for(i=0; i<cons_seq_vec.size(); i++){
+				if(cons_seq_vec.at(i).size()>0){
+					cons_header = ">abpoa_cns_";
+					cons_header += to_string(serial_number) + "_"; //serial number
+					cons_header += to_string(cons_seq_vec.at(i).size()) + "_"; //consensus sequence length
+					cons_header += to_string(seqs_vec.at(k)->seqs.size()) + "-";  // reads count
 
-						pthread_mutex_lock(&mutex_write);
-						cons_file << cons_header << endl; // header
-						cons_file << fa_loader.getFastaSeq(i) << endl;  // seq
-						//cons_file.flush();
-						pthread_mutex_unlock(&mutex_write);
+					for(j=0; j<seqs_vec.at(k)->qname.size()-1; j++) cons_header += seqs_vec.at(k)->qname.at(j) + "-";
+					cons_header += seqs_vec.at(k)->qname.at(seqs_vec.at(k)->qname.size()-1);
 
-						serial_number ++;
-					}
+					pthread_mutex_lock(&mutex_write);
+					cons_file << cons_header << endl; // header
+					cons_file << cons_seq_vec.at(i) << endl;  // seq
+					//cons_file.flush();
+					pthread_mutex_unlock(&mutex_write);
+
+					serial_number ++;
 				}
 			}
-		}else{
-			reads_file.close();
 		}
 	}
 
@@ -1752,19 +1884,173 @@ bool localCns::cnsByPoa(){
 		cns_success_flag = true;
 		//rename(tmp_cons_filename.c_str(), contigfilename.c_str());
 	}
-	system(cmd4.c_str());  // remove temporary files
+	if(tmpdir_flag) removeDir(tmpdir);  // remove temporary files
+
+	gettimeofday(&end_time, NULL);
+	addPoaLatency(lib_flag ? POA_PATH_LIB : POA_PATH_CMD, (clip_reg_flag==false and sv_len_est<=MAX_SMALL_INDEL_SIZE_POA_STAT), (end_time.tv_sec - start_time.tv_sec) + (end_time.tv_usec - start_time.tv_usec) / 1000000.0);
 
 	return flag;
 }
 
+// generate the consensus sequences of the given reads using the abPOA library
+bool localCns::poaConsByLib(vector<string> &seqs, bool seeding_flag, vector<string> &cons_seq_vec){
+#ifdef HAVE_LIBABPOA
+	abpoa_t *ab;
+	abpoa_para_t *abpt;
+	abpoa_cons_t *abc;
+	int32_t n_seqs, i, j, ret;
+	int *seq_lens;
+	uint8_t **bseqs;
+	string cons_seq;
+
+	n_seqs = seqs.size();
+	if(n_seqs==0) return false;
+
+	abpt = abpoa_init_para();
+	abpt->out_msa = 0;
+	abpt->out_cons = 1;
+	abpt->disable_seeding = seeding_flag ? 0 : 1;  // the '-S' option of 'abpoa'
+	abpoa_post_set_para(abpt);
+	ab = abpoa_init();
+
+	// encode the sequences
+	seq_lens = (int*) malloc(sizeof(int) * n_seqs);
+	bseqs = (uint8_t**) malloc(sizeof(uint8_t*) * n_seqs);
+	if(seq_lens==NULL or bseqs==NULL){
+		cerr << __func__ << ": cannot allocate memory" << endl;
+		exit(1);
+	}
+	for(i=0; i<n_seqs; i++){
+		seq_lens[i] = seqs.at(i).size();
+		bseqs[i] = (uint8_t*) malloc(sizeof(uint8_t) * (seq_lens[i] + 1));
+		if(bseqs[i]==NULL){
+			cerr << __func__ << ": cannot allocate memory" << endl;
+			exit(1);
+		}
+		for(j=0; j<seq_lens[i]; j++) bseqs[i][j] = poa_nt4_table[(uint8_t)seqs.at(i).at(j)];
+	}
+
+	ret = abpoa_msa(ab, abpt, n_seqs, NULL, seq_lens, bseqs, NULL, NULL);
+	if(ret==0){
+		abc = ab->abc;
+		for(i=0; i<abc->n_cons; i++){
+			cons_seq.resize(abc->cons_len[i]);
+			for(j=0; j<abc->cons_len[i]; j++) cons_seq[j] = "ACGTN"[abc->cons_base[i][j]];
+			cons_seq_vec.push_back(cons_seq);
+		}
+	}
+
+	for(i=0; i<n_seqs; i++) free(bseqs[i]);
+	free(bseqs);
+	free(seq_lens);
+	abpoa_free(ab);
+	abpoa_free_para(abpt);
+
+	return ret==0;
+#else
+	return false;
+#endif
+}
+
+// generate the consensus sequences of the given reads file using the external 'abpoa'
+bool localCns::poaConsByCmd(string &reads_filename, size_t cluster_id, bool seeding_flag, vector<string> &cons_seq_vec){
+	string tmp_cons_filename;
+	vector<string> argv_vec;
+	procOpt_t proc_opt;
+	procResult_t proc_result;
+	bool flag;
+
+	tmp_cons_filename = tmpdir + "/consensus_" + to_string(cluster_id) + ".fa";
+	argv_vec.push_back("abpoa");
+	if(seeding_flag) argv_vec.push_back("-S");
+	argv_vec.insert(argv_vec.end(), {"-o", tmp_cons_filename, reads_filename});
+
+	initProcOpt(proc_opt);
+	proc_opt.wall_timeout_sec = (int64_t)max_proc_running_minutes * 60;
+	if(runProcess(argv_vec, proc_opt, proc_result)==PROC_RET_FAILED) printProcFailure(__func__, argv_vec, proc_result);
+
+	flag = isFileExist(tmp_cons_filename);
+	if(flag){
+		FastaSeqLoader fa_loader(tmp_cons_filename);
+		for(size_t i=0; i<fa_loader.getFastaSeqCount(); i++) cons_seq_vec.push_back(fa_loader.getFastaSeq(i));
+	}
+
+	return flag;
+}
+
+// set the directory of consensus cache, empty for disabling the cache; the tool versions are
+// included in the cache keys, so that the cached consensus are not reused after tool upgrades
+void setCnsCacheDir(const string &cache_dir, const string &abpoa_version, const string &wtdbg2_version){
+	cns_cache_dir = cache_dir;
+	cns_cache_tool_versions = abpoa_version + "|" + wtdbg2_version;
+	if(cns_cache_dir.size()>0) mkdir(cns_cache_dir.c_str(), S_IRWXU | S_IRGRP | S_IXGRP | S_IROTH | S_IXOTH);
+}
+
+// reset the statistics of the consensus cache
+void resetCnsCacheStat(){
+	pthread_mutex_lock(&mutex_cns_cache_stat);
+	cns_cache_stat = (cnsCacheStat_t){0, 0};
+	pthread_mutex_unlock(&mutex_cns_cache_stat);
+}
+
+// get the statistics of the consensus cache
+cnsCacheStat_t getCnsCacheStat(){
+	cnsCacheStat_t stat;
+
+	pthread_mutex_lock(&mutex_cns_cache_stat);
+	stat = cns_cache_stat;
+	pthread_mutex_unlock(&mutex_cns_cache_stat);
+
+	return stat;
+}
+
+// add the latency of a abPOA consensus work
+void addPoaLatency(int32_t poa_path, bool small_indel_flag, double seconds){
+	pthread_mutex_lock(&mutex_poa_stat);
+	poa_latency_stat_arr[poa_path].work_num ++;
+	poa_latency_stat_arr[poa_path].seconds += seconds;
+	if(small_indel_flag){
+		poa_latency_stat_arr[poa_path].small_work_num ++;
+		poa_latency_stat_arr[poa_path].small_seconds += seconds;
+	}
+	pthread_mutex_unlock(&mutex_poa_stat);
+}
+
+// reset the latency statistics of abPOA consensus works
+void resetPoaLatencyStat(){
+	pthread_mutex_lock(&mutex_poa_stat);
+	for(int32_t i=0; i<POA_PATH_NUM; i++) poa_latency_stat_arr[i] = (poaLatencyStat_t){0, 0, 0, 0};
+	pthread_mutex_unlock(&mutex_poa_stat);
+}
+
+// print the mean latency of abPOA consensus works
+void printPoaLatencyStat(){
+	poaLatencyStat_t *stat;
+	const char *path_name_arr[POA_PATH_NUM] = { "library", "external binary" };
+
+	pthread_mutex_lock(&mutex_poa_stat);
+	for(int32_t i=0; i<POA_PATH_NUM; i++){
+		stat = &poa_latency_stat_arr[i];
+		if(stat->work_num==0) continue;
+		cout << "abPOA consensus by " << path_name_arr[i] << ": works=" << stat->work_num << ", mean_latency=" << stat->seconds / stat->work_num << " s";
+		if(stat->small_work_num>0) cout << ", small indel works=" << stat->small_work_num << ", mean_latency=" << stat->small_seconds / stat->small_work_num << " s";
+		cout << endl;
+	}
+	pthread_mutex_unlock(&mutex_poa_stat);
+}
+
 // local consensus using wtdbg2
 bool localCns::localCnsWtdbg2(){
-	bool flag, wtdbg2_flag;
-	string output_prefix, tmp_reg_str, tmp_cns_filename, cmd2, cmd3;
+	bool flag;
+	string output_prefix, tmp_reg_str, tmp_cns_filename;
 	string tmp_reads_filename, cons_header;
+	vector<string> argv_vec;
+	procOpt_t proc_opt;
+	procResult_t proc_result;
 	size_t id, k, i, j, n_seqs, serial_number;
-	ofstream cons_file, reads_file;
-	int64_t mem_avail;
+	ofstream cons_file;
+	int64_t mem_cost;
+	int32_t cpu_tokens;
 
 	// check the file
 	flag = isFileExist(contigfilename);
@@ -1786,50 +2072,24 @@ bool localCns::localCnsWtdbg2(){
 
 	serial_number = 1;
 	for(k=0; k<seqs_vec.size(); k++){
-		tmp_reads_filename = readsfilename_prefix + "_" + to_string(k) + readsfilename_suffix;
-		readsfilename_vec.push_back(tmp_reads_filename);  // save read file names
-		reads_file.open(tmp_reads_filename);
-		if(!reads_file.is_open()){
-			cerr << __func__ << ", line=" << __LINE__ << ": cannot open file " << tmp_reads_filename << endl;
-			exit(1);
-		}
-
+		tmp_reads_filename = getClusterReadsFilename(k);
 		n_seqs = seqs_vec.at(k)->seqs.size();
+		saveClusterReads(tmp_reads_filename, k, n_seqs>=(size_t)min_supp_num*READS_NUM_SUPPORT_FACTOR);
+
 		if(n_seqs>=(size_t)min_supp_num*READS_NUM_SUPPORT_FACTOR){ // only use sufficient reads data to generate consensus sequence
-			for (i = 0; i < n_seqs; ++i) reads_file << ">" << seqs_vec.at(k)->qname[i] << endl << seqs_vec.at(k)->seqs[i] << endl;
-			reads_file.close();
-
-			wtdbg2_flag = false;
-			while(1){
-				pthread_mutex_lock(&mutex_mem);
-				mem_avail = getMemInfo("MemAvailable", 2);
-				// prepare for alignment computation
-				if(mem_avail>=min_mem_avail and mem_total-mem_avail<=mem_total*mem_use_block_factor+extend_total*extend_use_block_factor){
-					work_num ++;
-					wtdbg2_flag = true;
-				}
-				pthread_mutex_unlock(&mutex_mem);
+			// reserve the memory tokens before launching wtdbg2
+			mem_cost = estimateMemCostByReads(MEM_JOB_WTDBG2, seqs_vec.at(k)->seqs.size(), getTotalSeqLen(seqs_vec.at(k)->seqs));
+			acquireMemTokens(MEM_JOB_WTDBG2, mem_cost);
 
-				if(wtdbg2_flag==false){ // block the alignment computation
-					//cout << "\t" << __func__ << ": wait " << mem_wait_seconds << " seconds, mem_avail=" << (mem_avail >> 10) << " MB, work_num=" << work_num << ", " << contigfilename << endl;
-					sleep(mem_wait_seconds);
-				}else{
-					output_prefix = "tmp_wtdbg2_" + tmp_reg_str;
-					cmd2 = "wtdbg2.pl -t 8 -x " + technology + " -o " + output_prefix + " -a -q " + tmp_reads_filename + " > /dev/null 2>&1";
-					//cout << cmd2 << endl;
-					system(cmd2.c_str());
-
-					pthread_mutex_lock(&mutex_mem);
-					work_num --;
-					if(work_num<0){
-						cerr << "line=" << __LINE__ << ", work_num=" << work_num << ", error." << endl;
-						exit(1);
-					}
-					pthread_mutex_unlock(&mutex_mem);
+			output_prefix = getScratchFilename("tmp_wtdbg2_" + tmp_reg_str);
+			cpu_tokens = acquireCpuTokens();  // thread number of wtdbg2 from the global CPU budget
+			argv_vec = {"wtdbg2.pl", "-t", to_string(cpu_tokens), "-x", technology, "-o", output_prefix, "-a", "-q", tmp_reads_filename};
+			initProcOpt(proc_opt);
+			proc_opt.wall_timeout_sec = (int64_t)max_proc_running_minutes * 60;
+			if(runProcess(argv_vec, proc_opt, proc_result)==PROC_RET_FAILED) printProcFailure(__func__, argv_vec, proc_result);
+			releaseCpuTokens(cpu_tokens);
 
-					break;
-				}
-			}
+			releaseMemTokens(mem_cost);
 
 			tmp_cns_filename = output_prefix + ".cns.fa";
 			flag = isFileExist(tmp_cns_filename);
@@ -1856,10 +2116,7 @@ bool localCns::localCnsWtdbg2(){
 				}
 			}
 
-			cmd3 = "rm -rf " + output_prefix + "*";
-			system(cmd3.c_str());  // remove temporary files
-		}else{
-			reads_file.close();
+			removeFilesByPrefix(output_prefix);  // remove temporary files
 		}
 	}
 
@@ -1886,7 +2143,8 @@ bool localCns::localCnsCanu(){
 
 // local consensus using Canu with increasing genome size parameter
 bool localCns::localCnsCanu_IncreaseGenomeSize(){
-	string canu_cmd, cns_prefix, cmd2, cmd3, cmd4, tmp_ctg_filename, gnuplotTested_str, min_inout_cov_str, technology_str; // fast_option;
+	string canu_cmd, cns_prefix, cmd2, cmd3, tmp_ctg_filename, gnuplotTested_str, min_inout_cov_str, technology_str; // fast_option;
+	vector<string> argv_vec;
 	int i, genomeSize_Canu, step_size;
 	bool flag;
 	string cmd_limited_threads_str, limited_threads_str;
@@ -1911,7 +2169,6 @@ bool localCns::localCnsCanu_IncreaseGenomeSize(){
 	cns_prefix = "cns";
 	tmp_ctg_filename = tmpdir + "/" + cns_prefix + ".contigs.fasta";
 	cmd2 = "mv " + tmp_ctg_filename + " " + contigfilename;   // move and rename file
-	cmd4 = "rm -rf " + tmpdir;  // delete files
 
 	// limited number threads
 	cmd_limited_threads_str = "";
@@ -1969,19 +2226,20 @@ bool localCns::localCnsCanu_IncreaseGenomeSize(){
 			cost_min = difftime(end_time, start_time) / 60.0;
 			if(cost_min<=MAX_CNS_MINUTES){
 				// try canu1.8, or 2.0
-				canu_cmd = "canu -p " + cns_prefix + " -d " + tmpdir + cmd_limited_threads_str + " genomeSize=" + to_string(genomeSize_Canu) + gnuplotTested_str + min_inout_cov_str + technology_str + readsfilename + " > /dev/null 2>&1";
+				canu_cmd = "canu -p " + cns_prefix + " -d " + tmpdir + cmd_limited_threads_str + " genomeSize=" + to_string(genomeSize_Canu) + gnuplotTested_str + min_inout_cov_str + technology_str + readsfilename;
 				//cout << canu_cmd << endl;
-				system(canu_cmd.c_str());  // local consensus, invoke Canu command
+				argv_vec = split(canu_cmd, " ");
+				runProcess(argv_vec, (int64_t)max_proc_running_minutes * 60);  // local consensus, invoke Canu command
 
 				// save consensus result and remove temporary files if successfully consensused
 				flag = isFileExist(tmp_ctg_filename);
 				if(flag){ // contig generated successfully
 					cns_success_flag = true;
 					rename(tmp_ctg_filename.c_str(), contigfilename.c_str());
-					system(cmd4.c_str());  // remove temporary files
+					removeDir(tmpdir);  // remove temporary files
 					break;
 				}else { // contig generated failed
-					system(cmd4.c_str());  // remove temporary files
+					removeDir(tmpdir);  // remove temporary files
 					genomeSize_Canu += i * step_size;
 				}
 			}else break;
@@ -1992,7 +2250,8 @@ bool localCns::localCnsCanu_IncreaseGenomeSize(){
 
 // local consensus using Canu with decreasing genome size parameter
 bool localCns::localCnsCanu_DecreaseGenomeSize(){
-	string canu_cmd, cns_prefix, cmd2, cmd3, cmd4, tmp_ctg_filename, gnuplotTested_str, min_inout_cov_str, technology_str; //, fast_option;
+	string canu_cmd, cns_prefix, cmd2, cmd3, tmp_ctg_filename, gnuplotTested_str, min_inout_cov_str, technology_str; //, fast_option;
+	vector<string> argv_vec;
 	int i, genomeSize_Canu, step_size;
 	bool flag;
 	string cmd_limited_threads_str, limited_threads_str;
@@ -2017,7 +2276,6 @@ bool localCns::localCnsCanu_DecreaseGenomeSize(){
 	cns_prefix = "cns";
 	tmp_ctg_filename = tmpdir + "/" + cns_prefix + ".contigs.fasta";
 	cmd2 = "mv " + tmp_ctg_filename + " " + contigfilename;   // move and rename file
-	cmd4 = "rm -rf " + tmpdir;  // delete files
 
 	// limited number threads
 	cmd_limited_threads_str = "";
@@ -2075,19 +2333,20 @@ bool localCns::localCnsCanu_DecreaseGenomeSize(){
 			cost_min = difftime(end_time, start_time) / 60.0;
 			if(cost_min<=MAX_CNS_MINUTES){
 				// try canu1.8, or 2.0
-				canu_cmd = "canu -p " + cns_prefix + " -d " + tmpdir + cmd_limited_threads_str + " genomeSize=" + to_string(genomeSize_Canu) + gnuplotTested_str + min_inout_cov_str + technology_str + readsfilename + " > /dev/null 2>&1";
+				canu_cmd = "canu -p " + cns_prefix + " -d " + tmpdir + cmd_limited_threads_str + " genomeSize=" + to_string(genomeSize_Canu) + gnuplotTested_str + min_inout_cov_str + technology_str + readsfilename;
 				//cout << canu_cmd << endl;
-				system(canu_cmd.c_str());  // local consensus, invoke Canu command
+				argv_vec = split(canu_cmd, " ");
+				runProcess(argv_vec, (int64_t)max_proc_running_minutes * 60);  // local consensus, invoke Canu command
 
 				// save consensus result and remove temporary files if successfully consensused
 				flag = isFileExist(tmp_ctg_filename);
 				if(flag){ // contig generated successfully
 					cns_success_flag = true;
 					rename(tmp_ctg_filename.c_str(), contigfilename.c_str());
-					system(cmd4.c_str());  // remove temporary files
+					removeDir(tmpdir);  // remove temporary files
 					break;
 				}else { // contig generated failed
-					system(cmd4.c_str());  // remove temporary files
+					removeDir(tmpdir);  // remove temporary files
 					genomeSize_Canu -= i * step_size;
 				}
 			}else break;
@@ -2098,6 +2357,15 @@ bool localCns::localCnsCanu_DecreaseGenomeSize(){
 
 // record consensus information
 void localCns::recordCnsInfo(ofstream &cns_info_file){
+	string line = getCnsInfoLine();
+
+	pthread_mutex_lock(&mutex_write);
+	cns_info_file << line << endl;
+	pthread_mutex_unlock(&mutex_write);
+}
+
+// get the consensus information line
+string localCns::getCnsInfoLine(){
 	string line, cns_status, header, left_shift_size_str, right_shift_size_str, reg_str, sampling_str, limit_reg_str, limit_reg_str2;
 	reg_t *reg;
 	ifstream infile;
@@ -2167,7 +2435,5 @@ void localCns::recordCnsInfo(ofstream &cns_info_file){
 	// done string
 	line = line + "\t" + DONE_STR;
 
-	pthread_mutex_lock(&mutex_write);
-	cns_info_file << line << endl;
-	pthread_mutex_unlock(&mutex_write);
+	return line;
 }
@@ -5,8 +5,15 @@
 #include <string>
 #include <fstream>
 #include <vector>
+#include <algorithm>
+#include <map>
 #include <limits.h>
 #include <sys/stat.h>
+#include <sys/time.h>
+
+#ifdef HAVE_LIBABPOA
+#include <abpoa.h>
+#endif
 
 #include <htslib/sam.h>
 #include <htslib/hts.h>
@@ -30,6 +37,28 @@ using namespace std;
 
 #define POA_ALIGN_DEBUG					0
 
+// abPOA consensus paths
+#define POA_PATH_LIB					0	// abPOA library
+#define POA_PATH_CMD					1	// external 'abpoa' binary
+#define POA_PATH_NUM					2
+
+#define MAX_SMALL_INDEL_SIZE_POA_STAT	100	// maximal size of small indels in the latency statistics
+
+// latency statistics of abPOA consensus works
+typedef struct{
+	int64_t work_num, small_work_num;
+	double seconds, small_seconds;
+}poaLatencyStat_t;
+
+#define CNS_CACHE_KEY_VERSION			"1"	// changed when the consensus generation is changed, then the old cached items are missed
+
+// statistics of the consensus cache
+typedef struct{
+	int64_t lookup_num, hit_num;
+}cnsCacheStat_t;
+
+// key of the merged signatures of a query within a span window: (query, (startSpanPos, endSpanPos))
+typedef pair<struct querySeqInfoNode*, pair<int64_t, int64_t>> qcSigCacheKey_t;
 
 class localCns {
 	public:
@@ -38,6 +67,7 @@ class localCns {
 		vector<string> readsfilename_vec;
 		int64_t chrlen, cns_extend_size, startRefPos_cns, endRefPos_cns;
 		int32_t num_threads_per_cns_work, minClipEndSize, minConReadLen, min_sv_size, min_supp_num, minMapQ: 16, minHighMapQ: 16, sv_len_est;
+		int32_t max_proc_running_minutes;
 		double max_ultra_high_cov, max_seg_size_ratio, min_identity_match;
 		bool cns_success_preDone_flag, cns_success_flag, use_poa_flag, clip_reg_flag;
 		double min_input_cov_canu;
@@ -63,8 +93,11 @@ class localCns {
 		vector<bam1_t*> alnDataVector;
 		vector<clipAlnData_t*> clipAlnDataVector;
 
+		// merged signatures of the queries during clustering, each is extracted once per span window
+		map<qcSigCacheKey_t, queryCluSig_t*> qc_sig_cache;
+
 	public:
-		localCns(string &readsfilename, string &contigfilename, string &refseqfilename, string &clusterfilename, string &tmpdir, string &technology, double min_identity_match, int32_t sv_len_est, size_t num_threads_per_cns_work, vector<reg_t*> &varVec, string &chrname, string &inBamFile, faidx_t *fai, size_t cns_extend_size, double expected_cov, double min_input_cov, double max_ultra_high_cov, int32_t minMapQ, int32_t minHighMapQ, bool delete_reads_flag, bool keep_failed_reads_flag, bool clip_reg_flag, int32_t minClipEndSize, int32_t minConReadLen, int32_t min_sv_size, int32_t min_supp_num, double max_seg_size_ratio);
+		localCns(string &readsfilename, string &contigfilename, string &refseqfilename, string &clusterfilename, string &tmpdir, string &technology, double min_identity_match, int32_t sv_len_est, size_t num_threads_per_cns_work, vector<reg_t*> &varVec, string &chrname, string &inBamFile, faidx_t *fai, size_t cns_extend_size, double expected_cov, double min_input_cov, double max_ultra_high_cov, int32_t minMapQ, int32_t minHighMapQ, bool delete_reads_flag, bool keep_failed_reads_flag, bool clip_reg_flag, int32_t minClipEndSize, int32_t minConReadLen, int32_t min_sv_size, int32_t min_supp_num, double max_seg_size_ratio, int32_t max_proc_running_minutes);
 		virtual ~localCns();
 		void extractRefseq();
 		void extractReadsDataFromBAM();
@@ -73,11 +106,19 @@ class localCns {
 		bool cnsByPoa();
 		bool localConsensus();
 		void recordCnsInfo(ofstream &cns_info_file);
+		string getCnsInfoLine();
 		void setLimitRegs(bool limit_reg_process_flag, vector<simpleReg_t*> limit_reg_vec);
 
 	private:
 		void destoryClipAlnData();
 		void destorySeqsVec(vector<struct seqsVec*> &seqs_vec);//
+		bool poaConsByLib(vector<string> &seqs, bool seeding_flag, vector<string> &cons_seq_vec);
+		bool poaConsByCmd(string &reads_filename, size_t cluster_id, bool seeding_flag, vector<string> &cons_seq_vec);
+		string getClusterReadsFilename(size_t cluster_id);
+		string getCnsCacheKey();
+		bool loadCnsFromCache(string &cache_key);
+		void saveCnsToCache(string &cache_key);
+		void saveClusterReads(string &reads_filename, size_t cluster_id, bool save_seqs_flag);
 		void destoryQueryCluVec(vector<struct querySeqInfoVec*> &query_clu_vec);
 		void destoryQueryCluVecClipReg(vector<qcSigListVec_t*> &query_clu_vec_clipReg);
 		void destroyQueryQcSig(queryCluSig_t *qc_Sig);
@@ -88,6 +129,8 @@ class localCns {
 		void sortQueryInfoByNumCategory(vector<struct querySeqInfoNode*> &query_seq_info_vec);
 		void resucueCluster(vector<struct querySeqInfoNode*> &query_seq_info_all, vector<struct querySeqInfoNode*> &q_cluster_a, vector<struct querySeqInfoNode*> &q_cluster_b);
 		double computeScoreRatio(struct querySeqInfoNode *query_seq_info_node, struct querySeqInfoNode *q_cluster_node, int64_t startSpanPos, int64_t endSpanPos, int32_t min_sv_size);
+		queryCluSig_t* getQcSigsInSpan(struct querySeqInfoNode *query_seq_info_node, int64_t startSpanPos, int64_t endSpanPos, int32_t min_sv_size);
+		void clearQcSigCache();
 		vector<int8_t> computeQcMatchProfileSingleQuery(queryCluSig_t *queryCluSig, queryCluSig_t *seed_qcQuery);
 		vector<int8_t> qComputeSigMatchProfile(struct alnScoreNode *scoreArr, int32_t rowsNum, int32_t colsNum, queryCluSig_t *queryCluSig, queryCluSig_t *seed_qcQuery);
 		struct seedQueryInfo* chooseSeedClusterQuery(struct querySeqInfoNode* query_seq_info_node, vector<struct querySeqInfoNode*> &q_cluster);
@@ -109,4 +152,11 @@ class localCns {
 		int32_t getLeftMostAlnSeg(vector<clipAlnData_t*> &query_aln_segs);
 };
 
+void addPoaLatency(int32_t poa_path, bool small_indel_flag, double seconds);
+void resetPoaLatencyStat();
+void printPoaLatencyStat();
+void setCnsCacheDir(const string &cache_dir, const string &abpoa_version, const string &wtdbg2_version);
+void resetCnsCacheStat();
+cnsCacheStat_t getCnsCacheStat();
+
 #endif /* SRC_LOCALCNS_H_ */
@@ -7,7 +7,7 @@ int64_t mem_total = 0;		// in kB
 int64_t swap_total = 0;	// in kB
 int64_t extend_total = 0;	// in kB, the minimum of mem_total and swap_total
 
-int64_t mem_seqAln = 0;		// in kB
+int64_t mem_seqAln = 0;		// in kB, memory tokens reserved by the running jobs
 double mem_use_block_factor = 0.7; // 0.9, 0.8
 double extend_use_block_factor = 0.1;
 int32_t mem_wait_seconds = 1;	// wait time  // 2
@@ -16,21 +16,223 @@ int64_t min_mem_avail = (1L << 24);	// minimum memory available, in kB
 int32_t work_num = 0;
 
 pthread_mutex_t mutex_mem = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t cond_mem = PTHREAD_COND_INITIALIZER;
 
-// get memory information (in kB, 1024 bytes) by awk (or grep) command
+// the blocked jobs are admitted in FIFO order of their tickets
+int64_t mem_next_ticket = 0, mem_serving_ticket = 0;
+memAdmitStat_t mem_admit_stat_arr[MEM_JOB_TYPE_NUM];
+const char *mem_job_name_arr[MEM_JOB_TYPE_NUM] = { "abPOA", "wtdbg2", "alignment" };
+
+// cached memory information, it is refreshed after MEMINFO_CACHE_TTL_MS
+map<string, int64_t> meminfo_cache;
+int64_t meminfo_cache_time_ms = -1;
+pthread_mutex_t mutex_meminfo = PTHREAD_MUTEX_INITIALIZER;
+
+// get the monotonic time in milliseconds
+static int64_t getMonotonicTimeMs(){
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+// read the first line of a cgroup file, the return value is -1 for failure, and INT64_MAX for 'max'
+int64_t readCgroupValue(const string &filename){
+	FILE *fp;
+	char line[256];
+	int64_t value = -1;
+
+	fp = fopen(filename.c_str(), "r");
+	if(fp==NULL) return -1;
+	if(fgets(line, sizeof(line), fp)){
+		if(strncmp(line, "max", 3)==0) value = INT64_MAX;
+		else value = atoll(line);
+	}
+	fclose(fp);
+
+	return value;
+}
+
+// get the cgroup-v2 directory of this process, empty string for none
+string getCgroupV2Dir(){
+	FILE *fp;
+	char line[1024];
+	string cgroup_path, cgroup_root, cgroup_dir;
+	size_t len;
+
+	// cgroup-v2 entry: 0::/path
+	fp = fopen("/proc/self/cgroup", "r");
+	if(fp==NULL) return "";
+	while(fgets(line, sizeof(line), fp)){
+		if(strncmp(line, "0::", 3)==0){
+			cgroup_path = line + 3;
+			len = cgroup_path.size();
+			if(len>0 and cgroup_path.at(len-1)=='\n') cgroup_path.resize(len-1);
+			break;
+		}
+	}
+	fclose(fp);
+	if(cgroup_path.empty()) return "";
+
+	// unified mount point or hybrid mount point
+	if(access("/sys/fs/cgroup/cgroup.controllers", F_OK)==0) cgroup_root = "/sys/fs/cgroup";
+	else if(access("/sys/fs/cgroup/unified/cgroup.controllers", F_OK)==0) cgroup_root = "/sys/fs/cgroup/unified";
+	else return "";
+
+	cgroup_dir = cgroup_root + cgroup_path;
+	if(access((cgroup_dir + "/memory.max").c_str(), F_OK)!=0) cgroup_dir = cgroup_root;  // the namespaced path, e.g. inside container
+
+	return cgroup_dir;
+}
+
+// load /proc/meminfo (in kB) into cache, and limit MemTotal and MemAvailable by the cgroup-v2 memory.max and memory.current
+static void loadMemInfo(map<string, int64_t> &meminfo_map){
+	FILE *fp;
+	char line[256], name[128];
+	long long value;
+	int64_t cg_max, cg_current, cg_avail;
+	string cgroup_dir;
+	map<string, int64_t>::iterator it;
+
+	meminfo_map.clear();
+	fp = fopen("/proc/meminfo", "r");
+	if(fp==NULL){
+		cerr << __func__ << ", line=" << __LINE__ << ": cannot open file /proc/meminfo" << endl;
+		return;
+	}
+	while(fgets(line, sizeof(line), fp)){
+		if(sscanf(line, "%127[^:]: %lld", name, &value)==2) meminfo_map[name] = value;
+	}
+	fclose(fp);
+
+	cgroup_dir = getCgroupV2Dir();
+	if(cgroup_dir.empty()) return;
+	cg_max = readCgroupValue(cgroup_dir + "/memory.max");
+	cg_current = readCgroupValue(cgroup_dir + "/memory.current");
+	if(cg_max<=0 or cg_max==INT64_MAX) return;  // no memory limit
+
+	cg_max >>= 10;
+	it = meminfo_map.find("MemTotal");
+	if(it!=meminfo_map.end() and it->second>cg_max) it->second = cg_max;
+	if(cg_current>=0){
+		cg_avail = cg_max - (cg_current >> 10);
+		if(cg_avail<0) cg_avail = 0;
+		it = meminfo_map.find("MemAvailable");
+		if(it!=meminfo_map.end() and it->second>cg_avail) it->second = cg_avail;
+	}
+}
+
+// get memory information (in kB, 1024 bytes) from /proc/meminfo, limited by the cgroup-v2 memory limit;
+// only the value column (index 2) is supported
 int64_t getMemInfo(const char *name, int32_t index){
-	int64_t info_int = -1;
-	FILE *stream;
-	char tmp[256], info[128];
+	int64_t info_int = -1, cur_time_ms;
+	map<string, int64_t>::iterator it;
+
+	if(index!=2) return -1;
 
-	//sprintf(tmp, "cat /proc/meminfo | grep %s | awk '{print $%d}'", name, index);
-	sprintf(tmp, "cat /proc/meminfo | awk '$1 ~/%s/' | awk '{print $%d}'", name, index);
-	stream = popen(tmp, "r");
-	if(fread(info, 1, sizeof(info), stream)>0){
-		info_int = atol(info);
+	pthread_mutex_lock(&mutex_meminfo);
+	cur_time_ms = getMonotonicTimeMs();
+	if(meminfo_cache_time_ms<0 or cur_time_ms-meminfo_cache_time_ms>=MEMINFO_CACHE_TTL_MS){
+		loadMemInfo(meminfo_cache);
+		meminfo_cache_time_ms = cur_time_ms;
 	}
-	pclose(stream);
+	it = meminfo_cache.find(name);
+	if(it!=meminfo_cache.end()) info_int = it->second;
+	pthread_mutex_unlock(&mutex_meminfo);
 
 	return info_int;
 }
 
+// estimate the memory footprint (in kB) of the consensus job according to its reads
+int64_t estimateMemCostByReads(int32_t job_type, int64_t read_num, int64_t total_read_len){
+	int64_t mem_cost;
+
+	if(job_type==MEM_JOB_WTDBG2) mem_cost = MEM_COST_BASE_WTDBG2 + ((read_num * MEM_BYTES_PER_READ_WTDBG2 + total_read_len * MEM_BYTES_PER_BASE_WTDBG2) >> 10);
+	else mem_cost = MEM_COST_BASE_POA + ((read_num * MEM_BYTES_PER_READ_POA + total_read_len * MEM_BYTES_PER_BASE_POA) >> 10);
+
+	return mem_cost;
+}
+
+// check whether the memory tokens can be reserved, the mutex_mem should be held by the caller
+static bool isMemTokensAvailable(int32_t job_type, int64_t mem_cost){
+	int64_t mem_avail;
+
+	if(work_num==0) return true;  // always admit a single job to avoid deadlock
+	if(mem_seqAln+mem_cost>mem_total*mem_use_block_factor+extend_total*extend_use_block_factor) return false;
+
+	// the memory used by other processes is also considered for the external jobs
+	if(job_type==MEM_JOB_SEQ_ALN) return true;
+	mem_avail = getMemInfo("MemAvailable", 2);
+	if(mem_avail<min_mem_avail or mem_total-mem_avail>mem_total*mem_use_block_factor+extend_total*extend_use_block_factor) return false;
+
+	return true;
+}
+
+// reserve the memory tokens (in kB) for a job, and block on cond_mem until sufficient tokens are released by the running jobs;
+// the admission is also re-checked every mem_wait_seconds, as the memory used by other processes may be freed without any release
+void acquireMemTokens(int32_t job_type, int64_t mem_cost){
+	int64_t ticket;
+	struct timeval start_time, end_time;
+	struct timespec wake_time;
+	double wait_seconds;
+	memAdmitStat_t *admit_stat = &mem_admit_stat_arr[job_type];
+
+	pthread_mutex_lock(&mutex_mem);
+	ticket = mem_next_ticket ++;
+	if(ticket!=mem_serving_ticket or isMemTokensAvailable(job_type, mem_cost)==false){
+		admit_stat->queue_depth ++;
+		if(admit_stat->max_queue_depth<admit_stat->queue_depth) admit_stat->max_queue_depth = admit_stat->queue_depth;
+		gettimeofday(&start_time, NULL);
+		while(ticket!=mem_serving_ticket or isMemTokensAvailable(job_type, mem_cost)==false){
+			clock_gettime(CLOCK_REALTIME, &wake_time);
+			wake_time.tv_sec += mem_wait_seconds;
+			pthread_cond_timedwait(&cond_mem, &mutex_mem, &wake_time);
+		}
+		gettimeofday(&end_time, NULL);
+		wait_seconds = (end_time.tv_sec - start_time.tv_sec) + (end_time.tv_usec - start_time.tv_usec) / 1000000.0;
+		admit_stat->queue_depth --;
+		admit_stat->wait_num ++;
+		admit_stat->wait_seconds += wait_seconds;
+		if(admit_stat->max_wait_seconds<wait_seconds) admit_stat->max_wait_seconds = wait_seconds;
+	}
+	mem_serving_ticket ++;
+	mem_seqAln += mem_cost;
+	work_num ++;
+	admit_stat->admit_num ++;
+	pthread_cond_broadcast(&cond_mem);  // the next ticket may be admitted
+	pthread_mutex_unlock(&mutex_mem);
+}
+
+// release the memory tokens (in kB) of a finished job, and wake up the blocked jobs
+void releaseMemTokens(int64_t mem_cost){
+	pthread_mutex_lock(&mutex_mem);
+	mem_seqAln -= mem_cost;
+	work_num --;
+	if(mem_seqAln<0 or work_num<0){
+		cerr << "line=" << __LINE__ << ", mem_seqAln=" << mem_seqAln << ", work_num=" << work_num << ", error." << endl;
+		exit(1);
+	}
+	pthread_cond_broadcast(&cond_mem);
+	pthread_mutex_unlock(&mutex_mem);
+}
+
+// reset the statistics of memory admission
+void resetMemAdmitStat(){
+	pthread_mutex_lock(&mutex_mem);
+	for(int32_t i=0; i<MEM_JOB_TYPE_NUM; i++) mem_admit_stat_arr[i] = (memAdmitStat_t){0, 0, 0, 0, 0, 0};
+	pthread_mutex_unlock(&mutex_mem);
+}
+
+// print the queue depth and wait time of memory admission
+void printMemAdmitStat(const char *stage_name){
+	memAdmitStat_t *admit_stat;
+	double mean_wait_seconds;
+
+	pthread_mutex_lock(&mutex_mem);
+	for(int32_t i=0; i<MEM_JOB_TYPE_NUM; i++){
+		admit_stat = &mem_admit_stat_arr[i];
+		if(admit_stat->admit_num==0) continue;
+		mean_wait_seconds = (admit_stat->wait_num>0) ? admit_stat->wait_seconds / admit_stat->wait_num : 0;
+		cout << "Memory admission of " << mem_job_name_arr[i] << " jobs in " << stage_name << ": admitted=" << admit_stat->admit_num << ", blocked=" << admit_stat->wait_num << ", max_queue_depth=" << admit_stat->max_queue_depth << ", wait_seconds=" << admit_stat->wait_seconds << " (mean " << mean_wait_seconds << ", max " << admit_stat->max_wait_seconds << ")" << endl;
+	}
+	pthread_mutex_unlock(&mutex_mem);
+}
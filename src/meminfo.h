@@ -2,9 +2,39 @@
 #define SRC_MEMINFO_H_
 
 #include <iostream>
+#include <string>
+#include <map>
+#include <cstring>
+#include <pthread.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/time.h>
 
 using namespace std;
 
+#define MEMINFO_CACHE_TTL_MS		200		// time to live of the cached memory information, in milliseconds
+
+// types of the memory-gated jobs
+#define MEM_JOB_POA					0		// abPOA consensus
+#define MEM_JOB_WTDBG2				1		// wtdbg2 consensus
+#define MEM_JOB_SEQ_ALN				2		// in-process sequence alignment
+#define MEM_JOB_TYPE_NUM			3
+
+// estimated memory footprint of the external consensus jobs, in kB
+#define MEM_COST_BASE_POA			(1L << 16)	// 64 MB
+#define MEM_BYTES_PER_BASE_POA		512
+#define MEM_BYTES_PER_READ_POA		(1L << 16)	// per-read alignment path and MSA row
+#define MEM_COST_BASE_WTDBG2		(1L << 20)	// 1 GB
+#define MEM_BYTES_PER_BASE_WTDBG2	128
+#define MEM_BYTES_PER_READ_WTDBG2	(1L << 12)
+
+// statistics of memory admission of each job type
+typedef struct{
+	int64_t admit_num, wait_num;		// admitted jobs, admitted jobs which had been blocked
+	int32_t queue_depth, max_queue_depth;
+	double wait_seconds, max_wait_seconds;
+}memAdmitStat_t;
+
 // global variables
 extern int64_t mem_total;		// in kB
 //int64_t mem_free;		// in kB
@@ -21,8 +51,16 @@ extern int64_t min_mem_avail;	// minimum memory available, in kB
 extern int32_t work_num;
 
 extern pthread_mutex_t mutex_mem;
+extern pthread_cond_t cond_mem;
 
+int64_t readCgroupValue(const string &filename);
+string getCgroupV2Dir();
 int64_t getMemInfo(const char *name, int32_t index);
+int64_t estimateMemCostByReads(int32_t job_type, int64_t read_num, int64_t total_read_len);
+void acquireMemTokens(int32_t job_type, int64_t mem_cost);
+void releaseMemTokens(int64_t mem_cost);
+void resetMemAdmitStat();
+void printMemAdmitStat(const char *stage_name);
 
 
 #endif /* SRC_MEMINFO_H_ */
@@ -0,0 +1,80 @@
+#include "minimizer.h"
+
+// 2-bit code of the bases, 4 for the others
+static const uint8_t minimizer_base_code[256] = {
+    4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+    4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+    4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+    4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+    4, 0, 4, 1, 4, 4, 4, 2, 4, 4, 4, 4, 4, 4, 4, 4,    // A, C, G
+    4, 4, 4, 4, 3, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,    // T
+    4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+    4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+    4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+    4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+    4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+    4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+    4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+    4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+    4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+    4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4
+};
+
+// minimizers of all windows of 'windowSize' k-mers: the k-mers are hashed by rolling their 2-bit codes,
+// and the minimum of each window is kept at the front of a monotone deque of the k-mers in the window;
+// the leftmost one is chosen among equal minima, k-mers of other bases than upper case ACGT are skipped,
+// and a minimizer is not repeated by the successive windows
+vector<Minimizer> findMinimizers(const string& sequence, size_t windowSize, size_t kmerSize) {
+    vector<Minimizer> minimizers;
+    vector<size_t> deque_pos;          // k-mer positions of the deque, ring buffer of 'windowSize' items
+    vector<uint64_t> deque_hash;
+    size_t i, pos, valid_len, head, tail, num, idx;
+    uint64_t hashValue, mask;
+    uint8_t code;
+
+    if (windowSize == 0 or kmerSize == 0 or kmerSize > MINIMIZER_MAX_KMER_SIZE or sequence.size() < windowSize + kmerSize - 1) return minimizers;
+
+    mask = (1ULL << (2 * kmerSize)) - 1;
+    deque_pos.resize(windowSize);
+    deque_hash.resize(windowSize);
+    head = tail = num = 0;
+    hashValue = valid_len = 0;
+
+    for (i = 0; i < sequence.size(); i++) {
+        code = minimizer_base_code[(uint8_t)sequence[i]];
+        if (code < 4) {
+            hashValue = ((hashValue << 2) | code) & mask;
+            valid_len++;
+        }
+        else valid_len = 0;
+        if (i + 1 < kmerSize) continue;
+        pos = i + 1 - kmerSize;    // the k-mer ending at i
+
+        // drop the k-mer leaving the window
+        if (num > 0 and pos >= windowSize and deque_pos[head] <= pos - windowSize) {
+            head = (head + 1) % windowSize;
+            num--;
+        }
+        // push the k-mer, the larger ones before it cannot be the minimum any more
+        if (valid_len >= kmerSize) {
+            while (num > 0) {
+                idx = (tail + windowSize - 1) % windowSize;
+                if (deque_hash[idx] <= hashValue) break;
+                tail = idx;
+                num--;
+            }
+            deque_pos[tail] = pos;
+            deque_hash[tail] = hashValue;
+            tail = (tail + 1) % windowSize;
+            num++;
+        }
+
+        // minimizer of the window ending at the k-mer
+        if (pos + 1 >= windowSize and num > 0) {
+            if (minimizers.empty() or minimizers.back().hashValue != deque_hash[head] or minimizers.back().position != deque_pos[head])
+                minimizers.push_back(Minimizer(deque_pos[head], deque_hash[head], false));
+        }
+    }
+
+    return minimizers;
+}
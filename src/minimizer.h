@@ -0,0 +1,25 @@
+#ifndef SRC_MINIMIZER_H_
+#define SRC_MINIMIZER_H_
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+using namespace std;
+
+#define MINIMIZER_MAX_KMER_SIZE		31		// the 2-bit codes of a k-mer are kept in 64 bits
+
+// minimizer of a window, the k-mer is at 'position' of the sequence
+struct Minimizer {
+    size_t position;
+    size_t hashValue;       // 2-bit codes of the k-mer, A=0, C=1, G=2, T=3
+    bool matchflag;
+
+    Minimizer(size_t pos, size_t hash, bool match)
+        : position(pos), hashValue(hash), matchflag(match) {}
+};
+
+vector<Minimizer> findMinimizers(const string& sequence, size_t windowSize, size_t kmerSize);
+
+#endif /* SRC_MINIMIZER_H_ */
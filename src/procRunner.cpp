@@ -0,0 +1,370 @@
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <csignal>
+#include <fcntl.h>
+#include <poll.h>
+#include <spawn.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+
+#include "procRunner.h"
+
+extern char **environ;
+
+// process watchdog: the children spawned by the runner are put into a hashed timer wheel by their deadlines,
+// and the wheel is advanced by a single thread, which sleeps when no child is watched
+static watchdogEntry_t *watchdog_wheel[WATCHDOG_WHEEL_SIZE];
+static int32_t watchdog_cur_slot = 0;
+static int64_t watchdog_entry_num = 0;
+static bool watchdog_started_flag = false;
+static pthread_mutex_t mutex_watchdog = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t cond_watchdog = PTHREAD_COND_INITIALIZER;
+
+int64_t proc_max_mem_bytes = 0;
+
+static double getElapsedSeconds(struct timeval &start_time){
+	struct timeval cur_time;
+	gettimeofday(&cur_time, NULL);
+	return (cur_time.tv_sec - start_time.tv_sec) + (cur_time.tv_usec - start_time.tv_usec) / 1000000.0;
+}
+
+static void closePipe(int32_t *pipe_fds){
+	for(int32_t i=0; i<2; i++){
+		if(pipe_fds[i]!=-1){
+			close(pipe_fds[i]);
+			pipe_fds[i] = -1;
+		}
+	}
+}
+
+// read the available data of the pipe, and close it at the end of file
+static void readPipe(int32_t &fd, string &out_str){
+	char buf[PROC_READ_BUF_SIZE];
+	ssize_t len;
+
+	len = read(fd, buf, PROC_READ_BUF_SIZE);
+	if(len>0) out_str.append(buf, len);
+	else if(len==0 or (errno!=EINTR and errno!=EAGAIN)){
+		close(fd);
+		fd = -1;
+	}
+}
+
+// read the data left in the pipe without blocking, as it may be still held by the orphaned descendants, then close it
+static void drainPipe(int32_t &fd, string &out_str){
+	char buf[PROC_READ_BUF_SIZE];
+	ssize_t len;
+
+	if(fd==-1) return;
+	fcntl(fd, F_SETFL, O_NONBLOCK);
+	while((len=read(fd, buf, PROC_READ_BUF_SIZE))>0 or (len==-1 and errno==EINTR))
+		if(len>0) out_str.append(buf, len);
+	close(fd);
+	fd = -1;
+}
+
+// spawn the child by posix_spawn in a new process group, the outputs are written to the given fds, or discarded if -1
+static int32_t spawnChild(pid_t &pid, vector<char*> &argv, int32_t out_fd, int32_t err_fd){
+	posix_spawn_file_actions_t file_actions;
+	posix_spawnattr_t attr;
+	int32_t ret;
+
+	posix_spawn_file_actions_init(&file_actions);
+	posix_spawn_file_actions_addopen(&file_actions, STDIN_FILENO, "/dev/null", O_RDONLY, 0);
+	if(out_fd!=-1) posix_spawn_file_actions_adddup2(&file_actions, out_fd, STDOUT_FILENO);
+	else posix_spawn_file_actions_addopen(&file_actions, STDOUT_FILENO, "/dev/null", O_WRONLY, 0);
+	if(err_fd!=-1) posix_spawn_file_actions_adddup2(&file_actions, err_fd, STDERR_FILENO);
+	else posix_spawn_file_actions_addopen(&file_actions, STDERR_FILENO, "/dev/null", O_WRONLY, 0);
+
+	posix_spawnattr_init(&attr);
+	posix_spawnattr_setpgroup(&attr, 0);
+	posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETPGROUP);
+
+	ret = posix_spawnp(&pid, argv.at(0), &file_actions, &attr, argv.data(), environ);
+
+	posix_spawn_file_actions_destroy(&file_actions);
+	posix_spawnattr_destroy(&attr);
+
+	return ret;
+}
+
+// find the executable of the program in $PATH as posix_spawnp does, as it cannot be searched in the child of vfork
+static bool findProgramPath(const string &prog_name, string &prog_path){
+	const char *path_env;
+	string path_str, dir_str;
+	size_t start_pos, end_pos;
+
+	if(prog_name.find('/')!=string::npos){
+		prog_path = prog_name;
+		return true;
+	}
+
+	path_env = getenv("PATH");
+	path_str = path_env ? path_env : "/bin:/usr/bin";
+	start_pos = 0;
+	while(start_pos<=path_str.size()){
+		end_pos = path_str.find(':', start_pos);
+		if(end_pos==string::npos) end_pos = path_str.size();
+		dir_str = path_str.substr(start_pos, end_pos-start_pos);
+		prog_path = (dir_str.empty() ? "." : dir_str) + "/" + prog_name;
+		if(access(prog_path.c_str(), X_OK)==0) return true;
+		start_pos = end_pos + 1;
+	}
+
+	return false;
+}
+
+// launch the child by vfork and set its memory limit before exec, as posix_spawn cannot set it; the child shares the
+// memory of the parent until exec without copying it, so it only makes async-signal-safe calls on the prepared arguments
+static int32_t vforkChildWithMemLimit(pid_t &pid, const char *prog_path, char **argv, int32_t out_fd, int32_t err_fd, int64_t max_mem_bytes){
+	struct rlimit rlim;
+	int32_t null_fd;
+
+	rlim.rlim_cur = rlim.rlim_max = max_mem_bytes;
+	pid = vfork();
+	if(pid==-1) return errno;
+	if(pid==0){
+		setpgid(0, 0);
+		null_fd = open("/dev/null", O_RDWR | O_CLOEXEC);
+		if(null_fd==-1 or setrlimit(RLIMIT_AS, &rlim)!=0) _exit(127);
+		dup2(null_fd, STDIN_FILENO);
+		dup2((out_fd!=-1) ? out_fd : null_fd, STDOUT_FILENO);
+		dup2((err_fd!=-1) ? err_fd : null_fd, STDERR_FILENO);
+		execve(prog_path, argv, environ);
+		_exit(127);
+	}
+
+	return 0;
+}
+
+// unlink the entry from its slot, the watchdog mutex should be held by the caller
+static void unlinkWatchdogEntry(watchdogEntry_t *entry){
+	if(entry->prev) entry->prev->next = entry->next;
+	else watchdog_wheel[entry->slot] = entry->next;
+	if(entry->next) entry->next->prev = entry->prev;
+	entry->prev = entry->next = NULL;
+	entry->slot = -1;
+	watchdog_entry_num --;
+}
+
+// advance the timer wheel by one tick, and kill the children reaching their deadlines
+static void* runWatchdog(void *arg){
+	struct timespec next_tick;
+	struct timeval cur_time;
+	watchdogEntry_t *entry, *next_entry;
+	int64_t nsec;
+
+	pthread_mutex_lock(&mutex_watchdog);
+	while(1){
+		while(watchdog_entry_num==0) pthread_cond_wait(&cond_watchdog, &mutex_watchdog);
+
+		gettimeofday(&cur_time, NULL);
+		nsec = cur_time.tv_usec * 1000L + (int64_t)WATCHDOG_TICK_MS * 1000000L;
+		next_tick.tv_sec = cur_time.tv_sec + nsec / 1000000000L;
+		next_tick.tv_nsec = nsec % 1000000000L;
+		while(pthread_cond_timedwait(&cond_watchdog, &mutex_watchdog, &next_tick)!=ETIMEDOUT);
+
+		watchdog_cur_slot = (watchdog_cur_slot + 1) % WATCHDOG_WHEEL_SIZE;
+		for(entry=watchdog_wheel[watchdog_cur_slot]; entry; entry=next_entry){
+			next_entry = entry->next;
+			if(entry->rounds>0){
+				entry->rounds --;
+				continue;
+			}
+			kill(-entry->pid, SIGKILL);
+			entry->killed_flag = true;
+			unlinkWatchdogEntry(entry);
+			cout << __func__ << ": process " << entry->pid << " was killed because it exceeded the maximum running time. Please do NOT worry, this is programmed rather than error." << endl;
+			if(entry->kill_func) entry->kill_func(entry->kill_arg);  // the entry is kept valid by the lock until it is removed
+		}
+	}
+	pthread_mutex_unlock(&mutex_watchdog);
+
+	return NULL;
+}
+
+// watch the child process group until the timeout, the entry should be removed by watchdogRemove after the child exits
+watchdogEntry_t* watchdogAdd(pid_t pid, int64_t timeout_sec, procKillFunc_t kill_func, void *kill_arg){
+	watchdogEntry_t *entry;
+	int64_t ticks;
+	pthread_t tid;
+
+	ticks = (timeout_sec * 1000 + WATCHDOG_TICK_MS - 1) / WATCHDOG_TICK_MS;
+	if(ticks<1) ticks = 1;
+
+	entry = new watchdogEntry_t();
+	entry->pid = pid;
+	entry->killed_flag = false;
+	entry->kill_func = kill_func;
+	entry->kill_arg = kill_arg;
+	entry->rounds = (ticks - 1) / WATCHDOG_WHEEL_SIZE;
+	entry->prev = NULL;
+
+	pthread_mutex_lock(&mutex_watchdog);
+	if(watchdog_started_flag==false){
+		if(pthread_create(&tid, NULL, runWatchdog, NULL)!=0){
+			cerr << __func__ << ", line=" << __LINE__ << ": unable to create the watchdog thread, error!" << endl;
+			exit(1);
+		}
+		pthread_detach(tid);
+		watchdog_started_flag = true;
+	}
+	entry->slot = (watchdog_cur_slot + ticks) % WATCHDOG_WHEEL_SIZE;
+	entry->next = watchdog_wheel[entry->slot];
+	if(entry->next) entry->next->prev = entry;
+	watchdog_wheel[entry->slot] = entry;
+	watchdog_entry_num ++;
+	if(watchdog_entry_num==1) pthread_cond_signal(&cond_watchdog);
+	pthread_mutex_unlock(&mutex_watchdog);
+
+	return entry;
+}
+
+// stop watching the child, and return whether it was killed by the watchdog
+bool watchdogRemove(watchdogEntry_t *entry){
+	bool killed_flag;
+
+	pthread_mutex_lock(&mutex_watchdog);
+	if(entry->slot!=-1) unlinkWatchdogEntry(entry);
+	killed_flag = entry->killed_flag;
+	pthread_mutex_unlock(&mutex_watchdog);
+
+	delete entry;
+	return killed_flag;
+}
+
+// initialize the options: no timeout, the global memory limit, and the outputs are discarded
+void initProcOpt(procOpt_t &proc_opt){
+	proc_opt.wall_timeout_sec = 0;
+	proc_opt.max_mem_bytes = proc_max_mem_bytes;
+	proc_opt.capture_out_flag = false;
+	proc_opt.capture_err_flag = false;
+	proc_opt.kill_func = NULL;
+	proc_opt.kill_arg = NULL;
+}
+
+// run the program given by the argv array without shell by posix_spawn, or by vfork if it has a memory limit, and wait
+// for its exit; the child is put into a new process group, so that its own children are also killed by the watchdog when timed out
+int32_t runProcess(vector<string> &argv_vec, procOpt_t &proc_opt, procResult_t &proc_result){
+	vector<char*> argv;
+	string prog_path;
+	int32_t out_pipe[2] = {-1, -1}, err_pipe[2] = {-1, -1};
+	struct pollfd pfds[2];
+	struct timeval start_time;
+	watchdogEntry_t *watchdog_entry;
+	siginfo_t info;
+	int32_t i, nfds, status, ret;
+	pid_t pid, wait_ret;
+	bool exited_flag;
+
+	proc_result.exit_code = -1;
+	proc_result.term_signal = 0;
+	proc_result.timeout_flag = false;
+	proc_result.wall_seconds = 0;
+	proc_result.out_str.clear();
+	proc_result.err_str.clear();
+
+	if(argv_vec.empty()) return PROC_RET_FAILED;
+	for(i=0; i<(int32_t)argv_vec.size(); i++) argv.push_back((char*)argv_vec.at(i).c_str());
+	argv.push_back(NULL);
+
+	// the pipes are closed on exec, except the ends duplicated onto stdout and stderr of the child
+	if(proc_opt.capture_out_flag and pipe2(out_pipe, O_CLOEXEC)!=0) return PROC_RET_FAILED;
+	if(proc_opt.capture_err_flag and pipe2(err_pipe, O_CLOEXEC)!=0){
+		closePipe(out_pipe);
+		return PROC_RET_FAILED;
+	}
+
+	gettimeofday(&start_time, NULL);
+	if(proc_opt.max_mem_bytes>0){
+		if(findProgramPath(argv_vec.at(0), prog_path)) ret = vforkChildWithMemLimit(pid, prog_path.c_str(), argv.data(), out_pipe[1], err_pipe[1], proc_opt.max_mem_bytes);
+		else ret = ENOENT;
+	}else ret = spawnChild(pid, argv, out_pipe[1], err_pipe[1]);
+
+	// close the write ends in parent
+	if(out_pipe[1]!=-1){ close(out_pipe[1]); out_pipe[1] = -1; }
+	if(err_pipe[1]!=-1){ close(err_pipe[1]); err_pipe[1] = -1; }
+
+	if(ret!=0){
+		closePipe(out_pipe);
+		closePipe(err_pipe);
+		return PROC_RET_FAILED;
+	}
+
+	watchdog_entry = NULL;
+	if(proc_opt.wall_timeout_sec>0) watchdog_entry = watchdogAdd(pid, proc_opt.wall_timeout_sec, proc_opt.kill_func, proc_opt.kill_arg);
+
+	// collect the outputs until the child exits, the exited child is left unreaped by WNOWAIT until
+	// the watchdog stops watching it, so that its pid cannot be reused before that
+	exited_flag = false;
+	while(exited_flag==false){
+		nfds = 0;
+		if(out_pipe[0]!=-1){ pfds[nfds].fd = out_pipe[0]; pfds[nfds].events = POLLIN; pfds[nfds].revents = 0; nfds++; }
+		if(err_pipe[0]!=-1){ pfds[nfds].fd = err_pipe[0]; pfds[nfds].events = POLLIN; pfds[nfds].revents = 0; nfds++; }
+
+		if(nfds==0){ // nothing to do but waiting
+			while(waitid(P_PID, pid, &info, WEXITED | WNOWAIT)==-1 and errno==EINTR);
+			break;
+		}
+
+		if(poll(pfds, nfds, PROC_POLL_INTERVAL_MS)>0){
+			for(i=0; i<nfds; i++){
+				if(pfds[i].revents==0) continue;
+				if(pfds[i].fd==out_pipe[0]) readPipe(out_pipe[0], proc_result.out_str);
+				else readPipe(err_pipe[0], proc_result.err_str);
+			}
+		}
+
+		// the pipes may be still held by the orphaned descendants after the child exits
+		info.si_pid = 0;
+		ret = waitid(P_PID, pid, &info, WEXITED | WNOHANG | WNOWAIT);
+		if(ret==0 and info.si_pid==pid) exited_flag = true;
+		else if(ret==-1 and errno!=EINTR){
+			cerr << __func__ << ", line=" << __LINE__ << ": cannot wait for process " << pid << ": " << strerror(errno) << endl;
+			break;
+		}
+	}
+	if(watchdog_entry) proc_result.timeout_flag = watchdogRemove(watchdog_entry);
+
+	// reap the child after it is no longer watched
+	while((wait_ret=waitpid(pid, &status, 0))==-1 and errno==EINTR);
+
+	// drain the outputs left in the pipes
+	drainPipe(out_pipe[0], proc_result.out_str);
+	drainPipe(err_pipe[0], proc_result.err_str);
+
+	proc_result.wall_seconds = getElapsedSeconds(start_time);
+	if(wait_ret==pid){
+		if(WIFEXITED(status)) proc_result.exit_code = WEXITSTATUS(status);
+		else if(WIFSIGNALED(status)) proc_result.term_signal = WTERMSIG(status);
+	}
+
+	if(proc_result.timeout_flag) return PROC_RET_TIMEOUT;
+	if(proc_result.exit_code==0) return PROC_RET_SUCCESS;
+	return PROC_RET_FAILED;
+}
+
+// run the program with its outputs discarded
+int32_t runProcess(vector<string> &argv_vec, int64_t wall_timeout_sec, procKillFunc_t kill_func, void *kill_arg){
+	procOpt_t proc_opt;
+	procResult_t proc_result;
+
+	initProcOpt(proc_opt);
+	proc_opt.wall_timeout_sec = wall_timeout_sec;
+	proc_opt.kill_func = kill_func;
+	proc_opt.kill_arg = kill_arg;
+
+	return runProcess(argv_vec, proc_opt, proc_result);
+}
+
+// print the exit code or the terminating signal of the failed child
+void printProcFailure(const string &func_name, vector<string> &argv_vec, procResult_t &proc_result){
+	cerr << func_name << ": '" << argv_vec.at(0) << "' failed";
+	if(proc_result.term_signal!=0) cerr << " by signal " << proc_result.term_signal;
+	else cerr << " with exit code " << proc_result.exit_code;
+	if(argv_vec.size()>1) cerr << ", last argument: " << argv_vec.at(argv_vec.size()-1);
+	cerr << endl;
+}
@@ -0,0 +1,62 @@
+#ifndef SRC_PROCRUNNER_H_
+#define SRC_PROCRUNNER_H_
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <pthread.h>
+#include <sys/types.h>
+
+using namespace std;
+
+#define PROC_POLL_INTERVAL_MS		100		// interval of checking the running child process, in milliseconds
+#define PROC_READ_BUF_SIZE			4096
+
+#define WATCHDOG_TICK_MS			1000	// tick of the watchdog timer wheel, in milliseconds
+#define WATCHDOG_WHEEL_SIZE			64		// number of slots of the timer wheel
+
+// return status of the process runner
+#define PROC_RET_SUCCESS			0
+#define PROC_RET_FAILED				-1		// cannot be launched, or exited with non-zero status or by signal
+#define PROC_RET_TIMEOUT			-2		// killed due to the wall-clock timeout, the same as the killed works
+
+typedef void (*procKillFunc_t)(void *arg);
+
+// options of a child process, the limits are disabled by 0
+typedef struct{
+	int64_t wall_timeout_sec;	// wall-clock timeout, the process group of the child is killed when timed out
+	int64_t max_mem_bytes;		// memory limit by RLIMIT_AS set before exec, as RLIMIT_RSS is not enforced by Linux
+	bool capture_out_flag, capture_err_flag;	// capture stdout and stderr, otherwise they are discarded
+	procKillFunc_t kill_func;	// called by the watchdog after the child is killed, e.g. to record the killed work
+	void *kill_arg;
+}procOpt_t;
+
+typedef struct{
+	int32_t exit_code;		// exit code if exited normally, -1 otherwise
+	int32_t term_signal;	// signal terminating the child, 0 for none
+	bool timeout_flag;
+	double wall_seconds;
+	string out_str, err_str;
+}procResult_t;
+
+// child process watched by the watchdog, it is linked into a slot of the timer wheel
+typedef struct watchdogEntry{
+	pid_t pid;
+	int32_t slot;		// slot of the wheel, -1 if it was unlinked after being killed
+	int64_t rounds;		// remaining rounds of the wheel before the deadline
+	bool killed_flag;
+	procKillFunc_t kill_func;
+	void *kill_arg;
+	struct watchdogEntry *prev, *next;
+}watchdogEntry_t;
+
+extern int64_t proc_max_mem_bytes;	// memory limit of each external process, 0 for no limit
+
+void initProcOpt(procOpt_t &proc_opt);
+int32_t runProcess(vector<string> &argv_vec, procOpt_t &proc_opt, procResult_t &proc_result);
+int32_t runProcess(vector<string> &argv_vec, int64_t wall_timeout_sec=0, procKillFunc_t kill_func=NULL, void *kill_arg=NULL);
+void printProcFailure(const string &func_name, vector<string> &argv_vec, procResult_t &proc_result);
+watchdogEntry_t* watchdogAdd(pid_t pid, int64_t timeout_sec, procKillFunc_t kill_func, void *kill_arg);
+bool watchdogRemove(watchdogEntry_t *entry);
+
+#endif /* SRC_PROCRUNNER_H_ */
@@ -0,0 +1,279 @@
+#include <string.h>
+#include "seqAlign.h"
+#include "util.h"
+
+#if defined(__GNUC__) and (defined(__x86_64__) or defined(__i386__))
+#include <immintrin.h>
+#define SEQ_ALN_X86
+#endif
+
+// semi-global alignment filled along the anti-diagonals: the cells of an anti-diagonal only depend on the
+// previous two anti-diagonals, so that they are computed in parallel lanes with the same scoring as the
+// row-by-row filling, including the gap opening decided by the path of the previous cell
+
+// context of an alignment shared by the anti-diagonals
+typedef struct{
+	const string *queryseq, *subjectseq;
+	int32_t rowsNum, colsNum;
+	int32_t match_score, mismatch_score, gap_score, gap_open_score;
+	uint32_t *query_bits;		// symbol bit of each query base
+	uint32_t *subject_masks;	// bits of the query symbols matching each subject base, in reversed order
+}alnDiagCtx_t;
+
+typedef void (*alnDiagFunc_t)(const alnDiagCtx_t *ctx, int32_t d, int32_t ilo, int32_t ihi, const int32_t *h2, const int32_t *h1, const int8_t *p1, int32_t *h, int8_t *p);
+
+// compute the cell (i, d-i) from the previous anti-diagonals, the tie is broken in the order of (i-1, j-1), (i-1, j), (i, j-1)
+static inline void fillAlnCell(const alnDiagCtx_t *ctx, int32_t i, bool baseMatchFlag, const int32_t *h2, const int32_t *h1, const int8_t *p1, int32_t *h, int8_t *p){
+	int32_t maxValue, value;
+	int8_t path_val;
+
+	maxValue = h2[i-1] + (baseMatchFlag ? ctx->match_score : ctx->mismatch_score);
+	path_val = 0;
+	value = h1[i-1] + (p1[i-1]==1 ? ctx->gap_score : ctx->gap_open_score);
+	if(value>maxValue) { maxValue = value; path_val = 1; }
+	value = h1[i] + (p1[i]==2 ? ctx->gap_score : ctx->gap_open_score);
+	if(value>maxValue) { maxValue = value; path_val = 2; }
+	h[i] = maxValue;
+	p[i] = path_val;
+}
+
+static void fillAlnDiagScalar(const alnDiagCtx_t *ctx, int32_t d, int32_t ilo, int32_t ihi, const int32_t *h2, const int32_t *h1, const int8_t *p1, int32_t *h, int8_t *p){
+	for(int32_t i=ilo; i<=ihi; i++)
+		fillAlnCell(ctx, i, isBaseMatch(ctx->queryseq->at(i-1), ctx->subjectseq->at(d-i-1)), h2, h1, p1, h, p);
+}
+
+#ifdef SEQ_ALN_X86
+// the match of the cell is decided by the symbol bit of the query base and the match mask of the subject base
+static inline bool isAlnCellMatch(const alnDiagCtx_t *ctx, int32_t d, int32_t i){
+	return ctx->query_bits[i-1] & ctx->subject_masks[ctx->colsNum - 1 - d + i];
+}
+
+__attribute__((target("sse4.1")))
+static void fillAlnDiagSse41(const alnDiagCtx_t *ctx, int32_t d, int32_t ilo, int32_t ihi, const int32_t *h2, const int32_t *h1, const int8_t *p1, int32_t *h, int8_t *p){
+	__m128i v_match = _mm_set1_epi32(ctx->match_score), v_mismatch = _mm_set1_epi32(ctx->mismatch_score);
+	__m128i v_gap = _mm_set1_epi32(ctx->gap_score), v_gap_open = _mm_set1_epi32(ctx->gap_open_score);
+	__m128i v_zero = _mm_setzero_si128(), v_one = _mm_set1_epi32(1), v_two = _mm_set1_epi32(2);
+	__m128i v_bits, v_masks, v_mis, v_best, v_value, v_path, v_pre_path, v_gt;
+	int32_t i, path_bytes;
+
+	for(i=ilo; i+3<=ihi; i+=4){
+		v_bits = _mm_loadu_si128((const __m128i*)(ctx->query_bits + i - 1));
+		v_masks = _mm_loadu_si128((const __m128i*)(ctx->subject_masks + ctx->colsNum - 1 - d + i));
+		v_mis = _mm_cmpeq_epi32(_mm_and_si128(v_bits, v_masks), v_zero);
+		v_best = _mm_add_epi32(_mm_loadu_si128((const __m128i*)(h2 + i - 1)), _mm_blendv_epi8(v_match, v_mismatch, v_mis));
+		v_path = v_zero;
+
+		memcpy(&path_bytes, p1 + i - 1, 4);
+		v_pre_path = _mm_cvtepi8_epi32(_mm_cvtsi32_si128(path_bytes));
+		v_value = _mm_add_epi32(_mm_loadu_si128((const __m128i*)(h1 + i - 1)), _mm_blendv_epi8(v_gap_open, v_gap, _mm_cmpeq_epi32(v_pre_path, v_one)));
+		v_gt = _mm_cmpgt_epi32(v_value, v_best);
+		v_best = _mm_blendv_epi8(v_best, v_value, v_gt);
+		v_path = _mm_blendv_epi8(v_path, v_one, v_gt);
+
+		memcpy(&path_bytes, p1 + i, 4);
+		v_pre_path = _mm_cvtepi8_epi32(_mm_cvtsi32_si128(path_bytes));
+		v_value = _mm_add_epi32(_mm_loadu_si128((const __m128i*)(h1 + i)), _mm_blendv_epi8(v_gap_open, v_gap, _mm_cmpeq_epi32(v_pre_path, v_two)));
+		v_gt = _mm_cmpgt_epi32(v_value, v_best);
+		v_best = _mm_blendv_epi8(v_best, v_value, v_gt);
+		v_path = _mm_blendv_epi8(v_path, v_two, v_gt);
+
+		_mm_storeu_si128((__m128i*)(h + i), v_best);
+		v_path = _mm_packs_epi16(_mm_packs_epi32(v_path, v_zero), v_zero);
+		path_bytes = _mm_cvtsi128_si32(v_path);
+		memcpy(p + i, &path_bytes, 4);
+	}
+	for(; i<=ihi; i++) fillAlnCell(ctx, i, isAlnCellMatch(ctx, d, i), h2, h1, p1, h, p);
+}
+
+__attribute__((target("avx2")))
+static void fillAlnDiagAvx2(const alnDiagCtx_t *ctx, int32_t d, int32_t ilo, int32_t ihi, const int32_t *h2, const int32_t *h1, const int8_t *p1, int32_t *h, int8_t *p){
+	__m256i v_match = _mm256_set1_epi32(ctx->match_score), v_mismatch = _mm256_set1_epi32(ctx->mismatch_score);
+	__m256i v_gap = _mm256_set1_epi32(ctx->gap_score), v_gap_open = _mm256_set1_epi32(ctx->gap_open_score);
+	__m256i v_zero = _mm256_setzero_si256(), v_one = _mm256_set1_epi32(1), v_two = _mm256_set1_epi32(2);
+	__m256i v_bits, v_masks, v_mis, v_best, v_value, v_path, v_pre_path, v_gt;
+	__m128i v_path8;
+	int32_t i;
+
+	for(i=ilo; i+7<=ihi; i+=8){
+		v_bits = _mm256_loadu_si256((const __m256i*)(ctx->query_bits + i - 1));
+		v_masks = _mm256_loadu_si256((const __m256i*)(ctx->subject_masks + ctx->colsNum - 1 - d + i));
+		v_mis = _mm256_cmpeq_epi32(_mm256_and_si256(v_bits, v_masks), v_zero);
+		v_best = _mm256_add_epi32(_mm256_loadu_si256((const __m256i*)(h2 + i - 1)), _mm256_blendv_epi8(v_match, v_mismatch, v_mis));
+		v_path = v_zero;
+
+		v_pre_path = _mm256_cvtepi8_epi32(_mm_loadl_epi64((const __m128i*)(p1 + i - 1)));
+		v_value = _mm256_add_epi32(_mm256_loadu_si256((const __m256i*)(h1 + i - 1)), _mm256_blendv_epi8(v_gap_open, v_gap, _mm256_cmpeq_epi32(v_pre_path, v_one)));
+		v_gt = _mm256_cmpgt_epi32(v_value, v_best);
+		v_best = _mm256_blendv_epi8(v_best, v_value, v_gt);
+		v_path = _mm256_blendv_epi8(v_path, v_one, v_gt);
+
+		v_pre_path = _mm256_cvtepi8_epi32(_mm_loadl_epi64((const __m128i*)(p1 + i)));
+		v_value = _mm256_add_epi32(_mm256_loadu_si256((const __m256i*)(h1 + i)), _mm256_blendv_epi8(v_gap_open, v_gap, _mm256_cmpeq_epi32(v_pre_path, v_two)));
+		v_gt = _mm256_cmpgt_epi32(v_value, v_best);
+		v_best = _mm256_blendv_epi8(v_best, v_value, v_gt);
+		v_path = _mm256_blendv_epi8(v_path, v_two, v_gt);
+
+		_mm256_storeu_si256((__m256i*)(h + i), v_best);
+		v_path8 = _mm_packs_epi32(_mm256_castsi256_si128(v_path), _mm256_extracti128_si256(v_path, 1));
+		v_path8 = _mm_packs_epi16(v_path8, v_path8);
+		_mm_storel_epi64((__m128i*)(p + i), v_path8);
+	}
+	for(; i<=ihi; i++) fillAlnCell(ctx, i, isAlnCellMatch(ctx, d, i), h2, h1, p1, h, p);
+}
+#endif
+
+// detect the instruction set once
+static int32_t detectSeqAlnSimdLevel(){
+#ifdef SEQ_ALN_X86
+	__builtin_cpu_init();
+	if(__builtin_cpu_supports("avx2")) return SEQ_ALN_SIMD_AVX2;
+	if(__builtin_cpu_supports("sse4.1")) return SEQ_ALN_SIMD_SSE41;
+#endif
+	return SEQ_ALN_SIMD_NONE;
+}
+
+int32_t getSeqAlnSimdLevel(){
+	static int32_t simd_level = detectSeqAlnSimdLevel();
+	return simd_level;
+}
+
+#ifdef SEQ_ALN_X86
+// build the symbol bits of the query and the match masks of the subject by isBaseMatch(),
+// return false if there are too many distinct bases
+static bool initAlnMatchMasks(alnDiagCtx_t *ctx){
+	int32_t symbol_id[256], symbol_num, i, j, k;
+	char symbols[SEQ_ALN_MAX_SYMBOL_NUM], ch;
+	uint32_t mask;
+	const string *seqs[2] = {ctx->queryseq, ctx->subjectseq};
+
+	// symbols are the distinct bases in upper case, as isBaseMatch() is case insensitive
+	for(i=0; i<256; i++) symbol_id[i] = -1;
+	symbol_num = 0;
+	for(k=0; k<2; k++){
+		for(i=0; i<(int32_t)seqs[k]->size(); i++){
+			ch = seqs[k]->at(i);
+			if(ch>='a' and ch<='z') ch -= 32;
+			if(symbol_id[(uint8_t)ch]==-1){
+				if(symbol_num>=SEQ_ALN_MAX_SYMBOL_NUM) return false;
+				symbols[symbol_num] = ch;
+				symbol_id[(uint8_t)ch] = symbol_num++;
+			}
+		}
+	}
+
+	ctx->query_bits = (uint32_t*) malloc((ctx->rowsNum + 8) * sizeof(uint32_t));
+	ctx->subject_masks = (uint32_t*) malloc((ctx->colsNum + 8) * sizeof(uint32_t));
+	if(ctx->query_bits==NULL or ctx->subject_masks==NULL){
+		cerr << __func__ << ", line=" << __LINE__ << ", rowsNum=" << ctx->rowsNum << ", colsNum=" << ctx->colsNum << ", cannot allocate memory, error!" << endl;
+		exit(1);
+	}
+	for(i=0; i<(int32_t)ctx->queryseq->size(); i++){
+		ch = ctx->queryseq->at(i);
+		if(ch>='a' and ch<='z') ch -= 32;
+		ctx->query_bits[i] = 1u << symbol_id[(uint8_t)ch];
+	}
+	for(j=0; j<(int32_t)ctx->subjectseq->size(); j++){
+		ch = ctx->subjectseq->at(j);
+		mask = 0;
+		for(k=0; k<symbol_num; k++) if(isBaseMatch(symbols[k], ch)) mask |= 1u << k;
+		ctx->subject_masks[ctx->colsNum - 2 - j] = mask;
+	}
+
+	return true;
+}
+#endif
+
+// compute the path of the semi-global alignment with the same scoring as varCand::computeSeqAlignmentOp():
+// the first row and column are zero, and a gap is opened unless the previous cell has the same gap direction
+alnPathMatrix_t* computeAlnPathMatrix(const string &queryseq, const string &subjectseq, int32_t match_score, int32_t mismatch_score, int32_t gap_score, int32_t gap_open_score){
+	alnPathMatrix_t *path_mat;
+	alnDiagCtx_t ctx;
+	alnDiagFunc_t diag_func;
+	int32_t rowsNum = queryseq.size() + 1, colsNum = subjectseq.size() + 1, diagNum = rowsNum + colsNum - 1, d, ilo, ihi;
+	int32_t *h_buf[3], *h2, *h1, *h, *h_tmp;
+	int8_t *p_buf[2], *p1, *p, *p_tmp;
+	int64_t cell_num;
+
+	path_mat = new alnPathMatrix_t();
+	path_mat->rowsNum = rowsNum;
+	path_mat->colsNum = colsNum;
+	path_mat->diag_offset = (int64_t*) malloc((diagNum + 1) * sizeof(int64_t));
+	path_mat->last_row_score = (int32_t*) calloc(colsNum, sizeof(int32_t));
+	path_mat->last_col_score = (int32_t*) calloc(rowsNum, sizeof(int32_t));
+	if(path_mat->diag_offset==NULL or path_mat->last_row_score==NULL or path_mat->last_col_score==NULL){
+		cerr << __func__ << ", line=" << __LINE__ << ", rowsNum=" << rowsNum << ", colsNum=" << colsNum << ", cannot allocate memory, error!" << endl;
+		exit(1);
+	}
+
+	// offsets of the inner cells of each anti-diagonal
+	cell_num = 0;
+	for(d=0; d<diagNum; d++){
+		path_mat->diag_offset[d] = cell_num;
+		ilo = (d - colsNum + 1 > 1) ? d - colsNum + 1 : 1;
+		ihi = (d - 1 < rowsNum - 1) ? d - 1 : rowsNum - 1;
+		if(ihi>=ilo) cell_num += ihi - ilo + 1;
+	}
+	path_mat->diag_offset[diagNum] = cell_num;
+	path_mat->path_arr = (int8_t*) malloc(cell_num + 1);
+
+	// the anti-diagonals are indexed by row, padded for the vector loads
+	for(d=0; d<3; d++) h_buf[d] = (int32_t*) calloc(rowsNum + 8, sizeof(int32_t));
+	for(d=0; d<2; d++) p_buf[d] = (int8_t*) calloc(rowsNum + 8, sizeof(int8_t));
+	if(path_mat->path_arr==NULL or h_buf[0]==NULL or h_buf[1]==NULL or h_buf[2]==NULL or p_buf[0]==NULL or p_buf[1]==NULL){
+		cerr << __func__ << ", line=" << __LINE__ << ", rowsNum=" << rowsNum << ", colsNum=" << colsNum << ", cannot allocate memory, error!" << endl;
+		exit(1);
+	}
+	h2 = h_buf[0]; h1 = h_buf[1]; h = h_buf[2];
+	p1 = p_buf[0]; p = p_buf[1];
+
+	ctx.queryseq = &queryseq;
+	ctx.subjectseq = &subjectseq;
+	ctx.rowsNum = rowsNum;
+	ctx.colsNum = colsNum;
+	ctx.match_score = match_score;
+	ctx.mismatch_score = mismatch_score;
+	ctx.gap_score = gap_score;
+	ctx.gap_open_score = gap_open_score;
+	ctx.query_bits = ctx.subject_masks = NULL;
+
+	diag_func = fillAlnDiagScalar;
+#ifdef SEQ_ALN_X86
+	int32_t simd_level = getSeqAlnSimdLevel();
+	if(simd_level!=SEQ_ALN_SIMD_NONE and initAlnMatchMasks(&ctx))
+		diag_func = (simd_level==SEQ_ALN_SIMD_AVX2) ? fillAlnDiagAvx2 : fillAlnDiagSse41;
+#endif
+
+	for(d=0; d<diagNum; d++){
+		// boundary cells of the first row and the first column, their path is none
+		if(d<colsNum) { h[0] = 0; p[0] = -1; }
+		if(d<rowsNum) { h[d] = 0; p[d] = -1; }
+
+		ilo = (d - colsNum + 1 > 1) ? d - colsNum + 1 : 1;
+		ihi = (d - 1 < rowsNum - 1) ? d - 1 : rowsNum - 1;
+		if(ihi>=ilo){
+			diag_func(&ctx, d, ilo, ihi, h2, h1, p1, h, p);
+			memcpy(path_mat->path_arr + path_mat->diag_offset[d], p + ilo, ihi - ilo + 1);
+
+			if(ihi==rowsNum-1) path_mat->last_row_score[d-ihi] = h[ihi];
+			if(ilo==d-colsNum+1) path_mat->last_col_score[ilo] = h[ilo];
+		}
+
+		h_tmp = h2; h2 = h1; h1 = h; h = h_tmp;
+		p_tmp = p1; p1 = p; p = p_tmp;
+	}
+
+	for(d=0; d<3; d++) free(h_buf[d]);
+	for(d=0; d<2; d++) free(p_buf[d]);
+	if(ctx.query_bits) free(ctx.query_bits);
+	if(ctx.subject_masks) free(ctx.subject_masks);
+
+	return path_mat;
+}
+
+void destroyAlnPathMatrix(alnPathMatrix_t *path_mat){
+	free(path_mat->path_arr);
+	free(path_mat->diag_offset);
+	free(path_mat->last_row_score);
+	free(path_mat->last_col_score);
+	delete path_mat;
+}
@@ -0,0 +1,36 @@
+#ifndef SRC_SEQALIGN_H_
+#define SRC_SEQALIGN_H_
+
+#include <iostream>
+#include <string>
+#include <stdint.h>
+
+using namespace std;
+
+// instruction sets of the anti-diagonal aligner, detected at runtime
+#define SEQ_ALN_SIMD_NONE				0
+#define SEQ_ALN_SIMD_SSE41				1
+#define SEQ_ALN_SIMD_AVX2				2
+
+#define SEQ_ALN_MAX_SYMBOL_NUM			32		// distinct bases of the match masks, the scalar path is used if exceeded
+
+// path of the semi-global alignment of the query (rows) against the subject (columns):
+// the path of the inner cells is kept in the anti-diagonal order, 0 for (i-1, j-1), 1 for (i-1, j) and 2 for (i, j-1)
+typedef struct{
+	int32_t rowsNum, colsNum;		// including the first row and column of the boundary
+	int8_t *path_arr;
+	int64_t *diag_offset;			// offset of each anti-diagonal in 'path_arr'
+	int32_t *last_row_score, *last_col_score;	// scores of the last row and the last column
+}alnPathMatrix_t;
+
+int32_t getSeqAlnSimdLevel();
+alnPathMatrix_t* computeAlnPathMatrix(const string &queryseq, const string &subjectseq, int32_t match_score, int32_t mismatch_score, int32_t gap_score, int32_t gap_open_score);
+void destroyAlnPathMatrix(alnPathMatrix_t *path_mat);
+
+// path of the inner cell (i, j), i>0 and j>0
+inline int8_t getAlnPathVal(const alnPathMatrix_t *path_mat, int64_t i, int64_t j){
+	int64_t d = i + j, ilo = (d - path_mat->colsNum + 1 > 1) ? d - path_mat->colsNum + 1 : 1;
+	return path_mat->path_arr[path_mat->diag_offset[d] + i - ilo];
+}
+
+#endif /* SRC_SEQALIGN_H_ */
@@ -118,6 +118,7 @@ typedef struct {
 	int32_t *p_cns_reg_workDone_num;   // pointer to the global variable which was declared in Paras.h
 	pthread_mutex_t *p_mtx_cns_reg_workDone_num; // pointer to the global variable which was declared in Paras.h
 	int32_t num_threads_per_cns_work, minClipEndSize, cnsSideExtSize, minConReadLen, min_sv_size, min_supp_num, minMapQ: 16, minHighMapQ: 16, sv_len_est;
+	int32_t max_proc_running_minutes;  // running time limit of the consensus processes, 0 for no limit
 	double max_seg_size_ratio, min_identity_match;
 
 	string inBamFile, technology; //, canu_version;
@@ -241,6 +242,14 @@ typedef struct{
 	vector<struct pafalnSeg*> pafalnsegs;
 }minimap2_aln_t;
 
+// PAF alignment record of minimap2
+typedef struct{
+	string query_name, subject_name, cigar;
+	int32_t query_len, query_start, query_end, subject_len, subject_start, subject_end, match_num, block_len, mapq;
+	int32_t relative_strand;
+	bool primary_flag;
+}pafRecord_t;
+
 // from varCand.h
 typedef struct{
 	reg_t *reg, *cand_reg;
@@ -284,25 +293,23 @@ struct alnScoreNode{
 	int32_t score: 27, path_val: 3, ismismatch: 2;
 };
 
+// private result slot of a single mate clipping region detection work, indexed by 'work_id'
+typedef struct{
+	mateClipReg_t *mate_clip_reg;	// new mate clipping region, NULL if none
+	reg_t *indel_reg;		// clipping region to be added into the indel vector of its block, NULL if none
+	vector<varCand*> removed_var_cand_vec;	// items to be removed from 'var_cand_clipReg_vec'
+}mateClipRegDetectResult_t;
+
 typedef struct{
 	reg_t *reg;
 	int32_t work_id, num_work;
 	faidx_t *fai;
 	Paras *paras;
-	vector<mateClipReg_t*> *mateClipRegVector;
-	vector<reg_t*> *clipRegVector;
-	vector<varCand*> *var_cand_clipReg_vec;
-	vector<Block*> *blockVector;
+	mateClipRegDetectResult_t *result;	// private result slot, no lock needed
 	//vector<bool> *clip_processed_flag_vec;
-	pthread_mutex_t *p_mutex_mate_clip_reg;
 	//int32_t *p_mate_clip_reg_fail_num;
 }mateClipRegDetectWork_opt;
 
-typedef struct{
-	string work_finish_filename, monitoring_proc_names;
-	int32_t max_proc_running_minutes;
-}procMonitor_op;
-
 // for process monitor killed minimap2 work
 typedef struct{
 	string alnfilename, ctgfilename, refseqfilename;
@@ -313,6 +320,15 @@ typedef struct{
 	string alnfilename, ctgfilename, refseqfilename;
 }killedBlatWork_t;
 
+// killed work recorded by the process watchdog, only one of the vectors is used
+typedef struct{
+	string alnfilename, ctgfilename, refseqfilename;
+	vector<killedMinimap2Work_t*> *killed_minimap2_work_vec;
+	vector<killedBlatWork_t*> *killed_blat_work_vec;
+	ofstream *killed_work_file;
+	pthread_mutex_t *mtx_killed_work;
+}killedWorkRecord_t;
+
 // single signature for genotype
 typedef struct gtSigNode{
 	int32_t sig_id: 24, cigar_op: 8, cigar_op_len;
@@ -1,5 +1,6 @@
 #include "sv_sort.h"
 #include "util.h"
+#include "Thread.h"
 
 
 SV_item *constructSVItem(string &line){
@@ -598,16 +599,69 @@ void sortSVitem(vector<vector<SV_item*>> &subsets){
 	}
 }
 
-// remove duplicated items
-void rmDupSVitem(vector<vector<SV_item*>> &subsets, double size_ratio_thres, double identity_thres){
+// remove duplicated items: the candidate pairs of all chromosomes are collected first, the identities missing
+// in the cache are computed by batched works in parallel, and then the duplicated items are marked in order
+void rmDupSVitem(vector<vector<SV_item*>> &subsets, double size_ratio_thres, double identity_thres, ThreadPool *thread_pool, svIdentityCache_t &identity_cache){
+	size_t i;
+	string thres_str;
+	svDupPair_t *dup_pair;
+	vector<svDupPair_t> pair_vec;
+	vector<svDupPair_t*> compute_vec;
+	svIdentityCache_t::iterator cache_it;
+	rmDupSVWork_opt *work_opt;
+	vector<rmDupSVWork_opt*> work_vec;
+
 	cout << "remove duplicated items ..." << endl;
-	for(size_t i=0;i<subsets.size();i++)
-		rmDupSVitemSubset(subsets.at(i), size_ratio_thres, identity_thres);
+
+	for(i=0;i<subsets.size();i++)
+		collectDupSVPairsSubset(subsets.at(i), size_ratio_thres, pair_vec);
+
+	// look up the cache, each distinct pair is computed only once and marked by -1 in the cache until computed
+	thres_str = to_string(identity_thres);
+	for(i=0; i<pair_vec.size(); i++){
+		dup_pair = &pair_vec.at(i);
+		dup_pair->hash_a = dup_pair->hash_b = 0;
+		hashStrFnv1a(dup_pair->item1->altseq, dup_pair->hash_a, dup_pair->hash_b);
+		hashStrFnv1a(dup_pair->item2->altseq, dup_pair->hash_a, dup_pair->hash_b);
+		hashStrFnv1a(thres_str, dup_pair->hash_a, dup_pair->hash_b);
+
+		dup_pair->identity = -1;
+		cache_it = identity_cache.find(make_pair(dup_pair->hash_a, dup_pair->hash_b));
+		if(cache_it!=identity_cache.end()) dup_pair->identity = cache_it->second;
+		else{
+			identity_cache.insert(make_pair(make_pair(dup_pair->hash_a, dup_pair->hash_b), -1));
+			compute_vec.push_back(dup_pair);
+		}
+	}
+
+	for(i=0; i<compute_vec.size(); i+=RM_DUP_SV_BATCH_SIZE){
+		work_opt = new rmDupSVWork_opt();
+		work_opt->pair_arr = compute_vec.data() + i;
+		work_opt->pair_num = (i + RM_DUP_SV_BATCH_SIZE<=compute_vec.size()) ? RM_DUP_SV_BATCH_SIZE : compute_vec.size() - i;
+		work_opt->identity_thres = identity_thres;
+		work_vec.push_back(work_opt);
+	}
+	for(i=0; i<work_vec.size(); i++)
+		thread_pool->dispatch(TASK_TYPE_RM_DUP_SV, processSingleRmDupSVWork, work_vec.at(i));
+	thread_pool->wait(TASK_TYPE_RM_DUP_SV);
+	for(i=0; i<work_vec.size(); i++) delete work_vec.at(i);
+
+	for(i=0; i<compute_vec.size(); i++)
+		identity_cache[make_pair(compute_vec.at(i)->hash_a, compute_vec.at(i)->hash_b)] = compute_vec.at(i)->identity;
+
+	// mark the duplicated items, the repeated pairs take the identities computed above
+	for(i=0; i<pair_vec.size(); i++){
+		dup_pair = &pair_vec.at(i);
+		if(dup_pair->identity<0) dup_pair->identity = identity_cache[make_pair(dup_pair->hash_a, dup_pair->hash_b)];
+		if(dup_pair->identity>=identity_thres) dup_pair->item2->valid_flag = false;
+	}
 }
 
-void rmDupSVitemSubset(vector<SV_item*> &sv_vec, double size_ratio_thres, double identity_thres){
+// collect the candidate pairs of adjacent items at the same positions with similar sizes
+void collectDupSVPairsSubset(vector<SV_item*> &sv_vec, double size_ratio_thres, vector<svDupPair_t> &pair_vec){
 	SV_item *item1, *item2;
-	double val, max_len, secmax_len, size_ratio;
+	double max_len, secmax_len, size_ratio;
+	svDupPair_t dup_pair;
 
 	for(size_t i=1;i<sv_vec.size(); i++){
 		item1 = sv_vec.at(i-1);
@@ -620,10 +674,24 @@ void rmDupSVitemSubset(vector<SV_item*> &sv_vec, double size_ratio_thres, double
 			}
 
 			if(size_ratio>=size_ratio_thres){
-				val = computeVarseqIdentity(item1->altseq, item2->altseq);
-				if(val>=identity_thres) item2->valid_flag = false;
+				dup_pair.item1 = item1;
+				dup_pair.item2 = item2;
+				dup_pair.hash_a = dup_pair.hash_b = 0;
+				dup_pair.identity = -1;
+				pair_vec.push_back(dup_pair);
 			}
 		}
 	}
 }
 
+void* processSingleRmDupSVWork(void *arg){
+	rmDupSVWork_opt *work_opt = (rmDupSVWork_opt *)arg;
+	svDupPair_t *dup_pair;
+
+	for(size_t i=0; i<work_opt->pair_num; i++){
+		dup_pair = work_opt->pair_arr[i];
+		dup_pair->identity = computeVarseqIdentity(dup_pair->item1->altseq, dup_pair->item2->altseq, work_opt->identity_thres);
+	}
+	return NULL;
+}
+
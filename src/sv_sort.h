@@ -5,6 +5,7 @@
 #include <string.h>
 #include <vector>
 #include <set>
+#include <map>
 #include <fstream>
 #include <algorithm>
 
@@ -12,6 +13,10 @@
 
 using namespace std;
 
+#define RM_DUP_SV_BATCH_SIZE		64		// candidate pairs of each identity work of duplicate removal
+
+class ThreadPool;
+
 
 typedef struct{
 	string chrname, chrname2, altseq, info;
@@ -19,6 +24,24 @@ typedef struct{
 	int32_t sv_len;
 }SV_item;
 
+// identities of the compared allele pairs, keyed by the 128-bit hash of the two alleles and the threshold,
+// kept by the caller to be shared by the passes of the same alleles, e.g. the BED and VCF results
+typedef map<pair<uint64_t, uint64_t>, double> svIdentityCache_t;
+
+// candidate pair of duplicated items
+typedef struct{
+	SV_item *item1, *item2;
+	uint64_t hash_a, hash_b;
+	double identity;
+}svDupPair_t;
+
+// identity work of a batch of candidate pairs
+typedef struct{
+	svDupPair_t **pair_arr;
+	size_t pair_num;
+	double identity_thres;
+}rmDupSVWork_opt;
+
 
 SV_item *constructSVItem(string &line);
 vector<SV_item*> loadDataBED(string &filename);
@@ -38,8 +61,9 @@ vector<vector<SV_item*>> constructSubsetByChr(vector<SV_item*> &sv_vec);
 bool sortFunSameChr(const SV_item *item1, const SV_item *item2);
 void sortSVitem(vector<vector<SV_item*>> &subsets);
 void sortSubset(vector<SV_item*> &sv_vec);
-void rmDupSVitem(vector<vector<SV_item*>> &subsets, double size_ratio_thres, double identity_thres);
-void rmDupSVitemSubset(vector<SV_item*> &sv_vec, double size_ratio_thres, double identity_thres);
+void rmDupSVitem(vector<vector<SV_item*>> &subsets, double size_ratio_thres, double identity_thres, ThreadPool *thread_pool, svIdentityCache_t &identity_cache);
+void collectDupSVPairsSubset(vector<SV_item*> &sv_vec, double size_ratio_thres, vector<svDupPair_t> &pair_vec);
+void* processSingleRmDupSVWork(void *arg);
 
 
 #endif /* SRC_SV_SORT_H_ */
@@ -3,7 +3,14 @@
 #include <unistd.h>
 #include <pthread.h>
 #include <cerrno>
+#include <ftw.h>
 #include <htslib/thread_pool.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#ifdef HAVE_LIBMINIMAP2
+#include <minimap.h>
+#endif
 
 #include "covLoader.h"
 #include "util.h"
@@ -70,6 +77,54 @@ int copySingleFile(string &infilename, ofstream &outfile){
 	return 0;
 }
 
+// lookup tables of the sequence utilities
+typedef struct{
+	char comp[256];			// complement of the bases including the mixed bases, 0 for unknown symbols
+	char comp_strict[256];	// complement of A, C, G and T, 'N' is kept and other symbols become 'N'
+	char upper[256];
+	uint8_t base_bit[256];	// bit of A, C, G and T
+	uint8_t iupac_bits[256];	// bits of the bases represented by the symbol, 0 for unknown symbols
+	char nt16_pair[256][2];	// two bases of a byte of the 4-bit encoded BAM sequence
+}seqUtilTables_t;
+
+#define SEQ_IUPAC_KNOWN_FLAG		0x10
+#define BAM_NT16_STR				"=ACMGRSVTWYHKDBN"
+
+static seqUtilTables_t initSeqUtilTables(){
+	seqUtilTables_t tab;
+	const char *iupac_str = "ACGTNMRSVWYHKDB", *iupac_comp_str = "TGCANKYSBWRDMHV";
+	const uint8_t iupac_bits_arr[] = {1, 2, 4, 8, 0, 1|2, 1|4, 2|4, 1|2|4, 1|8, 2|8, 1|2|8, 4|8, 1|4|8, 2|4|8};
+	uint8_t up, low;
+	int32_t i;
+
+	memset(tab.comp, 0, sizeof(tab.comp));
+	memset(tab.base_bit, 0, sizeof(tab.base_bit));
+	memset(tab.iupac_bits, 0, sizeof(tab.iupac_bits));
+	for(i=0; i<256; i++){
+		tab.upper[i] = (i>='a' and i<='z') ? i - 32 : i;
+		tab.comp_strict[i] = 'N';
+		tab.nt16_pair[i][0] = BAM_NT16_STR[i>>4];
+		tab.nt16_pair[i][1] = BAM_NT16_STR[i&0xF];
+	}
+	for(i=0; iupac_str[i]; i++){
+		up = iupac_str[i];
+		low = up + 32;
+		tab.comp[up] = iupac_comp_str[i];
+		tab.comp[low] = iupac_comp_str[i] + 32;
+		tab.iupac_bits[up] = tab.iupac_bits[low] = iupac_bits_arr[i] | SEQ_IUPAC_KNOWN_FLAG;
+		if(i<4){
+			tab.base_bit[up] = tab.base_bit[low] = iupac_bits_arr[i];
+			tab.comp_strict[up] = tab.comp[up];
+			tab.comp_strict[low] = tab.comp[low];
+		}
+	}
+	tab.comp_strict[(uint8_t)'n'] = 'n';
+
+	return tab;
+}
+
+static const seqUtilTables_t seq_util_tables = initSeqUtilTables();
+
 char getBase(string &seq, size_t pos, size_t orient){
 	char ch;
 
@@ -79,88 +134,73 @@ char getBase(string &seq, size_t pos, size_t orient){
 	}
 
 	ch = seq[pos-1];
-	if(orient==ALN_MINUS_ORIENT){
-		switch(ch){
-			case 'A': ch = 'T'; break;
-			case 'C': ch = 'G'; break;
-			case 'G': ch = 'C'; break;
-			case 'T': ch = 'A'; break;
-			case 'a': ch = 't'; break;
-			case 'c': ch = 'g'; break;
-			case 'g': ch = 'c'; break;
-			case 't': ch = 'a'; break;
-			case 'N':
-			case 'n': break;
-			default: ch = 'N'; break;
-		}
-	}
+	if(orient==ALN_MINUS_ORIENT) ch = seq_util_tables.comp_strict[(uint8_t)ch];
 
 	return ch;
 }
 
 // reverse the sequence
 void reverseSeq(string &seq){
-	char tmp;
-	int32_t len = seq.size();
-	for(int32_t i=0; i<len/2; i++){
-		tmp = seq[i];
-		seq[i] = seq[len-1-i];
-		seq[len-1-i] = tmp;
-	}
+	reverse(seq.begin(), seq.end());
 }
 
-// reverse complement the sequence
+// reverse complement the sequence in a single pass from both ends
 void reverseComplement(string &seq){
-	reverseSeq(seq);
-
-	int32_t len = seq.size();
-	for(int32_t i=0; i<len; i++){
-		switch(seq[i]){
-			case 'a': seq[i] = 't'; break;
-			case 'c': seq[i] = 'g'; break;
-			case 'g': seq[i] = 'c'; break;
-			case 't': seq[i] = 'a'; break;
-			case 'A': seq[i] = 'T'; break;
-			case 'C': seq[i] = 'G'; break;
-			case 'G': seq[i] = 'C'; break;
-			case 'T': seq[i] = 'A'; break;
-			case 'N': seq[i] = 'N'; break;
-			case 'n': seq[i] = 'n'; break;
-
-			// mixed bases
-			case 'M': seq[i] = 'K'; break;
-			case 'm': seq[i] = 'k'; break;
-			case 'R': seq[i] = 'Y'; break;
-			case 'r': seq[i] = 'y'; break;
-			case 'S': seq[i] = 'S'; break;
-			case 's': seq[i] = 's'; break;
-			case 'V': seq[i] = 'B'; break;
-			case 'v': seq[i] = 'b'; break;
-			case 'W': seq[i] = 'W'; break;
-			case 'w': seq[i] = 'w'; break;
-			case 'Y': seq[i] = 'R'; break;
-			case 'y': seq[i] = 'r'; break;
-			case 'H': seq[i] = 'D'; break;
-			case 'h': seq[i] = 'd'; break;
-			case 'K': seq[i] = 'M'; break;
-			case 'k': seq[i] = 'm'; break;
-			case 'D': seq[i] = 'H'; break;
-			case 'd': seq[i] = 'h'; break;
-			case 'B': seq[i] = 'V'; break;
-			case 'b': seq[i] = 'v'; break;
-			default:
-				cout << "i=" << i << ", seq_len=" << len << endl;
-				cout << seq << endl;
-				cerr << __func__ << ": unknown base: " << seq[i] << endl;
-				exit(1);
+	int64_t i, j, len = seq.size();
+	char ch1, ch2;
+
+	for(i=0, j=len-1; i<=j; i++, j--){
+		ch1 = seq_util_tables.comp[(uint8_t)seq[i]];
+		ch2 = seq_util_tables.comp[(uint8_t)seq[j]];
+		if(ch1==0 or ch2==0){
+			if(ch1==0) j = i;
+			cout << "i=" << j << ", seq_len=" << len << endl;
+			cout << seq << endl;
+			cerr << __func__ << ": unknown base: " << seq[j] << endl;
+			exit(1);
 		}
+		seq[i] = ch2;
+		seq[j] = ch1;
 	}
 }
 
-// upper the sequence
+// upper the sequence, 16 bases at a time if SSE2 is available
 void upperSeq(string &seq){
-	for(size_t i=0; i<seq.size(); i++)
-		if(seq[i]>='a' and seq[i]<='z') seq[i] -= 32;
+	size_t i = 0, len = seq.size();
+#ifdef __SSE2__
+	__m128i v_seq, v_lower;
+	const __m128i v_a = _mm_set1_epi8('a'-1), v_z = _mm_set1_epi8('z'+1), v_diff = _mm_set1_epi8(32);
+
+	for(; i+16<=len; i+=16){
+		v_seq = _mm_loadu_si128((const __m128i*)(seq.data() + i));
+		v_lower = _mm_and_si128(_mm_cmpgt_epi8(v_seq, v_a), _mm_cmplt_epi8(v_seq, v_z));
+		v_seq = _mm_sub_epi8(v_seq, _mm_and_si128(v_lower, v_diff));
+		_mm_storeu_si128((__m128i*)(&seq[i]), v_seq);
+	}
+#endif
+	for(; i<len; i++) seq[i] = seq_util_tables.upper[(uint8_t)seq[i]];
+}
+
+// append 'len' bases of the 4-bit encoded BAM sequence beginning at the 0-based query position 'start',
+// the string is grown once and two bases are decoded per byte
+void decodeBamSeq(const uint8_t *seq_int, int64_t start, int64_t len, string &seq){
+	int64_t i, end, old_size;
+	char *p;
+
+	if(len<=0) return;
+
+	old_size = seq.size();
+	seq.resize(old_size + len);
+	p = &seq[old_size];
+	end = start + len;
+
+	i = start;
+	if(i & 1) { *p++ = BAM_NT16_STR[seq_int[i>>1] & 0xF]; i++; }
+	for(; i+1<end; i+=2){
+		memcpy(p, seq_util_tables.nt16_pair[seq_int[i>>1]], 2);
+		p += 2;
+	}
+	if(i<end) *p = BAM_NT16_STR[seq_int[i>>1] >> 4];
 }
 
 // get the number of contigs
@@ -188,6 +228,13 @@ size_t getCtgCount(string &contigfilename){
 	return ctg_num;
 }
 
+// get the total length of sequences
+int64_t getTotalSeqLen(vector<string> &seq_vec){
+	int64_t total_len = 0;
+	for(size_t i=0; i<seq_vec.size(); i++) total_len += seq_vec.at(i).size();
+	return total_len;
+}
+
 // duplicate the variant region
 reg_t* dupVarReg(reg_t *reg){
 	reg_t *reg_ret = NULL;
@@ -1057,6 +1104,9 @@ void mergeNeighbouringVars(vector<reg_t*> &regVector, int32_t max_ref_dist_thres
     double iden_val, merge_identity_thres, merge_ref_dist_thres, sv_supp_diff;
 	int32_t sv_supp_num2 = 0, sv_size = 0, total_sv_num = 0, sv_supp_num1 = 0;
 	bool complex_reg_flag;
+	FastaSeqLoader *cns_fa_loader, *ref_fa_loader;
+	string ctgseq, refseq;
+	int32_t ctgseq_id;
 
 	//debug
 	// if(regVector.size()>=2){
@@ -1075,6 +1125,11 @@ void mergeNeighbouringVars(vector<reg_t*> &regVector, int32_t max_ref_dist_thres
 	
 	complex_reg_flag = false;
 	if(regVector.size()>=2) complex_reg_flag = ComplexRegionFlag(regVector);
+
+	// the contigs and the reference of the region are loaded once on the first compared pair,
+	// and the compared sequences of all pairs are sliced from them
+	cns_fa_loader = ref_fa_loader = NULL;
+	ctgseq_id = -1;
 	
 	for(i=0; i<regVector.size(); i++){
 		reg_1 = regVector.at(i);
@@ -1103,6 +1158,16 @@ void mergeNeighbouringVars(vector<reg_t*> &regVector, int32_t max_ref_dist_thres
 
 				if(distance<=merge_ref_dist_thres and distance>=0){
 
+					if(cns_fa_loader==NULL){
+						cns_fa_loader = new FastaSeqLoader(contigfilename);
+						ref_fa_loader = new FastaSeqLoader(reffilename);
+						refseq = ref_fa_loader->getFastaSeq(0);
+					}
+					if(ctgseq_id!=query_id){
+						ctgseq = cns_fa_loader->getFastaSeq(query_id);
+						ctgseq_id = query_id;
+					}
+
 					// update merge_identity_thres
 					if(distance >= reg_2->sv_len){
 						if(pre_refpos_comp<0){
@@ -1123,16 +1188,14 @@ void mergeNeighbouringVars(vector<reg_t*> &regVector, int32_t max_ref_dist_thres
 					if(reg_1->var_type==BAM_CDEL){
 						// get compared queryseq
 						start_querypos_comp = reg_1->endQueryPos;
-						FastaSeqLoader cns_fa_loader(contigfilename);
-						comp_queryseq = cns_fa_loader.getFastaSeq(query_id).substr(start_querypos_comp, distance);
+						comp_queryseq = ctgseq.substr(start_querypos_comp, distance);
 						// cout << start_querypos_comp << "-" << end_querypos_comp << ", " << comp_queryseq << "," << comp_queryseq.size() << endl;
 
 						start_refpos_comp = reg_1->endLocalRefPos + reg_2->sv_len;
-						FastaSeqLoader ref_fa_loader(reffilename);
-						comp_refseq = ref_fa_loader.getFastaSeq(0).substr(start_refpos_comp, distance);
+						comp_refseq = refseq.substr(start_refpos_comp, distance);
 						// cout << "comp_refseq: " << comp_refseq << endl;
 
-						iden_val = computeVarseqIdentity(comp_queryseq, comp_refseq);
+						iden_val = computeVarseqIdentity(comp_queryseq, comp_refseq, merge_identity_thres);
 						// cout << "DEL:identity=" << iden_val << ", merge_identity_thres=" << merge_identity_thres << endl;
 
 						if(iden_val >= merge_identity_thres) {
@@ -1150,15 +1213,13 @@ void mergeNeighbouringVars(vector<reg_t*> &regVector, int32_t max_ref_dist_thres
 					else if(reg_1->var_type==BAM_CINS){
 						// get query_comp seq
 						start_querypos_comp = reg_1->endQueryPos + reg_2->sv_len - 1;
-						FastaSeqLoader cns_fa_loader(contigfilename);
-						comp_queryseq = cns_fa_loader.getFastaSeq(query_id).substr(start_querypos_comp, distance);
+						comp_queryseq = ctgseq.substr(start_querypos_comp, distance);
 
 						// get ref_comp seq
 						start_refpos_comp = reg_1->endLocalRefPos;
-						FastaSeqLoader ref_fa_loader(reffilename);
-						comp_refseq = ref_fa_loader.getFastaSeq(0).substr(start_refpos_comp , distance);
+						comp_refseq = refseq.substr(start_refpos_comp , distance);
 
-						iden_val = computeVarseqIdentity(comp_queryseq, comp_refseq);
+						iden_val = computeVarseqIdentity(comp_queryseq, comp_refseq, merge_identity_thres);
 
 						// cout << "INS:identity=" << iden_val << ", merge_identity_thres=" << merge_identity_thres << endl;
 
@@ -1167,8 +1228,7 @@ void mergeNeighbouringVars(vector<reg_t*> &regVector, int32_t max_ref_dist_thres
 							pre_refpos_comp = reg_2->startRefPos;
 						
 							start_querypos_comp = reg_1->endQueryPos;
-							FastaSeqLoader cns_fa_loader(contigfilename);
-							new_queryseq = cns_fa_loader.getFastaSeq(query_id).substr(start_querypos_comp, reg_2->sv_len - 1);
+							new_queryseq = ctgseq.substr(start_querypos_comp, reg_2->sv_len - 1);
 
 							reg_1->altseq += new_queryseq;
 							reg_1->endQueryPos = reg_1->endQueryPos + reg_2->sv_len;
@@ -1182,6 +1242,9 @@ void mergeNeighbouringVars(vector<reg_t*> &regVector, int32_t max_ref_dist_thres
 		}
 	}	
 	regVector.shrink_to_fit();
+
+	if(cns_fa_loader) delete cns_fa_loader;
+	if(ref_fa_loader) delete ref_fa_loader;
 	
 	//extract seq from contig or reference
 
@@ -1238,7 +1301,7 @@ int32_t calculate_merge_distance_threshold(bool complex_region_flag, int32_t que
 	return merge_distance_threshold;
 }
 
-bool ComplexRegionFlag(vector<reg_t*> regVector){
+bool ComplexRegionFlag(vector<reg_t*> &regVector){
 	size_t i;
 	int32_t total_sv_num1, total_sv_num2, tmp_supp_num1, tmp_supp_num2, max_sv_size;
 	double aver_supp_num1, aver_supp_num2;
@@ -1431,76 +1494,21 @@ int32_t getLineCount(string &filename){
 	return num;
 }
 
+// the mixed bases (IUPAC) of the reference match the bases they represent
 bool isBaseMatch(char ctgBase, char refBase){
-	bool match_flag = false;
+	uint8_t ctg_base, ref_base, ref_bits;
 
 	// Upper case
-	if(ctgBase>='a' and ctgBase<='z') ctgBase -= 32;
-	if(refBase>='a' and refBase<='z') refBase -= 32;
+	ctg_base = seq_util_tables.upper[(uint8_t)ctgBase];
+	ref_base = seq_util_tables.upper[(uint8_t)refBase];
 
-	if(ctgBase==refBase){
-		match_flag = true;
-	}else if(ctgBase=='-' or refBase=='-'){
-		match_flag = false;
-	}else{
-		switch(refBase){
-			case 'A':
-			case 'a':
-			case 'C':
-			case 'c':
-			case 'G':
-			case 'g':
-			case 'T':
-			case 't':
-			case 'N':
-			case 'n':
-				match_flag = false;
-				break;
-			case 'M':
-			case 'm':
-				if(ctgBase=='A' or ctgBase=='C') match_flag = true;
-				break;
-			case 'R':
-			case 'r':
-				if(ctgBase=='A' or ctgBase=='G') match_flag = true;
-				break;
-			case 'S':
-			case 's':
-				if(ctgBase=='C' or ctgBase=='G') match_flag = true;
-				break;
-			case 'V':
-			case 'v':
-				if(ctgBase=='A' or ctgBase=='C' or ctgBase=='G') match_flag = true;
-				break;
-			case 'W':
-			case 'w':
-				if(ctgBase=='A' or ctgBase=='T') match_flag = true;
-				break;
-			case 'Y':
-			case 'y':
-				if(ctgBase=='C' or ctgBase=='T') match_flag = true;
-				break;
-			case 'H':
-			case 'h':
-				if(ctgBase=='A' or ctgBase=='C' or ctgBase=='T') match_flag = true;
-				break;
-			case 'K':
-			case 'k':
-				if(ctgBase=='G' or ctgBase=='T') match_flag = true;
-				break;
-			case 'D':
-			case 'd':
-				if(ctgBase=='A' or ctgBase=='G' or ctgBase=='T') match_flag = true;
-				break;
-			case 'B':
-			case 'b':
-				if(ctgBase=='C' or ctgBase=='G' or ctgBase=='T') match_flag = true;
-				break;
-			default: cerr << __func__ << ": unknown base: " << refBase << endl; exit(1);
-		}
-	}
+	if(ctg_base==ref_base) return true;
+	if(ctg_base=='-' or ref_base=='-') return false;
 
-	return match_flag;
+	ref_bits = seq_util_tables.iupac_bits[ref_base];
+	if(ref_bits==0) { cerr << __func__ << ": unknown base: " << (char)ref_base << endl; exit(1); }
+
+	return (ref_bits & seq_util_tables.base_bit[ctg_base])!=0;
 }
 
 bool isRegValid(reg_t *reg, int32_t min_size){
@@ -1535,14 +1543,17 @@ void exchangeRegLoc(reg_t *reg){
 }
 
 //Minimap2 alignment, and the output is in paf format
-int32_t minimap2Aln(string &alnfilename, string &contigfilename, string &refseqfilename, int32_t max_proc_running_minutes){
-	string minimap2_cmd, out_opt;
-	int32_t i, ret_status, status, sleep_sec;
+int32_t minimap2Aln(string &alnfilename, string &contigfilename, string &refseqfilename, int32_t max_proc_running_minutes, killedWorkRecord_t *killed_work_rec, string extra_opts){
+	vector<string> argv_vec, extra_opt_vec;
+	int32_t i, ret_status, sleep_sec;
 	time_t start_time, end_time; // start time and end time
 	double cost_min;
 
 	//minimap2_cmd = "minimap2 -c --secondary=no -o " + alnfilename + " " + refseqfilename + " " + contigfilename + " > /dev/null 2>&1";
-	minimap2_cmd = "minimap2 -c -x asm5 -o " + alnfilename + " " + refseqfilename + " " + contigfilename + " > /dev/null 2>&1";
+	argv_vec = {"minimap2", "-c", "-x", "asm5"};
+	extra_opt_vec = split(extra_opts, " ");
+	argv_vec.insert(argv_vec.end(), extra_opt_vec.begin(), extra_opt_vec.end());
+	argv_vec.insert(argv_vec.end(), {"-o", alnfilename, refseqfilename, contigfilename});
 
 	//cout << "blat_cmd: " + blat_cmd << endl;
 	time(&start_time);
@@ -1553,9 +1564,9 @@ int32_t minimap2Aln(string &alnfilename, string &contigfilename, string &refseqf
 		time(&end_time);
 		cost_min = difftime(end_time, start_time) / 60.0;
 		if(cost_min<=MAX_ALN_MINUTES){
-			status = system(minimap2_cmd.c_str());
-			ret_status = getSuccessStatusSystemCmd(status);
-			if(ret_status!=0){ // command executed failed
+			ret_status = runProcess(argv_vec, (int64_t)max_proc_running_minutes * 60, (killed_work_rec ? recordKilledWork : NULL), killed_work_rec);
+			if(ret_status==PROC_RET_TIMEOUT) break;  // killed work
+			else if(ret_status!=0){ // command executed failed
 				//cout << __func__ << ", line=" << __LINE__ << ": ret_status=" << ret_status << ", blat_cmd=" << blat_cmd << endl;
 
 				if(i<2){
@@ -1577,15 +1588,147 @@ int32_t minimap2Aln(string &alnfilename, string &contigfilename, string &refseqf
 	return ret_status;
 }
 
+// minimap2 alignment in process (the same as 'minimap2 -c -x asm5'), the alignments are returned as PAF records and also saved to alnfilename;
+// the return value is -1 if the minimap2 library is unavailable
+int32_t minimap2AlnInProc(string &alnfilename, string &contigfilename, string &refseqfilename, vector<pafRecord_t> &paf_rec_vec){
+#ifdef HAVE_LIBMINIMAP2
+	mm_idxopt_t iopt;
+	mm_mapopt_t mopt;
+	mm_idx_t *mi;
+	mm_tbuf_t *tbuf;
+	mm_reg1_t *reg, *r;
+	int32_t i, j, n_reg;
+	uint32_t k, op;
+	const char *ref_seqs[1], *ref_names[1];
+	string ref_seq, ref_name, query_seq, query_name, cigar;
+	vector<string> query_name_vec;
+	pafRecord_t paf_rec;
+
+	FastaSeqLoader ref_loader(refseqfilename);
+	if(ref_loader.getFastaSeqCount()==0) return 1;
+	ref_seq = ref_loader.getFastaSeq(0);
+	ref_name = ref_loader.getFastaSeqNameByID(0);
+	ref_name = ref_name.substr(0, ref_name.find_first_of(" \t"));  // the same as minimap2, the name ends at the first blank
+
+	mm_set_opt(0, &iopt, &mopt);
+	mm_set_opt("asm5", &iopt, &mopt);
+	mopt.flag |= MM_F_CIGAR;
+
+	// index of the local reference
+	ref_seqs[0] = ref_seq.c_str();
+	ref_names[0] = ref_name.c_str();
+	mi = mm_idx_str(iopt.w, iopt.k, iopt.flag&MM_I_HPC, iopt.bucket_bits, 1, ref_seqs, ref_names);
+	if(mi==NULL) return 1;
+	mm_mapopt_update(&mopt, mi);
+	tbuf = mm_tbuf_init();
+
+	FastaSeqLoader ctg_loader(contigfilename);
+	query_name_vec = ctg_loader.getFastaSeqNames();
+	for(i=0; i<(int32_t)ctg_loader.getFastaSeqCount(); i++){
+		query_seq = ctg_loader.getFastaSeq(i);
+		query_name = query_name_vec.at(i).substr(0, query_name_vec.at(i).find_first_of(" \t"));
+		reg = mm_map(mi, query_seq.size(), query_seq.c_str(), &n_reg, tbuf, &mopt, query_name.c_str());
+		for(j=0; j<n_reg; j++){
+			r = &reg[j];
+			if(r->p){
+				cigar = "";
+				for(k=0; k<r->p->n_cigar; k++){
+					op = r->p->cigar[k] & 0xf;
+					cigar += to_string(r->p->cigar[k] >> 4) + "MIDNSHP=XB"[op];
+				}
+
+				paf_rec.query_name = query_name;
+				paf_rec.query_len = query_seq.size();
+				paf_rec.query_start = r->qs;
+				paf_rec.query_end = r->qe;
+				paf_rec.relative_strand = r->rev ? ALN_MINUS_ORIENT : ALN_PLUS_ORIENT;
+				paf_rec.subject_name = mi->seq[r->rid].name;
+				paf_rec.subject_len = mi->seq[r->rid].len;
+				paf_rec.subject_start = r->rs;
+				paf_rec.subject_end = r->re;
+				paf_rec.match_num = r->mlen;
+				paf_rec.block_len = r->blen;
+				paf_rec.mapq = r->mapq;
+				paf_rec.primary_flag = (r->id==r->parent);
+				paf_rec.cigar = cigar;
+				paf_rec_vec.push_back(paf_rec);
+
+				free(r->p);
+			}
+		}
+		free(reg);
+	}
+
+	mm_tbuf_destroy(tbuf);
+	mm_idx_destroy(mi);
+
+	// save the alignments to keep the PAF file for later runs
+	savePafRecords(alnfilename, paf_rec_vec);
+
+	return 0;
+#else
+	return -1;
+#endif
+}
+
+// parse the PAF line into record, the 'cg' tag should be the last column
+bool parsePafLine(string &line, pafRecord_t &paf_rec){
+	vector<string> line_vec, cigar_tag_split;
+
+	line_vec = split(line, "\t");
+	if(line_vec.size()<13) return false;
+
+	paf_rec.query_name = line_vec.at(0);
+	paf_rec.query_len = stoi(line_vec.at(1));
+	paf_rec.query_start = stoi(line_vec.at(2));
+	paf_rec.query_end = stoi(line_vec.at(3));
+	paf_rec.relative_strand = (line_vec.at(4).compare("+")==0) ? ALN_PLUS_ORIENT : ALN_MINUS_ORIENT;
+	paf_rec.subject_name = line_vec.at(5);
+	paf_rec.subject_len = stoi(line_vec.at(6));
+	paf_rec.subject_start = stoi(line_vec.at(7));
+	paf_rec.subject_end = stoi(line_vec.at(8));
+	paf_rec.match_num = stoi(line_vec.at(9));
+	paf_rec.block_len = stoi(line_vec.at(10));
+	paf_rec.mapq = stoi(line_vec.at(11));
+	paf_rec.primary_flag = (line.find("tp:A:P")!=string::npos);
+
+	cigar_tag_split = split(line_vec.at(line_vec.size()-1), ":");
+	if(cigar_tag_split.size()==3 and cigar_tag_split.at(0).compare("cg")==0) paf_rec.cigar = cigar_tag_split.at(2);
+	else{
+		cerr << "In " << __func__ << "(), cannot find 'cg' tag in PAF alignment file, error!" << endl;
+		exit(1);
+	}
+
+	return true;
+}
+
+// save the PAF records to file
+void savePafRecords(string &alnfilename, vector<pafRecord_t> &paf_rec_vec){
+	ofstream outfile;
+	pafRecord_t *paf_rec;
+
+	outfile.open(alnfilename);
+	if(!outfile.is_open()){
+		cerr << __func__ << ", line=" << __LINE__ << ": cannot open file:" << alnfilename << endl;
+		exit(1);
+	}
+	for(size_t i=0; i<paf_rec_vec.size(); i++){
+		paf_rec = &paf_rec_vec.at(i);
+		outfile << paf_rec->query_name << "\t" << paf_rec->query_len << "\t" << paf_rec->query_start << "\t" << paf_rec->query_end << "\t" << (paf_rec->relative_strand==ALN_PLUS_ORIENT ? "+" : "-");
+		outfile << "\t" << paf_rec->subject_name << "\t" << paf_rec->subject_len << "\t" << paf_rec->subject_start << "\t" << paf_rec->subject_end;
+		outfile << "\t" << paf_rec->match_num << "\t" << paf_rec->block_len << "\t" << paf_rec->mapq << "\ttp:A:" << (paf_rec->primary_flag ? "P" : "S") << "\tcg:Z:" << paf_rec->cigar << endl;
+	}
+	outfile.close();
+}
+
 // BLAT alignment, and the output is in sim4 format
-int32_t blatAln(string &alnfilename, string &contigfilename, string &refseqfilename, int32_t max_proc_running_minutes){
-	string blat_cmd, out_opt;
-	int32_t i, ret_status, status, sleep_sec;
+int32_t blatAln(string &alnfilename, string &contigfilename, string &refseqfilename, int32_t max_proc_running_minutes, killedWorkRecord_t *killed_work_rec){
+	vector<string> argv_vec;
+	int32_t i, ret_status, sleep_sec;
 	time_t start_time, end_time; // start time and end time
 	double cost_min;
 
-	out_opt = "-out=sim4 " + alnfilename;
-	blat_cmd = "blat " + refseqfilename + " " + contigfilename + " " + out_opt + " > /dev/null 2>&1";
+	argv_vec = {"blat", refseqfilename, contigfilename, "-out=sim4", alnfilename};
 
 	//cout << "blat_cmd: " + blat_cmd << endl;
 	time(&start_time);
@@ -1596,9 +1739,9 @@ int32_t blatAln(string &alnfilename, string &contigfilename, string &refseqfilen
 		time(&end_time);
 		cost_min = difftime(end_time, start_time) / 60.0;
 		if(cost_min<=MAX_ALN_MINUTES){
-			status = system(blat_cmd.c_str());
-			ret_status = getSuccessStatusSystemCmd(status);
-			if(ret_status!=0){ // command executed failed
+			ret_status = runProcess(argv_vec, (int64_t)max_proc_running_minutes * 60, (killed_work_rec ? recordKilledWork : NULL), killed_work_rec);
+			if(ret_status==PROC_RET_TIMEOUT) break;  // killed work
+			else if(ret_status!=0){ // command executed failed
 				//cout << __func__ << ", line=" << __LINE__ << ": ret_status=" << ret_status << ", blat_cmd=" << blat_cmd << endl;
 
 				if(i<2){
@@ -1617,14 +1760,6 @@ int32_t blatAln(string &alnfilename, string &contigfilename, string &refseqfilen
 		}else break;
 	}
 
-	if(ret_status!=0){
-		time(&end_time);
-		cost_min = difftime(end_time, start_time) / 60.0;
-		if(cost_min>max_proc_running_minutes) { // killed work
-			ret_status = -2;
-		}
-	}
-
 	/*
 	 https://www.cnblogs.com/alantu2018/p/8554281.html
 	 http://blog.chinaunix.net/uid-22263887-id-3023260.html
@@ -1635,20 +1770,31 @@ int32_t blatAln(string &alnfilename, string &contigfilename, string &refseqfilen
 	return ret_status;
 }
 
-// get the success status to determine whether the command is executed successfully
-// 		0: successful; -1: failed;
-int32_t getSuccessStatusSystemCmd(int32_t status){
-	int32_t ret_status = 0;
+// record the work killed by the watchdog into the killed work vector and file, called by the watchdog thread
+void recordKilledWork(void *arg){
+	killedWorkRecord_t *killed_work_rec = (killedWorkRecord_t *)arg;
+	killedMinimap2Work_t *killed_minimap2_work;
+	killedBlatWork_t *killed_blat_work;
 
-	if(status==-1) ret_status = -1;
-	else{
-		if(WIFEXITED(status)){
-			if(WEXITSTATUS(status)!=0)
-				ret_status = -1;
-		}else ret_status = -1;
-	}
+	if(killed_work_rec->mtx_killed_work==NULL) return;
 
-	return ret_status;
+	pthread_mutex_lock(killed_work_rec->mtx_killed_work);
+	if(killed_work_rec->killed_minimap2_work_vec){
+		killed_minimap2_work = new killedMinimap2Work_t();
+		killed_minimap2_work->alnfilename = killed_work_rec->alnfilename;
+		killed_minimap2_work->ctgfilename = killed_work_rec->ctgfilename;
+		killed_minimap2_work->refseqfilename = killed_work_rec->refseqfilename;
+		killed_work_rec->killed_minimap2_work_vec->push_back(killed_minimap2_work);
+	}else if(killed_work_rec->killed_blat_work_vec){
+		killed_blat_work = new killedBlatWork_t();
+		killed_blat_work->alnfilename = killed_work_rec->alnfilename;
+		killed_blat_work->ctgfilename = killed_work_rec->ctgfilename;
+		killed_blat_work->refseqfilename = killed_work_rec->refseqfilename;
+		killed_work_rec->killed_blat_work_vec->push_back(killed_blat_work);
+	}
+	if(killed_work_rec->killed_work_file and killed_work_rec->killed_work_file->is_open())  // keep the killed works for the resumed runs
+		*killed_work_rec->killed_work_file << killed_work_rec->alnfilename << "\t" << killed_work_rec->ctgfilename << "\t" << killed_work_rec->refseqfilename << endl;
+	pthread_mutex_unlock(killed_work_rec->mtx_killed_work);
 }
 
 // check whether the blat alignment is matched to the contig
@@ -1867,37 +2013,25 @@ void cleanPrevConsTmpDir(const string &cns_dir_str, const string &dir_prefix)
 	DIR *dp;
 	struct dirent *entry;
 	struct stat statbuf;
-	string cmd_str, dir_str;
-	char *path;
-
-	// get current work directory
-	path = getcwd(NULL, 0);
+	string dir_str, path_str;
 
 	if(isFileExist(cns_dir_str)){
 		if((dp=opendir(cns_dir_str.c_str()))==NULL){
 			cerr << "cannot open directory: " << cns_dir_str << endl;
 			exit(1);
 		}
-		chdir(cns_dir_str.c_str());
 		while((entry = readdir(dp)) != NULL){
-			lstat(entry->d_name, &statbuf);
-			if(S_ISDIR(statbuf.st_mode)){
-				if(strcmp(".", entry->d_name) == 0 || strcmp("..", entry->d_name) == 0) continue;
-
+			if(strcmp(".", entry->d_name) == 0 || strcmp("..", entry->d_name) == 0) continue;
+			path_str = cns_dir_str + "/" + entry->d_name;
+			if(lstat(path_str.c_str(), &statbuf)==0 and S_ISDIR(statbuf.st_mode)){
 				if(strlen(entry->d_name)>4){
 					dir_str = entry->d_name;
-					if(dir_str.substr(0, 4).compare(dir_prefix)==0){
-						cmd_str = "rm -rf ";
-						cmd_str += entry->d_name;
-						system(cmd_str.c_str());
-					}
+					if(dir_str.substr(0, 4).compare(dir_prefix)==0) removeDir(path_str);
 				}
 			}
 		}
 		closedir(dp);
-		chdir(path);
 	}
-	free(path);
 }
 
 // get call file header line for INDEL which starts with '#'
@@ -2044,7 +2178,7 @@ vector<struct querySeqInfoNode*> extractQueriesFromClipAlnDataVec(vector<clipAln
 void mergeNeighbouringSigs(struct querySeqInfoNode* query_seq_info_node, vector<qcSig_t*> &sig_vec, int32_t max_ref_dist_thres, double min_merge_identity_thres, faidx_t *fai){
 	size_t i, j;
 	int32_t distance, query_opflag, seq_len;
-	int64_t l, query1_startRpos, query1_endRpos, query1_svlen, query1_startQpos, query1_endQpos, query2_startRpos, query2_svlen, query2_startQpos, query2_endQpos, start_querypos_comp, end_querypos_comp, start_refpos_comp, end_refpos_comp, start_querypos_merged, end_querypos_merged, pre_refpos_comp;
+	int64_t query1_startRpos, query1_endRpos, query1_svlen, query1_startQpos, query1_endQpos, query2_startRpos, query2_svlen, query2_startQpos, query2_endQpos, start_querypos_comp, end_querypos_comp, start_refpos_comp, end_refpos_comp, start_querypos_merged, end_querypos_merged, pre_refpos_comp;
 	uint8_t *seq_int;
 	string comp_refseq, comp_queryseq, reg_str, merging_seq;
 	double iden_val;
@@ -2093,7 +2227,7 @@ void mergeNeighbouringSigs(struct querySeqInfoNode* query_seq_info_node, vector<
 						// get compared queryseq
 						start_querypos_comp = query1_endQpos;
 						end_querypos_comp = query2_startQpos - 1;
-						for(l=start_querypos_comp-1; l<end_querypos_comp; l++) comp_queryseq += "=ACMGRSVTWYHKDBN"[bam_seqi(seq_int, l)];  // seq
+						decodeBamSeq(seq_int, start_querypos_comp-1, end_querypos_comp-start_querypos_comp+1, comp_queryseq);  // seq
 						
 						// cout << start_querypos_comp << "-" << end_querypos_comp << ", " << comp_queryseq << "," << comp_queryseq.size() << endl;
 
@@ -2109,7 +2243,7 @@ void mergeNeighbouringSigs(struct querySeqInfoNode* query_seq_info_node, vector<
 
 						// cout << reg_str << ", " << comp_refseq << "," << comp_refseq.size() << endl;
 
-						iden_val = computeVarseqIdentity(comp_queryseq, comp_refseq);
+						iden_val = computeVarseqIdentity(comp_queryseq, comp_refseq, min_merge_identity_thres);
 						// cout << "identity=" << iden_val << endl;
 
 						if(iden_val >= min_merge_identity_thres) {
@@ -2129,7 +2263,7 @@ void mergeNeighbouringSigs(struct querySeqInfoNode* query_seq_info_node, vector<
 						end_querypos_comp = query2_endQpos;
 
 						comp_queryseq = "";
-						for(l=start_querypos_comp-1; l<end_querypos_comp; l++) comp_queryseq += "=ACMGRSVTWYHKDBN"[bam_seqi(seq_int, l)];  // seq
+						decodeBamSeq(seq_int, start_querypos_comp-1, end_querypos_comp-start_querypos_comp+1, comp_queryseq);  // seq
 						// cout << start_querypos_comp << "-" << end_querypos_comp << ", " << comp_queryseq << "," << comp_queryseq.size() << endl;
 
 						// get compared refseq
@@ -2144,7 +2278,7 @@ void mergeNeighbouringSigs(struct querySeqInfoNode* query_seq_info_node, vector<
 
 						// cout << reg_str << ", " << comp_refseq << "," << comp_refseq.size() << endl;
 
-						iden_val = computeVarseqIdentity(comp_queryseq, comp_refseq);
+						iden_val = computeVarseqIdentity(comp_queryseq, comp_refseq, min_merge_identity_thres);
 						// cout << "identity=" << iden_val << endl;
 
 						if(iden_val >= min_merge_identity_thres) {
@@ -2155,7 +2289,7 @@ void mergeNeighbouringSigs(struct querySeqInfoNode* query_seq_info_node, vector<
 							start_querypos_merged = query1_endQpos;
 							end_querypos_merged = query1_endQpos + query2_svlen;
 
-							for(l=start_querypos_merged-1; l<end_querypos_merged; l++) merging_seq += "=ACMGRSVTWYHKDBN"[bam_seqi(seq_int, l)];  // seq
+							decodeBamSeq(seq_int, start_querypos_merged-1, end_querypos_merged-start_querypos_merged+1, merging_seq);  // seq
 							sig1->altseq += merging_seq;
 							// cout << start_querypos_merged << "-" << end_querypos_merged << ", " << sig_vec.at(i)->altseq << "," << sig_vec.at(i)->altseq.size() << endl;
 
@@ -2196,7 +2330,7 @@ vector<string> getQuerySeqWithSoftClipSeqs(clipAlnData_t* clip_aln, string &refs
 	vector<string> query_info_vec;
 	uint8_t *seq_int; //, *qual_int;
 	string qseq, qual;
-	int32_t i, query_start_loc, query_end_loc; // 0-based
+	int32_t query_start_loc, query_end_loc; // 0-based
 	vector<int32_t> query_loc_vec;
 
 	seq_int = bam_get_seq(clip_aln->bam);
@@ -2216,7 +2350,7 @@ vector<string> getQuerySeqWithSoftClipSeqs(clipAlnData_t* clip_aln, string &refs
 	//			if(qual_int[0]!=255) for(i=0; i<clip_aln->bam->core.l_qseq; i++) qual += qual_int[i] + 33;  // qual
 	//			else for(i=0; i<clip_aln->bam->core.l_qseq; i++) qual += 34;  // qual
 
-			for(i=query_start_loc - 1; i<query_end_loc; i++) qseq += "=ACMGRSVTWYHKDBN"[bam_seqi(seq_int, i)];  // seq
+			decodeBamSeq(seq_int, query_start_loc-1, query_end_loc-query_start_loc+1, qseq);  // seq
 
 //			if(qual_int[0]!=255) for(i=query_start_loc - 1; i<query_end_loc; i++) qual += qual_int[i] + 33;  // qual
 //			else for(i=query_start_loc - 1; i<query_end_loc; i++) qual += 34;  // qual
@@ -2229,7 +2363,7 @@ vector<string> getQuerySeqWithSoftClipSeqs(clipAlnData_t* clip_aln, string &refs
 //		if(qual_int[0]!=255) for(i=0; i<sizeof(qual_int)/sizeof(uint8_t); i++) qual += qual_int[i] + 33;  // qual
 //		else for(i=0; i<sizeof(qual_int)/sizeof(uint8_t); i++) qual += 34;  // qual
 
-		for(i=0; i<clip_aln->bam->core.l_qseq; i++) qseq += "=ACMGRSVTWYHKDBN"[bam_seqi(seq_int, i)];  // seq
+		decodeBamSeq(seq_int, 0, clip_aln->bam->core.l_qseq, qseq);  // seq
 
 //		if(qual_int[0]!=255) for(i=0; i<clip_aln->bam->core.l_qseq; i++) qual += qual_int[i] + 33;  // qual
 //		else for(i=0; i<clip_aln->bam->core.l_qseq; i++) qual += 34;  // qual
@@ -2509,7 +2643,8 @@ void* processSingleConsWork(void *arg){
 	for(i=0; i<cns_work_opt->limit_reg_array_size; i++) sub_limit_reg_vec.push_back(cns_work_opt->limit_reg_array[i]);
 
 //	cout << __func__ << ", line=" << __LINE__ << "minMapQ :  " << cns_work->minMapQ << endl;
-	performLocalCons(cns_work_opt->readsfilename, cns_work_opt->contigfilename, cns_work_opt->refseqfilename, cns_work_opt->clusterfilename, cns_work_opt->tmpdir, cns_work->technology, cns_work->min_identity_match, cns_work->sv_len_est, cns_work->num_threads_per_cns_work, varVec, cns_work_opt->chrname, cns_work->inBamFile, cns_work->fai, cns_work->cnsSideExtSize, *(cns_work->var_cand_file), cns_work->expected_cov_cns, cns_work->min_input_cov_canu, cns_work->max_ultra_high_cov, cns_work->minMapQ, cns_work->minHighMapQ, cns_work->delete_reads_flag, cns_work->keep_failed_reads_flag, cns_work_opt->clip_reg_flag, cns_work->minClipEndSize, cns_work->minConReadLen, cns_work->min_sv_size, cns_work->min_supp_num, cns_work->max_seg_size_ratio, cns_work_opt->limit_reg_process_flag, sub_limit_reg_vec);
+	performLocalCons(cns_work_opt->readsfilename, cns_work_opt->contigfilename, cns_work_opt->refseqfilename, cns_work_opt->clusterfilename, cns_work_opt->tmpdir, cns_work->technology, cns_work->min_identity_match, cns_work->sv_len_est, cns_work->num_threads_per_cns_work, varVec, cns_work_opt->chrname, cns_work->inBamFile, cns_work->fai, cns_work->cnsSideExtSize, *(cns_work->var_cand_file), cns_work->expected_cov_cns, cns_work->min_input_cov_canu, cns_work->max_ultra_high_cov, cns_work->minMapQ, cns_work->minHighMapQ, cns_work->delete_reads_flag, cns_work->keep_failed_reads_flag, cns_work_opt->clip_reg_flag, cns_work->minClipEndSize, cns_work->minConReadLen, cns_work->min_sv_size, cns_work->min_supp_num, cns_work->max_seg_size_ratio, cns_work->max_proc_running_minutes, cns_work_opt->limit_reg_process_flag, sub_limit_reg_vec);
+	finishCpuTokenWork();
 
 //	double run_seconds = time.getElapsedSeconds();
 //	if(run_seconds>60) {
@@ -2544,9 +2679,9 @@ void* processSingleConsWork(void *arg){
 }
 
 
-void performLocalCons(string &readsfilename, string &contigfilename, string &refseqfilename, string &clusterfilename, string &tmpdir, string &technology, double min_identity_match, int32_t sv_len_est, size_t num_threads_per_cns_work, vector<reg_t*> &varVec, string &chrname, string &inBamFile, faidx_t *fai, int32_t cns_extend_size, ofstream &cns_info_file, double expected_cov_cns, double min_input_cov_canu, double max_ultra_high_cov, int32_t minMapQ, int32_t minHighMapQ, bool delete_reads_flag, bool keep_failed_reads_flag, bool clip_reg_flag, int32_t minClipEndSize, int32_t minConReadLen, int32_t min_sv_size, int32_t min_supp_num, double max_seg_size_ratio, bool limit_reg_process_flag, vector<simpleReg_t*> &limit_reg_vec){
+void performLocalCons(string &readsfilename, string &contigfilename, string &refseqfilename, string &clusterfilename, string &tmpdir, string &technology, double min_identity_match, int32_t sv_len_est, size_t num_threads_per_cns_work, vector<reg_t*> &varVec, string &chrname, string &inBamFile, faidx_t *fai, int32_t cns_extend_size, ofstream &cns_info_file, double expected_cov_cns, double min_input_cov_canu, double max_ultra_high_cov, int32_t minMapQ, int32_t minHighMapQ, bool delete_reads_flag, bool keep_failed_reads_flag, bool clip_reg_flag, int32_t minClipEndSize, int32_t minConReadLen, int32_t min_sv_size, int32_t min_supp_num, double max_seg_size_ratio, int32_t max_proc_running_minutes, bool limit_reg_process_flag, vector<simpleReg_t*> &limit_reg_vec){
 
-	localCns local_cns(readsfilename, contigfilename, refseqfilename, clusterfilename, tmpdir, technology, min_identity_match, sv_len_est, num_threads_per_cns_work, varVec, chrname, inBamFile, fai, cns_extend_size, expected_cov_cns, min_input_cov_canu, max_ultra_high_cov, minMapQ, minHighMapQ, delete_reads_flag, keep_failed_reads_flag, clip_reg_flag, minClipEndSize, minConReadLen, min_sv_size, min_supp_num, max_seg_size_ratio);
+	localCns local_cns(readsfilename, contigfilename, refseqfilename, clusterfilename, tmpdir, technology, min_identity_match, sv_len_est, num_threads_per_cns_work, varVec, chrname, inBamFile, fai, cns_extend_size, expected_cov_cns, min_input_cov_canu, max_ultra_high_cov, minMapQ, minHighMapQ, delete_reads_flag, keep_failed_reads_flag, clip_reg_flag, minClipEndSize, minConReadLen, min_sv_size, min_supp_num, max_seg_size_ratio, max_proc_running_minutes);
 
 	local_cns.setLimitRegs(limit_reg_process_flag, limit_reg_vec);
 	if(local_cns.cns_success_preDone_flag==false){
@@ -2620,6 +2755,124 @@ void* processSingleMinimap2AlnWork(void *arg){
 	return NULL;
 }
 
+// align the contigs of multiple works by a single minimap2 process:
+// the sequences are prefixed by their work index, and the PAF lines are written back to their works.
+// The batch shares one index, so the result is not identical to aligning each work separately:
+// the minimizer occurrences are counted over the whole batch, and a contig may be aligned to the refseq
+// of another work, which changes the primary hit and the mapping quality of its own alignments.
+// Therefore a work having any alignment to the refseq of other works is not written back, and it is
+// left to be aligned separately together with the works without alignments.
+int32_t minimap2AlnBatch(vector<string> &alnfilename_vec, vector<string> &contigfilename_vec, vector<string> &refseqfilename_vec, string &batch_prefix, int32_t max_proc_running_minutes){
+	string batch_refseqfilename, batch_ctgfilename, batch_alnfilename, line, query_name, subject_name;
+	ofstream refseq_file, ctg_file, aln_file;
+	ifstream infile;
+	vector<string> seq_name_vec, line_vec;
+	vector<vector<string>> work_line_vec;
+	vector<bool> cross_aln_flag_vec;
+	size_t i, j;
+	int32_t ret_status, query_work_id, subject_work_id;
+
+	batch_refseqfilename = batch_prefix + "_refseq.fa";
+	batch_ctgfilename = batch_prefix + "_contig.fa";
+	batch_alnfilename = batch_prefix + ".paf";
+
+	refseq_file.open(batch_refseqfilename);
+	ctg_file.open(batch_ctgfilename);
+	if(!refseq_file.is_open() or !ctg_file.is_open()){
+		cerr << __func__ << ", line=" << __LINE__ << ": cannot open batch files with prefix " << batch_prefix << endl;
+		exit(1);
+	}
+	for(i=0; i<alnfilename_vec.size(); i++){
+		FastaSeqLoader refseq_loader(refseqfilename_vec.at(i));
+		seq_name_vec = refseq_loader.getFastaSeqNames();
+		for(j=0; j<refseq_loader.getFastaSeqCount(); j++)
+			refseq_file << ">" << i << MINIMAP2_BATCH_NAME_SEP << seq_name_vec.at(j) << endl << refseq_loader.getFastaSeq(j) << endl;
+
+		FastaSeqLoader ctg_loader(contigfilename_vec.at(i));
+		seq_name_vec = ctg_loader.getFastaSeqNames();
+		for(j=0; j<ctg_loader.getFastaSeqCount(); j++)
+			ctg_file << ">" << i << MINIMAP2_BATCH_NAME_SEP << seq_name_vec.at(j) << endl << ctg_loader.getFastaSeq(j) << endl;
+	}
+	refseq_file.close();
+	ctg_file.close();
+
+	ret_status = minimap2Aln(batch_alnfilename, batch_ctgfilename, batch_refseqfilename, max_proc_running_minutes);
+
+	// demultiplex the alignments
+	if(ret_status==0){
+		infile.open(batch_alnfilename);
+		if(infile.is_open()){
+			work_line_vec.resize(alnfilename_vec.size());
+			cross_aln_flag_vec.resize(alnfilename_vec.size(), false);
+			while(getline(infile, line)){
+				if(line.size()==0) continue;
+				line_vec = split(line, "\t");
+				if(line_vec.size()<12) continue;
+				query_name = line_vec.at(0);
+				subject_name = line_vec.at(5);
+				query_work_id = stoi(query_name.substr(0, query_name.find(MINIMAP2_BATCH_NAME_SEP)));
+				subject_work_id = stoi(subject_name.substr(0, subject_name.find(MINIMAP2_BATCH_NAME_SEP)));
+				if(query_work_id!=subject_work_id){ // aligned to the refseq of other work
+					cross_aln_flag_vec.at(query_work_id) = true;
+					continue;
+				}
+
+				// restore the original names
+				line_vec.at(0) = query_name.substr(query_name.find(MINIMAP2_BATCH_NAME_SEP) + 1);
+				line_vec.at(5) = subject_name.substr(subject_name.find(MINIMAP2_BATCH_NAME_SEP) + 1);
+				line = line_vec.at(0);
+				for(j=1; j<line_vec.size(); j++) line += "\t" + line_vec.at(j);
+				work_line_vec.at(query_work_id).push_back(line);
+			}
+			infile.close();
+
+			// works without alignments or with cross-work alignments are left to be aligned separately
+			for(i=0; i<alnfilename_vec.size(); i++){
+				if(work_line_vec.at(i).empty() or cross_aln_flag_vec.at(i)) continue;
+				aln_file.open(alnfilename_vec.at(i));
+				if(!aln_file.is_open()){
+					cerr << __func__ << ", line=" << __LINE__ << ": cannot open file " << alnfilename_vec.at(i) << endl;
+					exit(1);
+				}
+				for(j=0; j<work_line_vec.at(i).size(); j++) aln_file << work_line_vec.at(i).at(j) << endl;
+				aln_file.close();
+			}
+		}else ret_status = 1;
+	}
+
+	remove(batch_refseqfilename.c_str());
+	remove(batch_ctgfilename.c_str());
+	remove(batch_alnfilename.c_str());
+
+	return ret_status;
+}
+
+// get the reference region from the header of refseq file: chr:start-end___left_shift___right_shift___contigfile
+bool getRefseqRegion(string &refseqfilename, string &chrname, int64_t &start_pos, int64_t &end_pos){
+	ifstream infile;
+	string line;
+	vector<string> str_vec, region_vec;
+	size_t colon_pos;
+
+	infile.open(refseqfilename);
+	if(!infile.is_open()) return false;
+	getline(infile, line);
+	infile.close();
+
+	if(line.size()<2 or line.at(0)!='>') return false;
+	str_vec = split(line.substr(1), "___");
+	colon_pos = str_vec.at(0).find_last_of(":");
+	if(colon_pos==string::npos) return false;
+	region_vec = split(str_vec.at(0).substr(colon_pos+1), "-");
+	if(region_vec.size()!=2) return false;
+
+	chrname = str_vec.at(0).substr(0, colon_pos);
+	start_pos = stoll(region_vec.at(0));
+	end_pos = stoll(region_vec.at(1));
+
+	return true;
+}
+
 // process single blat align work
 void* processSingleBlatAlnWork(void *arg){
 	callWork_opt *call_work_opt = (callWork_opt *)arg;
@@ -2669,6 +2922,7 @@ void* processSingleCallWork(void *arg){
 
 	//var_cand->callVariants();
 	var_cand->callVariants02();
+	finishCpuTokenWork();
 
 //	double run_seconds = time.getElapsedSeconds();
 //	if(run_seconds>10) {
@@ -3048,6 +3302,140 @@ void createDir(string &dirname){
 	}
 }
 
+// remove a single entry visited by nftw
+static int removeDirEntry(const char *path, const struct stat *statbuf, int type_flag, struct FTW *ftw_buf){
+	if(remove(path)!=0 and errno!=ENOENT)
+		cerr << __func__ << ", line=" << __LINE__ << ": cannot remove " << path << ": " << strerror(errno) << endl;
+	return 0;
+}
+
+// remove the file or directory recursively, the same as 'rm -rf'
+void removeDir(const string &path){
+	struct stat statbuf;
+
+	if(lstat(path.c_str(), &statbuf)!=0) return;
+	if(S_ISDIR(statbuf.st_mode)) nftw(path.c_str(), removeDirEntry, 16, FTW_DEPTH | FTW_PHYS);
+	else remove(path.c_str());
+}
+
+// remove the files and directories with the given path prefix, the same as 'rm -rf prefix*'
+void removeFilesByPrefix(const string &prefix){
+	DIR *dp;
+	struct dirent *entry;
+	string dir_str, name_prefix, name;
+	size_t pos;
+
+	pos = prefix.find_last_of("/");
+	if(pos!=string::npos){
+		dir_str = prefix.substr(0, pos+1);
+		name_prefix = prefix.substr(pos+1);
+	}else{
+		dir_str = "";
+		name_prefix = prefix;
+	}
+
+	if((dp=opendir(dir_str.size()>0 ? dir_str.c_str() : "."))==NULL) return;
+	while((entry=readdir(dp))!=NULL){
+		name = entry->d_name;
+		if(name.compare(".")==0 or name.compare("..")==0) continue;
+		if(name.compare(0, name_prefix.size(), name_prefix)==0) removeDir(dir_str + name);
+	}
+	closedir(dp);
+}
+
+// per-run directory of the transient consensus and alignment files, empty for none
+static string scratch_dir_run = "";
+
+// get the default scratch directory: $TMPDIR, or /dev/shm, empty for none
+string getDefaultScratchDir(){
+	const char *tmpdir_env = getenv("TMPDIR");
+
+	if(tmpdir_env and strlen(tmpdir_env)>0 and access(tmpdir_env, W_OK | X_OK)==0) return tmpdir_env;
+	if(access("/dev/shm", W_OK | X_OK)==0) return "/dev/shm";
+	return "";
+}
+
+// create the per-run scratch directory in the given directory, the transient files are kept in the output directory if it fails
+void initScratchDir(const string &scratch_dir){
+	string dirname;
+
+	scratch_dir_run = "";
+	if(scratch_dir.empty()) return;
+
+	dirname = scratch_dir + "/asvclr_" + to_string(getpid());
+	if(mkdir(dirname.c_str(), S_IRWXU)!=0 and errno!=EEXIST){
+		cout << "Warning: cannot create scratch directory " << dirname << ": " << strerror(errno) << ", the output directory will be used." << endl;
+		return;
+	}
+	scratch_dir_run = dirname;
+}
+
+// remove the per-run scratch directory
+void removeScratchDir(){
+	if(scratch_dir_run.size()>0) removeDir(scratch_dir_run);
+	scratch_dir_run = "";
+}
+
+// get the scratch path of a transient file, the file name is unchanged if no scratch directory
+string getScratchFilename(const string &filename){
+	size_t pos;
+
+	if(scratch_dir_run.empty()) return filename;
+	pos = filename.find_last_of("/");
+	return scratch_dir_run + "/" + (pos!=string::npos ? filename.substr(pos+1) : filename);
+}
+
+// remove the transient file if it is in the scratch directory
+void removeScratchFile(const string &filename){
+	if(scratch_dir_run.size()>0 and filename.compare(0, scratch_dir_run.size()+1, scratch_dir_run + "/")==0) removeDir(filename);
+}
+
+// update the 128-bit hash of two 64-bit FNV-1a lanes with different offset bases and primes,
+// the string is terminated by '\0' to separate the successive strings; the lanes are initialized if both are 0
+void hashStrFnv1a(const string &str, uint64_t &hash_a, uint64_t &hash_b){
+	if(hash_a==0 and hash_b==0){
+		hash_a = 0xcbf29ce484222325ULL;
+		hash_b = 0x84222325cbf29ce4ULL;
+	}
+	for(size_t i=0; i<=str.size(); i++){
+		uint8_t c = (i<str.size()) ? (uint8_t)str[i] : 0;
+		hash_a = (hash_a ^ c) * 0x100000001b3ULL;
+		hash_b = (hash_b ^ c) * 0x9e3779b97f4a7c15ULL;
+	}
+}
+
+// copy the file
+bool copyFile(const string &src_filename, const string &dst_filename){
+	ifstream infile;
+	ofstream outfile;
+	bool flag;
+
+	infile.open(src_filename, ios::binary);
+	if(!infile.is_open()) return false;
+	outfile.open(dst_filename, ios::binary);
+	if(!outfile.is_open()){
+		infile.close();
+		return false;
+	}
+	outfile << infile.rdbuf();
+	infile.close();
+	outfile.close();
+	flag = !outfile.fail();
+
+	return flag;
+}
+
+// move the file, it is copied if the source and destination are in different file systems
+bool moveFile(const string &src_filename, const string &dst_filename){
+	if(rename(src_filename.c_str(), dst_filename.c_str())==0) return true;
+	if(errno!=EXDEV) return false;
+
+	if(copyFile(src_filename, dst_filename)==false) return false;
+	remove(src_filename.c_str());
+
+	return true;
+}
+
 // get the number of high ratio indel bases
 vector<double> getTotalHighIndelClipRatioBaseNum(Base *regBaseArr, int64_t arr_size){
 	int32_t i, indel_num, clip_num, total_cov;
@@ -4498,12 +4886,8 @@ void *processSingleMateClipRegDetectWork(void *arg){
 	faidx_t *fai = mate_clip_reg_work_opt->fai;
 	Paras *paras = mate_clip_reg_work_opt->paras;
 	//vector<bool> *clip_processed_flag_vec = mate_clip_reg_work_opt->clip_processed_flag_vec;
-	vector<mateClipReg_t*> *mateClipRegVector = mate_clip_reg_work_opt->mateClipRegVector;
-	vector<reg_t*> *clipRegVector = mate_clip_reg_work_opt->clipRegVector;
-	vector<varCand*> *var_cand_clipReg_vec = mate_clip_reg_work_opt->var_cand_clipReg_vec;
-	vector<Block*> *blockVector = mate_clip_reg_work_opt->blockVector;
 	//int32_t *p_mate_clip_reg_fail_num = mate_clip_reg_work_opt->p_mate_clip_reg_fail_num;
-	pthread_mutex_t *p_mutex_mate_clip_reg = mate_clip_reg_work_opt->p_mutex_mate_clip_reg;
+	mateClipRegDetectResult_t *result = mate_clip_reg_work_opt->result;
 	Time time;
 
 	//cout << "\t[" << time.getTime() << "], [" << mate_clip_reg_work_opt->work_id << "]: " << reg->chrname << ":" << reg->startRefPos << "-" << reg->endRefPos << endl;
@@ -4513,7 +4897,7 @@ void *processSingleMateClipRegDetectWork(void *arg){
 
 	//cout << "\t[" << time.getTime() << "]: process clip regions " << reg->chrname << ":" << reg->startRefPos << "-" << reg->endRefPos << endl;
 	//processClipRegs(work_id, *clip_processed_flag_vec, clip_reg.mate_clip_reg, reg, mateClipRegVector, clipRegVector, *var_cand_clipReg_vec, *blockVector, paras, p_mutex_mate_clip_reg, p_mate_clip_reg_fail_num);
-	processClipRegs(work_id, clip_reg.mate_clip_reg, reg, mateClipRegVector, clipRegVector, *var_cand_clipReg_vec, blockVector, paras, p_mutex_mate_clip_reg);
+	processClipRegs(work_id, clip_reg.mate_clip_reg, reg, result);
 
 	delete (mateClipRegDetectWork_opt *)arg;
 
@@ -4522,12 +4906,11 @@ void *processSingleMateClipRegDetectWork(void *arg){
 
 // process clip regions and mate clip regions
 //void processClipRegs(int32_t work_id, vector<bool> &clip_processed_flag_vec, mateClipReg_t &mate_clip_reg, reg_t *clip_reg, vector<mateClipReg_t*> *mateClipRegVector, vector<reg_t*> *clipRegVector, vector<varCand*> &var_cand_clipReg_vec, vector<Block*> &blockVector, Paras *paras, pthread_mutex_t *p_mutex_mate_clip_reg, int32_t *mate_clip_reg_fail_num){
-void processClipRegs(int32_t work_id, mateClipReg_t &mate_clip_reg, reg_t *clip_reg, vector<mateClipReg_t*> *mateClipRegVector, vector<reg_t*> *clipRegVector, vector<varCand*> &var_cand_clipReg_vec, vector<Block*> *blockVector, Paras *paras, pthread_mutex_t *p_mutex_mate_clip_reg){
+// the results are only stored into the private result slot of the work, and they will be collected after all works are finished
+void processClipRegs(int32_t work_id, mateClipReg_t &mate_clip_reg, reg_t *clip_reg, mateClipRegDetectResult_t *result){
 	size_t i;
-	reg_t *reg, *reg_tmp;
+	reg_t *reg;
 	mateClipReg_t *clip_reg_new;
-	Block *bloc;
-	int32_t idx_tmp;
 
 	if(mate_clip_reg.valid_flag){
 		// add mate clip region
@@ -4566,9 +4949,7 @@ void processClipRegs(int32_t work_id, mateClipReg_t &mate_clip_reg, reg_t *clip_
 			clip_reg_new->supp_num_largeIndel = mate_clip_reg.supp_num_largeIndel;
 			clip_reg_new->depth_largeIndel = mate_clip_reg.depth_largeIndel;
 
-			pthread_mutex_lock(p_mutex_mate_clip_reg);
-			mateClipRegVector->push_back(clip_reg_new);
-			pthread_mutex_unlock(p_mutex_mate_clip_reg);
+			result->mate_clip_reg = clip_reg_new;
 		}
 	}else{
 		// delete mate clip region
@@ -4577,11 +4958,10 @@ void processClipRegs(int32_t work_id, mateClipReg_t &mate_clip_reg, reg_t *clip_
 		if(mate_clip_reg.rightClipReg) { delete mate_clip_reg.rightClipReg; mate_clip_reg.rightClipReg = NULL; }
 		if(mate_clip_reg.rightClipReg2) { delete mate_clip_reg.rightClipReg2; mate_clip_reg.rightClipReg2 = NULL; }
 
-		pthread_mutex_lock(p_mutex_mate_clip_reg);
-		if(mate_clip_reg.var_cand) { removeVarCandNode(mate_clip_reg.var_cand, var_cand_clipReg_vec); mate_clip_reg.var_cand = NULL; } // free item
-		if(mate_clip_reg.left_var_cand_tra) { removeVarCandNode(mate_clip_reg.left_var_cand_tra, var_cand_clipReg_vec); mate_clip_reg.left_var_cand_tra = NULL; }  // free item
-		if(mate_clip_reg.right_var_cand_tra) { removeVarCandNode(mate_clip_reg.right_var_cand_tra, var_cand_clipReg_vec); mate_clip_reg.right_var_cand_tra = NULL; }  // free item
-		pthread_mutex_unlock(p_mutex_mate_clip_reg);
+		// items will be freed after all works are finished
+		if(mate_clip_reg.var_cand) { result->removed_var_cand_vec.push_back(mate_clip_reg.var_cand); mate_clip_reg.var_cand = NULL; }
+		if(mate_clip_reg.left_var_cand_tra) { result->removed_var_cand_vec.push_back(mate_clip_reg.left_var_cand_tra); mate_clip_reg.left_var_cand_tra = NULL; }
+		if(mate_clip_reg.right_var_cand_tra) { result->removed_var_cand_vec.push_back(mate_clip_reg.right_var_cand_tra); mate_clip_reg.right_var_cand_tra = NULL; }
 
 		if(mate_clip_reg.supp_num_valid_flag){
 			// add the region into indel vector
@@ -4608,25 +4988,33 @@ void processClipRegs(int32_t work_id, mateClipReg_t &mate_clip_reg, reg_t *clip_
 			reg->supp_num = reg->DP = 0;
 			reg->discover_level = VAR_DISCOV_L_UNUSED;
 
-			// get position
-			pthread_mutex_lock(p_mutex_mate_clip_reg);
-			idx_tmp = -1;
-			bloc = computeBlocByPos_util(clip_reg->startRefPos, *blockVector, paras);
-			for(i=0; i<bloc->indelVector.size(); i++){
-				reg_tmp = bloc->indelVector.at(i);
-				if(reg->startRefPos<reg_tmp->startRefPos){
-					idx_tmp = i;
-					break;
-				}
-			}
-			// add item
-			if(idx_tmp!=-1) bloc->indelVector.insert(bloc->indelVector.begin()+idx_tmp, reg);
-			else bloc->indelVector.push_back(reg);
-			pthread_mutex_unlock(p_mutex_mate_clip_reg);
+			result->indel_reg = reg;
 		}
 	}
 }
 
+// add the region into the indel vector of its block in order
+void addIndelRegToBlock(reg_t *reg, vector<Block*> &blockVector, Paras *paras){
+	size_t i;
+	reg_t *reg_tmp;
+	Block *bloc;
+	int32_t idx_tmp;
+
+	// get position
+	idx_tmp = -1;
+	bloc = computeBlocByPos_util(reg->startRefPos, blockVector, paras);
+	for(i=0; i<bloc->indelVector.size(); i++){
+		reg_tmp = bloc->indelVector.at(i);
+		if(reg->startRefPos<reg_tmp->startRefPos){
+			idx_tmp = i;
+			break;
+		}
+	}
+	// add item
+	if(idx_tmp!=-1) bloc->indelVector.insert(bloc->indelVector.begin()+idx_tmp, reg);
+	else bloc->indelVector.push_back(reg);
+}
+
 // compute block by reference position
 Block* computeBlocByPos_util(int64_t begPos, vector<Block*> &block_vec, Paras *paras){
 	int32_t bloc_ID = computeBlocID_util(begPos, block_vec, paras);
@@ -4699,98 +5087,6 @@ bool isRegSorted(vector<reg_t*> &regVector){
 	return flag;
 }
 
-// start work process monitor
-void startWorkProcessMonitor(string &work_finish_filename, string &monitoring_proc_names, int32_t max_proc_running_minutes){
-	if(isFileExist(work_finish_filename))
-		remove(work_finish_filename.c_str());
-
-	procMonitor_op *proc_monitor_op = new procMonitor_op();
-	proc_monitor_op->work_finish_filename = work_finish_filename;
-	proc_monitor_op->monitoring_proc_names = monitoring_proc_names;
-	proc_monitor_op->max_proc_running_minutes = max_proc_running_minutes;
-
-	// start new thread
-	pthread_t tid;
-	pthread_create(&tid, NULL, workProcessMonitor, proc_monitor_op);
-	pthread_detach(tid);
-}
-
-// process monitor
-void *workProcessMonitor(void *arg){
-	procMonitor_op *proc_monitor_op = (procMonitor_op *)arg;
-	FILE *fp;
-	char buffer[256];
-	string pscmd, line, tmp, work_finish_filename, monitoring_proc_names;
-	int32_t uid, len, max_proc_running_minutes;
-	vector<string> str_vec, tmp_vec, tmp_vec2;
-	int32_t day, hour, minute, total;
-	pid_t pid;
-
-	work_finish_filename = proc_monitor_op->work_finish_filename;
-	monitoring_proc_names = proc_monitor_op->monitoring_proc_names;
-	max_proc_running_minutes = proc_monitor_op->max_proc_running_minutes;
-	delete (procMonitor_op *)arg;
-
-	while(1){
-		if(isFileExist(work_finish_filename)){
-			remove(work_finish_filename.c_str());
-			//cout << "================ monitor file removed. ==============" << endl;
-			break;
-		}else{
-			pscmd = "ps -C " + monitoring_proc_names;
-			uid = getuid();
-			pscmd += " -o comm,pid,time,uid | awk '$NF ~/" + to_string(uid) + "/'";
-			fp = popen(pscmd.c_str(), "r");
-			if(fp==NULL){
-				//cout << __func__ << ": popen error, wait for " << MONITOR_WAIT_SECONDS << " seconds." << endl;
-				sleep(MONITOR_WAIT_SECONDS);
-				continue;
-			}
-
-			while(fgets(buffer, sizeof(buffer), fp)){
-				//printf("%s", buffer);
-				line = buffer;
-				str_vec = split(line," ");
-//				for(uint32_t i=0; i<str_vec.size(); i++){
-//					cout << "["<< i << "]:" << str_vec.at(i) << endl;
-//				}
-
-				len = str_vec.size();
-				if(len>=4){
-					//compute cpu running time
-					day = hour= minute = 0;
-					if(str_vec.at(len-2).find('-')==string::npos){
-						tmp_vec = split(str_vec.at(len-2), ":");
-						hour = stoi(tmp_vec.at(0));
-						minute = stoi(tmp_vec.at(1));
-					}else{
-						tmp_vec = split(str_vec.at(len-2), "-");
-						day = stoi(tmp_vec.at(0));
-						tmp_vec2 = split(tmp_vec.at(1), ":");
-						hour = stoi(tmp_vec2.at(0));
-						minute =  stoi(tmp_vec2.at(1));
-					}
-					total = day*24*60 + hour*60 + minute;
-					//cout << total << endl;
-
-					// kill process
-					pid = stoi(str_vec.at(len-3));
-					if(total>max_proc_running_minutes){
-						kill(pid, SIGKILL);
-						cout << __func__ << ": " << str_vec.at(0) << " (pid=" << pid << ") was killed because it exceeded the maximum running time (" << max_proc_running_minutes << " minutes). Please do NOT worry, this is programmed rather than error." << endl;
-					}
-				}
-			}
-			pclose(fp);
-		}
-		sleep(MONITOR_WAIT_SECONDS);
-	}
-
-	//cout << "-------------------- End of monitor. ----------------" << endl;
-
-	return NULL;
-}
-
 // destroy the alignment data of the block
 void destoryAlnData(vector<bam1_t*> &alnDataVector){
 	vector<bam1_t*>::iterator aln;
@@ -4807,7 +5103,7 @@ vector<struct alnSeg*> generateAlnSegs(bam1_t* b){
 	uint8_t *seq_int;
 
 	uint32_t *c, op, i = 0, j = 0, startRpos, startQpos;
-	int32_t k, tmp_cigar_len, tmp_MD_len, common_len;  // common_len: used only for match flag
+	int32_t tmp_cigar_len, tmp_MD_len, common_len;  // common_len: used only for match flag
 	string ins_str;
 
 	startRpos = b->core.pos + 1;  // 1-based
@@ -4861,7 +5157,7 @@ vector<struct alnSeg*> generateAlnSegs(bam1_t* b){
 			case BAM_CINS:
 				// add alnSeg item
 				ins_str = "";
-				for(k=0; k<tmp_cigar_len; k++) ins_str += "=ACMGRSVTWYHKDBN"[bam_seqi(seq_int, startQpos+k-1)];
+				decodeBamSeq(seq_int, startQpos-1, tmp_cigar_len, ins_str);
 				alnSegs.push_back(allocateAlnSeg(startRpos, startQpos, tmp_cigar_len, BAM_CINS, ins_str));
 				startQpos += tmp_cigar_len;
 				op = bam_cigar_op(c[++i]);
@@ -4920,7 +5216,7 @@ vector<struct alnSeg*> generateAlnSegs2(bam1_t* b, int64_t startRefPos_paras, in
 	uint8_t *seq_int;
 
 	uint32_t *c, op, i = 0, j = 0, startRpos, startQpos;
-	int32_t k, tmp_cigar_len, tmp_MD_len, common_len, startmatch_idx, endmatch_idx;  // common_len: used only for match flag
+	int32_t tmp_cigar_len, tmp_MD_len, common_len, startmatch_idx, endmatch_idx;  // common_len: used only for match flag
 	string ins_str;
 	bool overlap_flag;
 	int64_t end_ref_pos;
@@ -4990,7 +5286,7 @@ vector<struct alnSeg*> generateAlnSegs2(bam1_t* b, int64_t startRefPos_paras, in
 				if(overlap_flag){
 					// add alnSeg item
 					ins_str = "";
-					for(k=0; k<tmp_cigar_len; k++) ins_str += "=ACMGRSVTWYHKDBN"[bam_seqi(seq_int, startQpos+k-1)];
+					decodeBamSeq(seq_int, startQpos-1, tmp_cigar_len, ins_str);
 					alnSegs.push_back(allocateAlnSeg(startRpos, startQpos, tmp_cigar_len, BAM_CINS, ins_str));
 				}
 				startQpos += tmp_cigar_len;
@@ -5109,7 +5405,7 @@ vector<struct alnSeg*> generateAlnSegs_no_MD(bam1_t* b, Base* BaseArr, int64_t s
 			case BAM_CINS:
 				// add alnSeg item
 				ins_str = "";
-				for(k=0; k<tmp_cigar_len; k++) ins_str += "=ACMGRSVTWYHKDBN"[bam_seqi(seq_int, startQpos+k-1)];
+				decodeBamSeq(seq_int, startQpos-1, tmp_cigar_len, ins_str);
 				alnSegs.push_back(allocateAlnSeg(startRpos, startQpos, tmp_cigar_len, BAM_CINS, ins_str));
 				startQpos += tmp_cigar_len;
 				op = bam_cigar_op(c[++i]);
@@ -5119,7 +5415,7 @@ vector<struct alnSeg*> generateAlnSegs_no_MD(bam1_t* b, Base* BaseArr, int64_t s
 			case BAM_CDEL:
 				// add alnSeg item
 				del = "";
-				for(k=0; k<tmp_cigar_len; k++) del += "=ACMGRSVTWYHKDBN"[bam_seqi(seq_int, startQpos+k-1)];//something wrong?
+				decodeBamSeq(seq_int, startQpos-1, tmp_cigar_len, del);//something wrong?
 				alnSegs.push_back(allocateAlnSeg(startRpos, startQpos, tmp_cigar_len, BAM_CDEL, del));
 				startRpos += tmp_cigar_len;
 				op = bam_cigar_op(c[++i]);
@@ -5145,7 +5441,7 @@ vector<struct alnSeg*> generateAlnSegs_no_MD(bam1_t* b, Base* BaseArr, int64_t s
 				break;
 			case BAM_CDIFF:
 				diff = "";
-				for(k=0; k<tmp_cigar_len; k++) diff += "=ACMGRSVTWYHKDBN"[bam_seqi(seq_int, startQpos+k-1)];
+				decodeBamSeq(seq_int, startQpos-1, tmp_cigar_len, diff);
 				alnSegs.push_back(allocateAlnSeg(startRpos, startQpos, tmp_cigar_len, BAM_CDIFF, diff));
 
 				startQpos += tmp_cigar_len;
@@ -5244,7 +5540,7 @@ vector<struct alnSeg*> generateAlnSegs_no_MD2(bam1_t* b, Base* BaseArr, int64_t
 				if(overlap_flag){
 					// add alnSeg item
 					ins_str = "";
-					for(k=0; k<tmp_cigar_len; k++) ins_str += "=ACMGRSVTWYHKDBN"[bam_seqi(seq_int, startQpos+k-1)];
+					decodeBamSeq(seq_int, startQpos-1, tmp_cigar_len, ins_str);
 					alnSegs.push_back(allocateAlnSeg(startRpos, startQpos, tmp_cigar_len, BAM_CINS, ins_str));
 				}
 				startQpos += tmp_cigar_len;
@@ -5256,7 +5552,7 @@ vector<struct alnSeg*> generateAlnSegs_no_MD2(bam1_t* b, Base* BaseArr, int64_t
 				if(overlap_flag){
 					// add alnSeg item
 					del = "";
-					for(k=0; k<tmp_cigar_len; k++) del += "=ACMGRSVTWYHKDBN"[bam_seqi(seq_int, startQpos+k-1)];//something wrong?
+					decodeBamSeq(seq_int, startQpos-1, tmp_cigar_len, del);//something wrong?
 					alnSegs.push_back(allocateAlnSeg(startRpos, startQpos, tmp_cigar_len, BAM_CDEL, del));
 				}
 				startRpos += tmp_cigar_len;
@@ -5288,7 +5584,7 @@ vector<struct alnSeg*> generateAlnSegs_no_MD2(bam1_t* b, Base* BaseArr, int64_t
 			case BAM_CDIFF:
 				if(overlap_flag){
 					diff = "";
-					for(k=0; k<tmp_cigar_len; k++) diff += "=ACMGRSVTWYHKDBN"[bam_seqi(seq_int, startQpos+k-1)];
+					decodeBamSeq(seq_int, startQpos-1, tmp_cigar_len, diff);
 					alnSegs.push_back(allocateAlnSeg(startRpos, startQpos, tmp_cigar_len, BAM_CDIFF, diff));
 				}
 				startQpos += tmp_cigar_len;
@@ -5372,7 +5668,7 @@ vector<struct alnSeg*> generateAlnSegs_no_MD(bam1_t* b, string &refseq, int64_t
 			case BAM_CINS:
 				// add alnSeg item
 				ins_str = "";
-				for(k=0; k<tmp_cigar_len; k++) ins_str += "=ACMGRSVTWYHKDBN"[bam_seqi(seq_int, startQpos+k-1)];
+				decodeBamSeq(seq_int, startQpos-1, tmp_cigar_len, ins_str);
 				alnSegs.push_back(allocateAlnSeg(startRpos, startQpos, tmp_cigar_len, BAM_CINS, ins_str));
 				startQpos += tmp_cigar_len;
 				op = bam_cigar_op(c[++i]);
@@ -5382,7 +5678,7 @@ vector<struct alnSeg*> generateAlnSegs_no_MD(bam1_t* b, string &refseq, int64_t
 			case BAM_CDEL:
 				// add alnSeg item
 				del = "";
-				for(k=0; k<tmp_cigar_len; k++) del += "=ACMGRSVTWYHKDBN"[bam_seqi(seq_int, startQpos+k-1)];//something wrong?
+				decodeBamSeq(seq_int, startQpos-1, tmp_cigar_len, del);//something wrong?
 				alnSegs.push_back(allocateAlnSeg(startRpos, startQpos, tmp_cigar_len, BAM_CDEL, del));
 				startRpos += tmp_cigar_len;
 				op = bam_cigar_op(c[++i]);
@@ -5408,7 +5704,7 @@ vector<struct alnSeg*> generateAlnSegs_no_MD(bam1_t* b, string &refseq, int64_t
 				break;
 			case BAM_CDIFF:
 				diff = "";
-				for(k=0; k<tmp_cigar_len; k++) diff += "=ACMGRSVTWYHKDBN"[bam_seqi(seq_int, startQpos+k-1)];
+				decodeBamSeq(seq_int, startQpos-1, tmp_cigar_len, diff);
 				alnSegs.push_back(allocateAlnSeg(startRpos, startQpos, tmp_cigar_len, BAM_CDIFF, diff));
 
 				startQpos += tmp_cigar_len;
@@ -5510,7 +5806,7 @@ vector<struct alnSeg*> generateAlnSegs_no_MD2(bam1_t* b, string &refseq, int64_t
 				if(overlap_flag){
 					// add alnSeg item
 					ins_str = "";
-					for(k=0; k<tmp_cigar_len; k++) ins_str += "=ACMGRSVTWYHKDBN"[bam_seqi(seq_int, startQpos-leftHardClipSize+k-1)];
+					decodeBamSeq(seq_int, startQpos-leftHardClipSize-1, tmp_cigar_len, ins_str);
 					alnSegs.push_back(allocateAlnSeg(startRpos, startQpos, tmp_cigar_len, BAM_CINS, ins_str));
 				}
 
@@ -5522,7 +5818,7 @@ vector<struct alnSeg*> generateAlnSegs_no_MD2(bam1_t* b, string &refseq, int64_t
 				if(overlap_flag){
 					// add alnSeg item
 					del = "";
-					for(k=0; k<tmp_cigar_len; k++) del += "=ACMGRSVTWYHKDBN"[bam_seqi(seq_int, startQpos-leftHardClipSize+k-1)];//something wrong?
+					decodeBamSeq(seq_int, startQpos-leftHardClipSize-1, tmp_cigar_len, del);//something wrong?
 					alnSegs.push_back(allocateAlnSeg(startRpos, startQpos, tmp_cigar_len, BAM_CDEL, del));
 				}
 
@@ -6327,9 +6623,9 @@ bool isQcSigMatch(qcSig_t *qc_sig, qcSig_t *seed_qc_sig, int64_t max_ref_dist_ma
 								 if(ref_distance>0 and min_val/ref_distance > 1-consist_ratio_match_thres){
 									// get sequences
 									comp_seqs = extractQcSigCompSeqs(qc_sig, seed_qc_sig, fai);
-									identity_val = computeVarseqIdentity(comp_seqs.at(0), comp_seqs.at(1));
+									identity_val = computeVarseqIdentity(comp_seqs.at(0), comp_seqs.at(1), consist_ratio_match_thres);
 								}else
-									identity_val = computeVarseqIdentity(qc_sig->altseq, seed_qc_sig->altseq);
+									identity_val = computeVarseqIdentity(qc_sig->altseq, seed_qc_sig->altseq, consist_ratio_match_thres);
 #if POA_ALIGN_DEBUG
 								cout << "identity_val=" << identity_val << ", cigar_op_len1=" << qc_sig->cigar_op_len << ", cigar_op_len2=" << seed_qc_sig->cigar_op_len << ", qc_sig.altseq=" << qc_sig->altseq << ", seed_qc_sig.altseq=" << seed_qc_sig->altseq << endl;
 #endif
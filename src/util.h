@@ -17,6 +17,7 @@
 #include "clipReg.h"
 
 #include "Paras.h"
+#include "procRunner.h"
 
 using namespace std;
 
@@ -27,7 +28,9 @@ char getBase(string &seq, size_t pos, size_t orient);
 void reverseSeq(string &seq);
 void reverseComplement(string &seq);
 void upperSeq(string &seq);
+void decodeBamSeq(const uint8_t *seq_int, int64_t start, int64_t len, string &seq);
 size_t getCtgCount(string &contigfilename);
+int64_t getTotalSeqLen(vector<string> &seq_vec);
 reg_t* dupVarReg(reg_t *reg);
 reg_t* findVarvecItem(int32_t startPos, int32_t endPos, vector<reg_t*> &varVec);
 vector<reg_t*> findVarvecItemAll(int32_t startPos, int32_t endPos, vector<reg_t*> &varVec);
@@ -61,7 +64,7 @@ void mergeNeighbouringVars(vector<reg_t*> &regVector, int32_t max_ref_dist_thres
 double calculate_merge_identity_threshold(int32_t common_length, int32_t max_common_length, double min_merge_identity_thres);
 int32_t calculate_merge_distance_threshold(int32_t max_ref_dist_thres, int32_t support_num, int32_t sv_len, int32_t comp_sv_size);
 int32_t calculate_merge_distance_threshold(bool complex_region_flag, int32_t query_supp_num, int32_t query_sv_size, int32_t total_sv_num, double query_sv_support_different);
-bool ComplexRegionFlag(vector<reg_t*> regVector);
+bool ComplexRegionFlag(vector<reg_t*> &regVector);
 
 void printRegVec(vector<reg_t*> &regVec, string header);
 void printMateClipReg(mateClipReg_t *mate_clip_reg);
@@ -73,9 +76,14 @@ int32_t getLineCount(string &filename);
 bool isBaseMatch(char ctgBase, char refBase);
 bool isRegValid(reg_t *reg, int32_t min_size);
 void exchangeRegLoc(reg_t *reg);
-int32_t minimap2Aln(string &alnfilename, string &contigfilename, string &refseqfilename, int32_t max_proc_running_minutes);
-int32_t blatAln(string &alnfilename, string &contigfilename, string &refseqfilename, int32_t max_proc_running_minutes);
-int32_t getSuccessStatusSystemCmd(int32_t status);
+int32_t minimap2Aln(string &alnfilename, string &contigfilename, string &refseqfilename, int32_t max_proc_running_minutes, killedWorkRecord_t *killed_work_rec=NULL, string extra_opts="");
+int32_t minimap2AlnBatch(vector<string> &alnfilename_vec, vector<string> &contigfilename_vec, vector<string> &refseqfilename_vec, string &batch_prefix, int32_t max_proc_running_minutes);
+bool getRefseqRegion(string &refseqfilename, string &chrname, int64_t &start_pos, int64_t &end_pos);
+int32_t minimap2AlnInProc(string &alnfilename, string &contigfilename, string &refseqfilename, vector<pafRecord_t> &paf_rec_vec);
+bool parsePafLine(string &line, pafRecord_t &paf_rec);
+void savePafRecords(string &alnfilename, vector<pafRecord_t> &paf_rec_vec);
+int32_t blatAln(string &alnfilename, string &contigfilename, string &refseqfilename, int32_t max_proc_running_minutes, killedWorkRecord_t *killed_work_rec=NULL);
+void recordKilledWork(void *arg);
 bool isBlatAlnResultMatch(string &contigfilename, string &alnfilename);
 bool isMinimap2AlnResultMatch(string &contigfilename, string &alnfilename);
 int32_t getQueryNameLoc(string &query_name, vector<string> &query_name_vec);
@@ -98,7 +106,7 @@ void destroyConsWorkOptVec(vector<cnsWork_opt*> &cns_work_vec);
 void deleteItemFromCnsWorkVec(int32_t item_id, vector<cnsWork_opt*> &cns_work_vec);
 int32_t getItemIDFromCnsWorkVec(string &contigfilename, vector<cnsWork_opt*> &cns_work_vec);
 void* processSingleConsWork(void *arg);
-void performLocalCons(string &readsfilename, string &contigfilename, string &refseqfilename, string &clusterfilename, string &tmpdir, string &technology, double min_identity_match, int32_t sv_len_est, size_t num_threads_per_cns_work, vector<reg_t*> &varVec, string &chrname, string &inBamFile, faidx_t *fai, int32_t cns_extend_size, ofstream &cns_info_file, double expected_cov_cns, double min_input_cov_canu, double max_ultra_high_cov, int32_t minMapQ, int32_t minHighMapQ, bool delete_reads_flag, bool keep_failed_reads_flag, bool clip_reg_flag, int32_t minClipEndSize, int32_t minConReadLen, int32_t min_sv_size, int32_t min_supp_num, double max_seg_size_ratio, bool limit_reg_process_flag, vector<simpleReg_t*> &limit_reg_vec);
+void performLocalCons(string &readsfilename, string &contigfilename, string &refseqfilename, string &clusterfilename, string &tmpdir, string &technology, double min_identity_match, int32_t sv_len_est, size_t num_threads_per_cns_work, vector<reg_t*> &varVec, string &chrname, string &inBamFile, faidx_t *fai, int32_t cns_extend_size, ofstream &cns_info_file, double expected_cov_cns, double min_input_cov_canu, double max_ultra_high_cov, int32_t minMapQ, int32_t minHighMapQ, bool delete_reads_flag, bool keep_failed_reads_flag, bool clip_reg_flag, int32_t minClipEndSize, int32_t minConReadLen, int32_t min_sv_size, int32_t min_supp_num, double max_seg_size_ratio, int32_t max_proc_running_minutes, bool limit_reg_process_flag, vector<simpleReg_t*> &limit_reg_vec);
 bool isReadableFile(string &filename);
 void* processSingleMinimap2AlnWork(void *arg);
 void* processSingleBlatAlnWork(void *arg);
@@ -121,6 +129,16 @@ void getRegByFilename(simpleReg_t *reg, string &filename, string &pattern_str);
 vector<simpleReg_t*> extractSimpleRegsByStr(string &regs_str);
 string getLimitRegStr(vector<simpleReg_t*> &limit_reg_vec);
 void createDir(string &dirname);
+void removeDir(const string &path);
+void removeFilesByPrefix(const string &prefix);
+string getDefaultScratchDir();
+void initScratchDir(const string &scratch_dir);
+void removeScratchDir();
+string getScratchFilename(const string &filename);
+void removeScratchFile(const string &filename);
+void hashStrFnv1a(const string &str, uint64_t &hash_a, uint64_t &hash_b);
+bool copyFile(const string &src_filename, const string &dst_filename);
+bool moveFile(const string &src_filename, const string &dst_filename);
 vector<double> getTotalHighIndelClipRatioBaseNum(Base *regBaseArr, int64_t arr_size);
 vector<mismatchReg_t*> getMismatchRegVec(localAln_t *local_aln);
 vector<mismatchReg_t*> getMismatchRegVecWithoutPos(localAln_t *local_aln);
@@ -151,13 +169,12 @@ bool isDecoyChr(string &chrname);
 bool isAltChr(string &chrname);
 void removeVarCandNode(varCand *var_cand, vector<varCand*> &var_cand_vec);
 void *processSingleMateClipRegDetectWork(void *arg);
-void processClipRegs(int32_t work_id, mateClipReg_t &mate_clip_reg, reg_t *reg, vector<mateClipReg_t*> *mateClipRegVector, vector<reg_t*> *clipRegVector, vector<varCand*> &var_cand_clipReg_vec, vector<Block*> *blockVector, Paras *paras, pthread_mutex_t *p_mutex_mate_clip_reg);
+void processClipRegs(int32_t work_id, mateClipReg_t &mate_clip_reg, reg_t *reg, mateClipRegDetectResult_t *result);
+void addIndelRegToBlock(reg_t *reg, vector<Block*> &blockVector, Paras *paras);
 Block* computeBlocByPos_util(int64_t begPos, vector<Block*> &block_vec, Paras *paras);
 int32_t computeBlocID_util(int64_t begPos, vector<Block*> &block_vec, Paras *paras);
 void sortRegVec(vector<reg_t*> &regVector);
 bool isRegSorted(vector<reg_t*> &regVector);
-void startWorkProcessMonitor(string &work_finish_filename, string &monitoring_proc_names, int32_t max_proc_running_minutes);
-void *workProcessMonitor(void *arg);
 
 void destoryAlnData(vector<bam1_t*> &alnDataVector);
 vector<struct alnSeg*> generateAlnSegs(bam1_t* b);
@@ -49,6 +49,8 @@ void varCand::init(){
 	minimap2_var_cand_file = NULL;
 	limit_reg_delete_flag = false;
 	killed_flag = false;
+	max_proc_running_minutes = 0;
+	minimap2_lib_flag = false;
 	minClipEndSize = MIN_CLIP_END_SIZE;
 	max_ultra_high_cov = MAX_ULTRA_HIGH_COV_THRES;
 	minMapQ = MIN_MAPQ_THRES;
@@ -59,9 +61,9 @@ void varCand::init(){
 	mtx_killed_blat_work = NULL;
 	//killed_flag = false;
 
-//	killed_minimap2_work_vec = NULL;
-//	killed_minimap2_work_file = NULL;
-//	mtx_killed_minimap2_work = NULL;
+	killed_minimap2_work_vec = NULL;
+	killed_minimap2_work_file = NULL;
+	mtx_killed_minimap2_work = NULL;
 	//killed_flag = false;
 
 	gt_min_sig_size = GT_SIG_SIZE_THRES;
@@ -113,11 +115,34 @@ void varCand::setGtParas(int32_t gt_min_sig_size, double gt_size_ratio_match, do
 	this->gt_min_sup_num_recover = gt_min_sup_num_recover;
 }
 
+// killed work record of the minimap2 or blat work, filled by the watchdog when the work is killed
+killedWorkRecord_t varCand::initKilledWorkRecord(bool minimap2_flag){
+	killedWorkRecord_t killed_work_rec;
+
+	killed_work_rec.alnfilename = alnfilename;
+	killed_work_rec.ctgfilename = ctgfilename;
+	killed_work_rec.refseqfilename = refseqfilename;
+	if(minimap2_flag){
+		killed_work_rec.killed_minimap2_work_vec = killed_minimap2_work_vec;
+		killed_work_rec.killed_blat_work_vec = NULL;
+		killed_work_rec.killed_work_file = killed_minimap2_work_file;
+		killed_work_rec.mtx_killed_work = mtx_killed_minimap2_work;
+	}else{
+		killed_work_rec.killed_minimap2_work_vec = NULL;
+		killed_work_rec.killed_blat_work_vec = killed_blat_work_vec;
+		killed_work_rec.killed_work_file = killed_blat_work_file;
+		killed_work_rec.mtx_killed_work = mtx_killed_blat_work;
+	}
+
+	return killed_work_rec;
+}
+
 bool varCand::getMinimap2WorkKilledFlag(){
 	killedMinimap2Work_t *killed_minimap2_work;
 	bool killed_flag = false;
 
 	if(killed_minimap2_work_vec and killed_minimap2_work_file and mtx_killed_minimap2_work){ // pointer should not be NULL
+		pthread_mutex_lock(mtx_killed_minimap2_work);  // the vector is also appended by the watchdog thread
 		for(size_t i=0; i<killed_minimap2_work_vec->size(); i++){
 			killed_minimap2_work = killed_minimap2_work_vec->at(i);
 			if(alnfilename.compare(killed_minimap2_work->alnfilename)==0 and ctgfilename.compare(killed_minimap2_work->ctgfilename)==0 and refseqfilename.compare(killed_minimap2_work->refseqfilename)==0){
@@ -125,6 +150,7 @@ bool varCand::getMinimap2WorkKilledFlag(){
 				break;
 			}
 		}
+		pthread_mutex_unlock(mtx_killed_minimap2_work);
 	}
 
 	return killed_flag;
@@ -135,6 +161,7 @@ bool varCand::getBlatWorkKilledFlag(){
 	bool killed_flag = false;
 
 	if(killed_blat_work_vec and killed_blat_work_file and mtx_killed_blat_work){ // pointer should not be NULL
+		pthread_mutex_lock(mtx_killed_blat_work);  // the vector is also appended by the watchdog thread
 		for(size_t i=0; i<killed_blat_work_vec->size(); i++){
 			killed_blat_work = killed_blat_work_vec->at(i);
 			if(alnfilename.compare(killed_blat_work->alnfilename)==0 and ctgfilename.compare(killed_blat_work->ctgfilename)==0 and refseqfilename.compare(killed_blat_work->refseqfilename)==0){
@@ -142,6 +169,7 @@ bool varCand::getBlatWorkKilledFlag(){
 				break;
 			}
 		}
+		pthread_mutex_unlock(mtx_killed_blat_work);
 	}
 
 	return killed_flag;
@@ -151,6 +179,11 @@ bool varCand::getBlatWorkKilledFlag(){
 void varCand::alnCtg2Refseq02(){
 	//cout << "Minimap2 align: " << alnfilename << endl;
 
+	int32_t ret;
+	killedWorkRecord_t killed_work_rec;
+
+	if(killed_flag==false) killed_flag = getMinimap2WorkKilledFlag();
+
 	bool minimap2_aln_done_flag = getMinimap2AlnDoneFlag();
 
 //	if(alnfilename.compare("output_ccs_v1.1.3_20220127/3_call/1/blat_contig_1_2632630-2684576_1_2686251-2691837.sim4")==0){
@@ -158,8 +191,21 @@ void varCand::alnCtg2Refseq02(){
 //	}
 
 	if(cns_success and minimap2_aln_done_flag==false){
-		if(!isFileExist(alnfilename) or !isMinimap2AlnResultMatch(ctgfilename, alnfilename)){ // file not exist, or query names not match
-			minimap2Aln(alnfilename, ctgfilename, refseqfilename, max_proc_running_minutes); // MINIMAP2 alignment
+		if((!isFileExist(alnfilename) or !isMinimap2AlnResultMatch(ctgfilename, alnfilename)) and killed_flag==false){ // file not exist, or query names not match
+			ret = -1;
+			if(minimap2_lib_flag){ // in-process alignment, the alignments are kept without parsing the PAF file again
+				vector<pafRecord_t> paf_rec_vec;
+				if(minimap2AlnInProc(alnfilename, ctgfilename, refseqfilename, paf_rec_vec)==0){
+					destroyMinimap2AlnVec(minimap2_aln_vec);
+					minimap2_aln_vec = generateMinimap2AlnVec(paf_rec_vec, ctgfilename, refseqfilename);
+					ret = 0;
+				}
+			}
+			if(ret!=0){ // MINIMAP2 alignment
+				killed_work_rec = initKilledWorkRecord(true);
+				ret = minimap2Aln(alnfilename, ctgfilename, refseqfilename, max_proc_running_minutes, &killed_work_rec);
+				if(ret==PROC_RET_TIMEOUT) killed_flag = true; // killed work, it was recorded by the watchdog
+			}
 		}
 
 	// record blat aligned information
@@ -170,7 +216,7 @@ void varCand::alnCtg2Refseq02(){
 // align contig to refseq
 void varCand::alnCtg2Refseq(){
 	int32_t ret;
-	killedBlatWork_t *killed_blat_work;
+	killedWorkRecord_t killed_work_rec;
 
 	//cout << "BLAT align: " << alnfilename << endl;
 
@@ -187,22 +233,9 @@ void varCand::alnCtg2Refseq(){
 		//if(!isFileExist(alnfilename) or !isBlatAlnCompleted(alnfilename) or !isBlatAlnResultMatch(ctgfilename, alnfilename)){ // file not exist, or query names not match, or blat align uncompleted
 		if(!isFileExist(alnfilename) or !isBlatAlnResultMatch(ctgfilename, alnfilename)){ // file not exist, or query names not match
 			if(killed_flag==false){
-				ret = blatAln(alnfilename, ctgfilename, refseqfilename, max_proc_running_minutes); // BLAT alignment
-				if(ret==-2){ // killed work, then add it to vector and record it to file
-					if(killed_blat_work_vec and killed_blat_work_file and mtx_killed_blat_work){ // pointer should not be NULL
-						killed_flag = true;
-
-						killed_blat_work = new killedBlatWork_t();
-						killed_blat_work->alnfilename = alnfilename;
-						killed_blat_work->ctgfilename = ctgfilename;
-						killed_blat_work->refseqfilename = refseqfilename;
-
-						pthread_mutex_lock(mtx_killed_blat_work);
-						(*killed_blat_work_vec).push_back(killed_blat_work);
-						*killed_blat_work_file << alnfilename << "\t" << ctgfilename << "\t" << refseqfilename << endl;
-						pthread_mutex_unlock(mtx_killed_blat_work);
-					}
-				}
+				killed_work_rec = initKilledWorkRecord(false);
+				ret = blatAln(alnfilename, ctgfilename, refseqfilename, max_proc_running_minutes, &killed_work_rec); // BLAT alignment
+				if(ret==PROC_RET_TIMEOUT) killed_flag = true; // killed work, it was recorded by the watchdog
 			}
 		}
 
@@ -479,13 +512,35 @@ void varCand::minimap2Parse(){
 
 // parse Minimap2 alignments (paf format)
 vector<minimap2_aln_t*> varCand::minimap2Parse(string &alnfilename, string &ctgfilename, string &refseqfilename){
-	vector<minimap2_aln_t*> minimap2_aln_vec;
-	string line, ref_name, ref_name_split, ref_region, relative_srtand, cigar_tag, cigar, chrname, cons_seq, ref_seq;
-	vector<string> line_vec, line_vec1, ref_name_vec1, ref_name_vec2, ref_name_vec3, cigar_tag_split, query_name_vec;
+	string line;
 	ifstream infile;
-	int32_t i, j, ref_start_all, ref_end_all, query_loc, minimap2_aln_id;//r_dis, q_dis;//subject_dis
+	pafRecord_t paf_rec;
+	vector<pafRecord_t> paf_rec_vec;
+
+	infile.open(alnfilename);
+	if(!infile.is_open()){
+		cerr << __func__ << "(), line=" << __LINE__ << ": cannot open file:" << alnfilename << endl;
+		exit(1);
+	}
+
+	while(getline(infile, line)){
+		if(line.size() and parsePafLine(line, paf_rec))
+			paf_rec_vec.push_back(paf_rec);
+	}
+	infile.close();
+
+	return generateMinimap2AlnVec(paf_rec_vec, ctgfilename, refseqfilename);
+}
+
+// generate the minimap2 alignments from PAF records
+vector<minimap2_aln_t*> varCand::generateMinimap2AlnVec(vector<pafRecord_t> &paf_rec_vec, string &ctgfilename, string &refseqfilename){
+	vector<minimap2_aln_t*> minimap2_aln_vec;
+	string ref_name_split, ref_region, chrname, cons_seq, ref_seq;
+	vector<string> line_vec1, ref_name_vec1, ref_name_vec2, ref_name_vec3, query_name_vec;
+	int32_t j, ref_start_all, ref_end_all, query_loc, minimap2_aln_id;//r_dis, q_dis;//subject_dis
 	minimap2_aln_t *minimap2_aln_item;
 	vector<struct pafalnSeg*> pafalnsegs;
+	pafRecord_t *paf_rec;
 
 	// load query names
 	FastaSeqLoader fa_loader(ctgfilename);
@@ -495,102 +550,62 @@ vector<minimap2_aln_t*> varCand::minimap2Parse(string &alnfilename, string &ctgf
 	FastaSeqLoader ref_loader(refseqfilename);
 	ref_seq = ref_loader.getFastaSeq(0);
 
-	infile.open(alnfilename);
-	if(!infile.is_open()){
-		cerr << __func__ << "(), line=" << __LINE__ << ": cannot open file:" << alnfilename << endl;
-		exit(1);
-	}
-
 	// fill the data
 	minimap2_aln_id = 0;
-	i = 0;
-	while(getline(infile, line)){
-		if(line.size()){
-			line_vec = split(line, "\t");
-			// get the query name
-			query_loc = getQueryNameLoc(line_vec.at(0), query_name_vec);
-			if(query_loc==-1){
-				//cerr << __func__ << "(), line=" << __LINE__ << ": cannot get queryloc by query_name: " << line_vec.at(0) << endl;
-				//exit(1);
-				continue;
-			}
-			i += 1;
-
-			// get ref_start_all
-			ref_name = line_vec.at(5);
-			ref_name_vec1 = split(ref_name, ":");
-			chrname = ref_name_vec1.at(0);
-			ref_name_split = ref_name_vec1.at(1);
-			ref_name_vec2 = split(ref_name_split, "___");
-			ref_region = ref_name_vec2.at(0);
-			ref_name_vec3 = split(ref_region, "-");
-			ref_start_all = stoi(ref_name_vec3.at(0)) - 1;
-			ref_end_all = stoi(ref_name_vec3.at(1)) - 1;
-
-			//get qname vec
-			line_vec1 = split(line_vec.at(0), "-");
-			vector<string> qname_vec;
-			for(j=1; j<(int32_t)line_vec1.size(); j++) qname_vec.push_back(line_vec1.at(j));
-
-			//query_len = stoi(line_vec.at(1));
-
-			minimap2_aln_item = new minimap2_aln_t;
-			minimap2_aln_item->minimap2_aln_id = minimap2_aln_id++;
-			minimap2_aln_item->query_len = stoi(line_vec.at(1));
-			minimap2_aln_item->query_id = query_loc;
-			minimap2_aln_item->chrname = chrname;
-			//minimap2_aln_item->query_start = stoi(line_vec.at(2)) + 1; //start from 1
-			minimap2_aln_item->query_start = stoi(line_vec.at(2)); //start from 0
-			minimap2_aln_item->query_end = stoi(line_vec.at(3));
-			minimap2_aln_item->region_startRefPos = ref_start_all;
-			minimap2_aln_item->region_endRefPos = ref_end_all;
-			minimap2_aln_item->qname = qname_vec;
-
-			//get relative strand
-			relative_srtand = line_vec.at(4);
-			if(relative_srtand.compare("+")==0){
-				minimap2_aln_item->relative_strand = ALN_PLUS_ORIENT;
-			}else{// if(relative_srtand.compare("-")==0)
-				minimap2_aln_item->relative_strand = ALN_MINUS_ORIENT;
-			}
-			minimap2_aln_item->subject_len = stoi(line_vec.at(6));
-			//minimap2_aln_item->subject_start = stoi(line_vec.at(7)) + 1; //start from 1
-			minimap2_aln_item->subject_start = stoi(line_vec.at(7)); //start from 0
-			minimap2_aln_item->subject_end = stoi(line_vec.at(8));
-			//match_base_num = stoi(line_vec[9]);
-			//match_ref_len = stoi(line_vec[10]);
-			//match_base_num = minimap2_aln_item->query_end - minimap2_aln_item->query_start + 1;
-			//match_ref_len = minimap2_aln_item->subject_end - minimap2_aln_item->subject_start + 1;
-			//minimap2_aln_item->ref_start = ref_start_all + minimap2_aln_item->subject_start - 1;
-			//minimap2_aln_item->ref_end = ref_end_all + minimap2_aln_item->subject_end -1;
-
-			//get cigar
-			cigar_tag = line_vec.at(line_vec.size()-1);
-			cigar_tag_split = split(cigar_tag, ":");
-			if(cigar_tag_split.at(0).compare("cg")==0){
-				cigar = cigar_tag_split.at(2);
-				minimap2_aln_item->cigar = cigar;
-			}else{
-				cerr << "In " << __func__ << "(), cannot find 'cg' tag in PAF alignment file, error!" << endl;
-				exit(1);
-			}
-
-			cons_seq = fa_loader.getFastaSeq(query_loc, minimap2_aln_item->relative_strand);
-
-			//parse cigar and generate pafalnsegs
-			pafalnsegs = generatePafAlnSegs(minimap2_aln_item, cons_seq, ref_seq);
-			minimap2_aln_item->pafalnsegs = pafalnsegs;
-
-//			//2022.9.21 miss DEL
-//			if(pafalnsegs.size()>0)
-//				getMissingPafInDelsAtAlnSegEnd(minimap2_aln_item->pafalnsegs, pafalnsegs, minimap2_aln_item->region_startRefPos, minimap2_aln_item->region_endRefPos, minimap2_aln_item->query_start, minimap2_aln_item->query_end, minimap2_aln_item->query_len, minimap2_aln_item->subject_len, minimap2_aln_item->subject_start, minimap2_aln_item->subject_end, match_base_num, match_ref_len, cons_seq, ref_seq, minimap2_aln_item->relative_strand);
-			minimap2_aln_vec.push_back(minimap2_aln_item);
+	for(size_t i=0; i<paf_rec_vec.size(); i++){
+		paf_rec = &paf_rec_vec.at(i);
+
+		// get the query name
+		query_loc = getQueryNameLoc(paf_rec->query_name, query_name_vec);
+		if(query_loc==-1){
+			//cerr << __func__ << "(), line=" << __LINE__ << ": cannot get queryloc by query_name: " << paf_rec->query_name << endl;
+			//exit(1);
+			continue;
 		}
+
+		// get ref_start_all
+		ref_name_vec1 = split(paf_rec->subject_name, ":");
+		chrname = ref_name_vec1.at(0);
+		ref_name_split = ref_name_vec1.at(1);
+		ref_name_vec2 = split(ref_name_split, "___");
+		ref_region = ref_name_vec2.at(0);
+		ref_name_vec3 = split(ref_region, "-");
+		ref_start_all = stoi(ref_name_vec3.at(0)) - 1;
+		ref_end_all = stoi(ref_name_vec3.at(1)) - 1;
+
+		//get qname vec
+		line_vec1 = split(paf_rec->query_name, "-");
+		vector<string> qname_vec;
+		for(j=1; j<(int32_t)line_vec1.size(); j++) qname_vec.push_back(line_vec1.at(j));
+
+		minimap2_aln_item = new minimap2_aln_t;
+		minimap2_aln_item->minimap2_aln_id = minimap2_aln_id++;
+		minimap2_aln_item->query_len = paf_rec->query_len;
+		minimap2_aln_item->query_id = query_loc;
+		minimap2_aln_item->chrname = chrname;
+		minimap2_aln_item->query_start = paf_rec->query_start; //start from 0
+		minimap2_aln_item->query_end = paf_rec->query_end;
+		minimap2_aln_item->region_startRefPos = ref_start_all;
+		minimap2_aln_item->region_endRefPos = ref_end_all;
+		minimap2_aln_item->qname = qname_vec;
+		minimap2_aln_item->relative_strand = paf_rec->relative_strand;
+		minimap2_aln_item->subject_len = paf_rec->subject_len;
+		minimap2_aln_item->subject_start = paf_rec->subject_start; //start from 0
+		minimap2_aln_item->subject_end = paf_rec->subject_end;
+		minimap2_aln_item->cigar = paf_rec->cigar;
+
+		cons_seq = fa_loader.getFastaSeq(query_loc, minimap2_aln_item->relative_strand);
+
+		//parse cigar and generate pafalnsegs
+		pafalnsegs = generatePafAlnSegs(minimap2_aln_item, cons_seq, ref_seq);
+		minimap2_aln_item->pafalnsegs = pafalnsegs;
+
+		minimap2_aln_vec.push_back(minimap2_aln_item);
 	}
-	infile.close();
 
 	return minimap2_aln_vec;
 }
+
 //check the missing large InDels at alignment ends
 void varCand::getMissingPafInDelsAtAlnSegEnd(vector<struct pafalnSeg*> &all_pafalnsegs, vector<struct pafalnSeg*> &pafalnsegs, int32_t region_refstart, int32_t region_refend, int32_t querystart, int32_t queryend, int32_t query_len, int32_t subjectlen, int32_t subjectstart, int32_t subjectend, int32_t match_base_num, int32_t match_ref_len, string cons_seq, string ref_seq, int32_t aln_orient){
 	//struct pafalnSeg* seg;
@@ -1494,11 +1509,15 @@ vector<reg_t*> varCand::rescueIndelVarLoc(){
 	vector<string> qname_vec;
 	vector<clipAlnData_t*> clipAlnDataVector;
 	bool flag;
-	int64_t start_var_pos, end_var_pos, startRefPos_cns, endRefPos_cns, chrlen_tmp, mem_avail;
+	int64_t start_var_pos, end_var_pos, startRefPos_cns, endRefPos_cns, chrlen_tmp, mem_cost;
+	int32_t cpu_tokens;
 	ofstream outfile_rescue_reads, outfile_rescue_refseq, outfile_rescue_cns;
-	string rescue_readsfilename, rescue_refseqfilename, rescue_cnsfilename, rescue_alnfilename, tmp_cns_filename, refseq, reg_str, cmd, cmd2;
-	string cons_header, minimap2_cmd, output_prefix, tmp_reg_str;
-	int32_t seq_len, ret_status, status, serial_number, left_shift_size, right_shift_size, len;
+	string rescue_readsfilename, rescue_refseqfilename, rescue_cnsfilename, rescue_alnfilename, tmp_cns_filename, refseq, reg_str;
+	string cons_header, output_prefix, tmp_reg_str;
+	vector<string> argv_vec;
+	procOpt_t proc_opt;
+	procResult_t proc_result;
+	int32_t seq_len, ret_status, serial_number, left_shift_size, right_shift_size, len;
 	char *p_seq;
 	vector<struct querySeqInfoNode*> query_seq_info_all;
 	struct seqsVec *smoothed_seqs;
@@ -1577,7 +1596,7 @@ vector<reg_t*> varCand::rescueIndelVarLoc(){
 
 		if(query_seq_info_all.size()>0){
 			// construct the reads file
-			rescue_readsfilename = out_dir_call + "/rescue_reads_" + chrname + "_" + to_string(start_var_pos) + "-" + to_string(end_var_pos) + "_" + to_string(k) + ".fa";
+			rescue_readsfilename = getScratchFilename(out_dir_call + "/rescue_reads_" + chrname + "_" + to_string(start_var_pos) + "-" + to_string(end_var_pos) + "_" + to_string(k) + ".fa");
 //			cout << rescue_readsfilename << endl;
 
 			outfile_rescue_reads.open(rescue_readsfilename);
@@ -1595,45 +1614,28 @@ vector<reg_t*> varCand::rescueIndelVarLoc(){
 				for(i=0; i<n_seqs; i++) outfile_rescue_reads << ">" << smoothed_seqs->qname.at(i) << endl << smoothed_seqs->seqs.at(i) << endl;
 				outfile_rescue_reads.close();
 
-				flag = false;
-				while(1){
-					pthread_mutex_lock(&mutex_mem);
-					mem_avail = getMemInfo("MemAvailable", 2);
-					// prepare for alignment computation
-					if(mem_total-mem_avail<=mem_total*mem_use_block_factor+extend_total*extend_use_block_factor){
-						work_num ++;
-						flag = true;
-					}
-					pthread_mutex_unlock(&mutex_mem);
+				id = rescue_readsfilename.find_last_of("/");
+				id2 = rescue_readsfilename.find_last_of(".");
+				len = id2 - id;
+				if(id!=string::npos and id2!=string::npos) tmp_reg_str = rescue_readsfilename.substr(id+1, len-1);
+				else{
+					cerr << "line=" << __LINE__ << ", cannot find the / in " << rescue_readsfilename << ", error." << endl;
+					exit(1);
+				}
 
-					if(flag==false){ // block the alignment computation
-						//cout << "\t" << __func__ << ": wait " << mem_wait_seconds << " seconds, mem_avail=" << (mem_avail >> 10) << " MB, work_num=" << work_num << ", " << contigfilename << endl;
-						sleep(mem_wait_seconds);
-					}else{
-						id = rescue_readsfilename.find_last_of("/");
-						id2 = rescue_readsfilename.find_last_of(".");
-						len = id2 - id;
-						if(id!=string::npos and id2!=string::npos) tmp_reg_str = rescue_readsfilename.substr(id+1, len-1);
-						else{
-							cerr << "line=" << __LINE__ << ", cannot find the / in " << rescue_readsfilename << ", error." << endl;
-							exit(1);
-						}
+				// reserve the memory tokens before launching wtdbg2
+				mem_cost = estimateMemCostByReads(MEM_JOB_WTDBG2, smoothed_seqs->seqs.size(), getTotalSeqLen(smoothed_seqs->seqs));
+				acquireMemTokens(MEM_JOB_WTDBG2, mem_cost);
 
-						output_prefix = "tmp_rescue_wtdbg2_" + tmp_reg_str;
-						cmd = "wtdbg2.pl -t 8 -x " + technology + " -o " + output_prefix + " -a -q " + rescue_readsfilename + " > /dev/null 2>&1";
-						system(cmd.c_str());
+				output_prefix = getScratchFilename("tmp_rescue_wtdbg2_" + tmp_reg_str);
+				cpu_tokens = acquireCpuTokens();  // thread number of wtdbg2 from the global CPU budget
+				argv_vec = {"wtdbg2.pl", "-t", to_string(cpu_tokens), "-x", technology, "-o", output_prefix, "-a", "-q", rescue_readsfilename};
+				initProcOpt(proc_opt);
+				proc_opt.wall_timeout_sec = (int64_t)max_proc_running_minutes * 60;
+				if(runProcess(argv_vec, proc_opt, proc_result)==PROC_RET_FAILED) printProcFailure(__func__, argv_vec, proc_result);
+				releaseCpuTokens(cpu_tokens);
 
-						pthread_mutex_lock(&mutex_mem);
-						work_num --;
-						if(work_num<0){
-							cerr << "line=" << __LINE__ << ", work_num=" << work_num << ", error." << endl;
-							exit(1);
-						}
-						pthread_mutex_unlock(&mutex_mem);
-
-						break;
-					}
-				}
+				releaseMemTokens(mem_cost);
 
 				tmp_cns_filename = output_prefix + ".cns.fa";
 				flag = isFileExist(tmp_cns_filename);
@@ -1663,11 +1665,11 @@ vector<reg_t*> varCand::rescueIndelVarLoc(){
 					}
 				}
 
-				cmd2 = "rm -rf " + output_prefix + "*";
-				system(cmd2.c_str());  // remove temporary files
+				removeFilesByPrefix(output_prefix);  // remove temporary files
 			}else{
 				outfile_rescue_reads.close();
 			}
+			removeScratchFile(rescue_readsfilename);
 		}
 
 		delete smoothed_seqs;
@@ -1678,9 +1680,8 @@ vector<reg_t*> varCand::rescueIndelVarLoc(){
 
 	flag = isFileExist(rescue_cnsfilename);
 	if(flag){
-		minimap2_cmd = "minimap2 -c -x asm5 -o " + rescue_alnfilename + " " + rescue_refseqfilename + " " + rescue_cnsfilename + " > /dev/null 2>&1";
-		status = system(minimap2_cmd.c_str());
-		ret_status = getSuccessStatusSystemCmd(status);
+		argv_vec = {"minimap2", "-c", "-x", "asm5", "-o", rescue_alnfilename, rescue_refseqfilename, rescue_cnsfilename};
+		ret_status = runProcess(argv_vec, (int64_t)max_proc_running_minutes * 60);
 		if(ret_status==0){ // command executed successfully
 			// parse alignment information
 			minimap2_aln_vec = minimap2Parse(rescue_alnfilename, rescue_cnsfilename, rescue_refseqfilename);
@@ -1823,7 +1824,7 @@ vector<int32_t> varCand::computeSuppNumFromRegionAlnSegs(vector<string> &clu_qna
 	size_t i, j;
 	uint8_t *seq_int;
 	string qname, reg_str, refseq, clu_qname;
-	int32_t t, seq_len, bam_type;
+	int32_t seq_len, bam_type;
 	char *p_seq;
 	vector<clipAlnData_t*> query_aln_segs; //clipAlnDataVector;
 	bool no_otherchrname_flag, flag;
@@ -1963,7 +1964,7 @@ vector<int32_t> varCand::computeSuppNumFromRegionAlnSegs(vector<string> &clu_qna
 
 														svpos_correction_node->endRpos = svpos_correction_node->startRpos;
 														//for(t=svpos_correction_node->startQpos-1; t<svpos_correction_node->endQpos; t++) svpos_correction_node->altseq += "=ACMGRSVTWYHKDBN"[bam_seqi(seq_int, t)];  // seq
-														for(t=svpos_correction_node->startQpos-1; t<=svpos_correction_node->endQpos; t++) svpos_correction_node->altseq += "=ACMGRSVTWYHKDBN"[bam_seqi(seq_int, t)];  // seq
+														decodeBamSeq(seq_int, svpos_correction_node->startQpos-1, svpos_correction_node->endQpos-svpos_correction_node->startQpos+2, svpos_correction_node->altseq);  // seq
 
 													}else{
 														if(svpos_correction_node->startRpos - startRefPos_cns<0 or svpos_correction_node->startRpos - startRefPos_cns+seg->seglen + 1>=(int64_t)refseq.size()){
@@ -2084,7 +2085,7 @@ void varCand::computeGenotypeIndelReg(vector<reg_t*> &var_vec){
 								val = 0;
 								if(allele_node->reg->var_type==VAR_INS){ // INS
 									// compute identity
-									val = computeVarseqIdentity(allele_node->reg->altseq, allele_node2->reg->altseq); // ?
+									val = computeVarseqIdentity(allele_node->reg->altseq, allele_node2->reg->altseq, gt_min_identity_merge); // ?
 								}else{ // DEL
 									if(allele_node->reg->refseq.size()<=allele_node2->reg->refseq.size()) val = (double)allele_node->reg->refseq.size() / allele_node2->reg->refseq.size();
 									else val = (double)allele_node2->reg->refseq.size() / allele_node->reg->refseq.size();
@@ -2558,36 +2559,17 @@ void varCand::computeSeqAlignment(localAln_t *local_aln){
 		rowsNum = local_aln->ctgseq.size() + 1;
 		colsNum = local_aln->refseq.size() + 1;
 		arrSize = rowsNum * colsNum;
-		mem_cost = (arrSize * sizeof(struct alnScoreNode)) >> 10; // divided by 1024
-
-		while(1){
-			pthread_mutex_lock(&mutex_mem);
-			if(mem_seqAln+mem_cost<=mem_total*mem_use_block_factor+extend_total*extend_use_block_factor){ // prepare for alignment computation
-				mem_seqAln += mem_cost;
-				work_num ++;
-				aln_flag = true;
-			}
-			pthread_mutex_unlock(&mutex_mem);
+		mem_cost = (arrSize * sizeof(int8_t)) >> 10; // path of each element, divided by 1024
 
-			if(aln_flag==false){ // block the alignment computation
-				//cout << "\t" << __func__ << ": wait " << mem_wait_seconds << " seconds, rowsNum=" << rowsNum << ", colsNum=" << colsNum << ", " << alnfilename << endl;
-				sleep(mem_wait_seconds);
-			}else break;
-		}
+		acquireMemTokens(MEM_JOB_SEQ_ALN, mem_cost);
+		aln_flag = true;
 	}
 
 	if(aln_flag){
 		computeSeqAlignmentOp(local_aln);
 
 		// update memory consumption
-		pthread_mutex_lock(&mutex_mem);
-		mem_seqAln -= mem_cost;
-		work_num --;
-		if(mem_seqAln<0 or work_num<0){
-			cerr << "line=" << __LINE__ << ", mem_seqAln=" << mem_seqAln << ", work_num=" << work_num << ", error." << endl;
-			exit(1);
-		}
-		pthread_mutex_unlock(&mutex_mem);
+		releaseMemTokens(mem_cost);
 
 		// save local alignment information to vector
 		local_aln_tmp = generateNewLocalAlnItem_OnlyAlnInfo(local_aln);
@@ -2597,91 +2579,33 @@ void varCand::computeSeqAlignment(localAln_t *local_aln){
 
 // worker of compute sequence alignment (LCS), all characters are in upper case
 void varCand::computeSeqAlignmentOp(localAln_t *local_aln){
-	int64_t i, j, matchScore, mismatchScore, gapScore, gapOpenScore, tmp_gapScore1, tmp_gapScore2, maxValue, scoreIJ;
-	int64_t rowsNum = local_aln->ctgseq.size() + 1, colsNum = local_aln->refseq.size() + 1, arrSize;
-	struct alnScoreNode *scoreArr;
+	int64_t i, j;
+	int64_t rowsNum = local_aln->ctgseq.size() + 1, colsNum = local_aln->refseq.size() + 1;
+	alnPathMatrix_t *path_mat;
 	int8_t path_val;
 	int32_t maxValueLastRow, maxValueLastCol, maxCol, maxRow;
 	int32_t mismatchNum, itemNum;
 	string queryAlnResult, midAlnResult, subjectAlnResult;
 	bool baseMatchFlag;
 
-	matchScore = MATCH_SCORE;
-	mismatchScore = MISMATCH_SCORE;
-	gapScore = GAP_SCORE;
-	gapOpenScore = GAP_OPEN_SCORE;
-
-//	if(rowsNum>=30000 or colsNum>=30000){
-		//cout << "\t" << __func__ << ": work_num=" << work_num << ", rowsNum=" << rowsNum << ", colsNum=" << colsNum << ", " << alnfilename << endl;
-//	}
-
-	arrSize = rowsNum * colsNum;
-	scoreArr = (struct alnScoreNode*) calloc (arrSize, sizeof(struct alnScoreNode));
-	if(scoreArr==NULL){
-		cerr << "line=" << __LINE__ << ", rowsNum=" << rowsNum << ", colsNum=" << colsNum << ", cannot allocate memory, error!" << endl;
-		exit(1);
-	}
-
-	for(i=0; i<rowsNum; i++) for(j=0; j<colsNum; j++) scoreArr[i*colsNum+j].path_val = -1;
-
-	// compute the scores of each element
-	for(i=1; i<rowsNum; i++){
-		for(j=1; j<colsNum; j++){
-			baseMatchFlag = isBaseMatch(local_aln->ctgseq[i-1], local_aln->refseq[j-1]);
-			if(baseMatchFlag) scoreIJ = matchScore;
-			else scoreIJ = mismatchScore;
-
-			if(scoreArr[(i-1)*colsNum+j].path_val!=1)
-				tmp_gapScore1 = gapOpenScore;
-			else
-				tmp_gapScore1 = gapScore;
-
-			if(scoreArr[i*colsNum+j-1].path_val!=2)
-				tmp_gapScore2 = gapOpenScore;
-			else
-				tmp_gapScore2 = gapScore;
-
-			maxValue = INT_MIN;
-			path_val = -1;
-			// compute the maximal score
-			if(scoreArr[(i-1)*colsNum+j-1].score+scoreIJ>maxValue) {// from (i-1, j-1)
-				maxValue = scoreArr[(i-1)*colsNum+j-1].score + scoreIJ;
-				path_val = 0;
-			}
-			if(scoreArr[(i-1)*colsNum+j].score+tmp_gapScore1>maxValue) {// from (i-1, j)
-				maxValue = scoreArr[(i-1)*colsNum+j].score + tmp_gapScore1;
-				path_val = 1;
-			}
-			if(scoreArr[i*colsNum+j-1].score+tmp_gapScore2>maxValue) {// from (i, j-1)
-				maxValue = scoreArr[i*colsNum+j-1].score + tmp_gapScore2;
-				path_val = 2;
-			}
-
-			scoreArr[i*colsNum+j].score = maxValue;
-			scoreArr[i*colsNum+j].path_val = path_val;
-		}
-	}
+	// compute the path of each element
+	path_mat = computeAlnPathMatrix(local_aln->ctgseq, local_aln->refseq, MATCH_SCORE, MISMATCH_SCORE, GAP_SCORE, GAP_OPEN_SCORE);
 
 	// get the row and col of the maximal element in last row and column
 	maxValueLastRow = INT_MIN; maxRow = maxCol = -1;
 	for(j=0; j<colsNum; j++)
-		if(scoreArr[(rowsNum-1)*colsNum+j].score>maxValueLastRow){
-			maxValueLastRow = scoreArr[(rowsNum-1)*colsNum+j].score;
+		if(path_mat->last_row_score[j]>maxValueLastRow){
+			maxValueLastRow = path_mat->last_row_score[j];
 			maxCol = j;
 		}
 	maxValueLastCol = INT_MIN;
 	for(i=0; i<rowsNum; i++)
-		if(scoreArr[i*colsNum+colsNum-1].score>maxValueLastCol){
-			maxValueLastCol = scoreArr[i*colsNum+colsNum-1].score;
+		if(path_mat->last_col_score[i]>maxValueLastCol){
+			maxValueLastCol = path_mat->last_col_score[i];
 			maxRow = i;
 		}
-	if(maxValueLastRow>=maxValueLastCol){
-		maxValue = maxValueLastRow;
-		maxRow = rowsNum - 1;
-	}else{
-		maxValue = maxValueLastCol;
-		maxCol = colsNum - 1;
-	}
+	if(maxValueLastRow>=maxValueLastCol) maxRow = rowsNum - 1;
+	else maxCol = colsNum - 1;
 
 	queryAlnResult = midAlnResult = subjectAlnResult = "";
 	mismatchNum = 0;
@@ -2689,7 +2613,8 @@ void varCand::computeSeqAlignmentOp(localAln_t *local_aln){
 	i = maxRow;
 	j = maxCol;
 	while(i>0 && j>0){
-		if(scoreArr[i*colsNum+j].path_val==0){ // from (i-1, j-1)
+		path_val = getAlnPathVal(path_mat, i, j);
+		if(path_val==0){ // from (i-1, j-1)
 			queryAlnResult += local_aln->ctgseq[i-1];
 			baseMatchFlag = isBaseMatch(local_aln->ctgseq[i-1], local_aln->refseq[j-1]);
 			if(baseMatchFlag) midAlnResult += '|';
@@ -2701,7 +2626,7 @@ void varCand::computeSeqAlignmentOp(localAln_t *local_aln){
 			subjectAlnResult += local_aln->refseq[j-1];
 			i --;
 			j --;
-		}else if(scoreArr[i*colsNum+j].path_val==1){ // from (i-1, j)
+		}else if(path_val==1){ // from (i-1, j)
 			queryAlnResult += local_aln->ctgseq[i-1];
 			midAlnResult += ' ';
 			subjectAlnResult += '-';
@@ -2751,7 +2676,7 @@ void varCand::computeSeqAlignmentOp(localAln_t *local_aln){
 	cout << "Sbjct: " << local_aln->alignResultVec[2] << endl;
 #endif
 
-	free(scoreArr);
+	destroyAlnPathMatrix(path_mat);
 }
 
 // adjust alignment
@@ -5667,10 +5592,10 @@ vector<reg_t*> varCand::computeClipRegVarLocOp(string &alnfilename, string &cnsf
 								tmp_queryseq = query_seq.substr(left_qpos-1, right_qpos-left_qpos+1);
 
 								if(sidemost_item_id_vec.at(1)==sidemost_item_id_vec.at(2)) // same segment
-									val = computeVarseqIdentity(tmp_queryseq, tmp_refseq);
+									val = computeVarseqIdentity(tmp_queryseq, tmp_refseq, min_identity_match);
 								else{ // different segments
 									reverseComplement(tmp_queryseq);
-									val = computeVarseqIdentity(tmp_queryseq, tmp_refseq);
+									val = computeVarseqIdentity(tmp_queryseq, tmp_refseq, min_identity_match);
 									//cout << "identity=" << val << endl;
 								}
 								//if(val>=QC_IDENTITY_RATIO_MATCH_THRES){ // identity confirm
@@ -5839,7 +5764,7 @@ void varCand::computeGenotypeClipReg(vector<reg_t*> &var_vec){
 			allele_node = allele_vec.at(i);
 			for(j=i+1; j<allele_vec.size(); ){
 				allele_node2 = allele_vec.at(j);
-				val = computeVarseqIdentity(allele_node->reg->altseq, allele_node2->reg->altseq);
+				val = computeVarseqIdentity(allele_node->reg->altseq, allele_node2->reg->altseq, gt_min_identity_merge);
 				//cout << "allele identity=" << val << endl;
 				if(val>=gt_min_identity_merge){ // merge
 					allele_node->supp_num += allele_node2->supp_num;
@@ -5971,8 +5896,11 @@ vector<reg_t*> varCand::rescueDupInvClipReg(){
 
 	ofstream outfile_rescue_reads, outfile_rescue_refseq, outfile_rescue_cns;
 	string rescue_readsfilename, rescue_refseqfilename, rescue_cnsfilename, rescue_alnfilename, tmp_rescue_cnsfilename;
-	string cons_header, abpoa_cmd, minimap2_cmd;
-	int32_t ret_status, status, serial_number, left_shift_size, right_shift_size, chrlen_tmp, query_orient, query_len_whole;
+	string cons_header;
+	vector<string> argv_vec;
+	procOpt_t proc_opt;
+	procResult_t proc_result;
+	int32_t ret_status, serial_number, left_shift_size, right_shift_size, chrlen_tmp, query_orient, query_len_whole;
 	bool flag, valid_flag;
 	vector<minimap2_aln_t*> minimap2_aln_vec;
 
@@ -6131,13 +6059,13 @@ vector<reg_t*> varCand::rescueDupInvClipReg(){
 										valid_flag = true;
 										queryseq = "";
 										if(left_aln_seg->aln_orient==query_orient){
-											if(left_qpos<=right_qpos) for(j=left_qpos-1; j<(size_t)right_qpos; j++) queryseq += "=ACMGRSVTWYHKDBN"[bam_seqi(seq_int_whole, j)];  // seq
+											if(left_qpos<=right_qpos) decodeBamSeq(seq_int_whole, left_qpos-1, right_qpos-left_qpos+1, queryseq);  // seq
 											else valid_flag = false;
 										}else{
 											start_qpos_tmp = query_len_whole - right_qpos;
 											end_qpos_tmp = query_len_whole - left_qpos;
 											if(start_qpos_tmp<=end_qpos_tmp) {
-												for(j=start_qpos_tmp-1; j<(size_t)end_qpos_tmp; j++) queryseq += "=ACMGRSVTWYHKDBN"[bam_seqi(seq_int_whole, j)];  // seq
+												decodeBamSeq(seq_int_whole, start_qpos_tmp-1, end_qpos_tmp-start_qpos_tmp+1, queryseq);  // seq
 												reverseComplement(queryseq);
 											}else valid_flag = false;
 										}
@@ -6177,13 +6105,13 @@ vector<reg_t*> varCand::rescueDupInvClipReg(){
 
 												queryseq = "";
 												if(left_aln_seg->aln_orient==query_orient){
-													if(left_qpos<=right_qpos) for(j=left_qpos-1; j<(size_t)right_qpos; j++) queryseq += "=ACMGRSVTWYHKDBN"[bam_seqi(seq_int_whole, j)];  // seq
+													if(left_qpos<=right_qpos) decodeBamSeq(seq_int_whole, left_qpos-1, right_qpos-left_qpos+1, queryseq);  // seq
 													else valid_flag = false;
 												}else{
 													start_qpos_tmp = query_len_whole - right_qpos;
 													end_qpos_tmp = query_len_whole - left_qpos;
 													if(start_qpos_tmp<=end_qpos_tmp) {
-														for(j=start_qpos_tmp-1; j<(size_t)end_qpos_tmp; j++) queryseq += "=ACMGRSVTWYHKDBN"[bam_seqi(seq_int_whole, j)];  // seq
+														decodeBamSeq(seq_int_whole, start_qpos_tmp-1, end_qpos_tmp-start_qpos_tmp+1, queryseq);  // seq
 														reverseComplement(queryseq);
 													}else valid_flag = false;
 												}
@@ -6246,8 +6174,8 @@ vector<reg_t*> varCand::rescueDupInvClipReg(){
 
 			serial_number = 1;
 			for(cluster_id=0; cluster_id<rescue_seqs_vec.size(); cluster_id++){
-				rescue_readsfilename = out_dir_call + "/rescue_reads_" + chrname + "_" + to_string(leftClipRefPos) + "-" + to_string(rightClipRefPos) + "_" + to_string(cluster_id) + ".fa";
-				tmp_rescue_cnsfilename = out_dir_call + "/tmp_rescue_cns_" + chrname + "_" + to_string(leftClipRefPos) + "-" + to_string(rightClipRefPos) + "_" + to_string(cluster_id) + ".fa";
+				rescue_readsfilename = getScratchFilename(out_dir_call + "/rescue_reads_" + chrname + "_" + to_string(leftClipRefPos) + "-" + to_string(rightClipRefPos) + "_" + to_string(cluster_id) + ".fa");
+				tmp_rescue_cnsfilename = getScratchFilename(out_dir_call + "/tmp_rescue_cns_" + chrname + "_" + to_string(leftClipRefPos) + "-" + to_string(rightClipRefPos) + "_" + to_string(cluster_id) + ".fa");
 
 				re_seq_vec = rescue_seqs_vec.at(cluster_id);
 				if(re_seq_vec.size()>0){
@@ -6268,8 +6196,10 @@ vector<reg_t*> varCand::rescueDupInvClipReg(){
 					outfile_rescue_reads.close();
 
 					// perform abpoa consensus
-					abpoa_cmd = "abpoa -S -o " + tmp_rescue_cnsfilename + " " + rescue_readsfilename + " > /dev/null 2>&1";
-					system(abpoa_cmd.c_str());
+					argv_vec = {"abpoa", "-S", "-o", tmp_rescue_cnsfilename, rescue_readsfilename};
+					initProcOpt(proc_opt);
+					proc_opt.wall_timeout_sec = (int64_t)max_proc_running_minutes * 60;
+					if(runProcess(argv_vec, proc_opt, proc_result)==PROC_RET_FAILED) printProcFailure(__func__, argv_vec, proc_result);
 
 					flag = isFileExist(tmp_rescue_cnsfilename);
 					if(flag){ // cons generated successfully
@@ -6290,15 +6220,16 @@ vector<reg_t*> varCand::rescueDupInvClipReg(){
 							serial_number ++;
 						}
 					}
+					removeScratchFile(rescue_readsfilename);
+					removeScratchFile(tmp_rescue_cnsfilename);
 				}
 			}
 			outfile_rescue_cns.close();
 
 			flag = isFileExist(rescue_cnsfilename);
 			if(flag){
-				minimap2_cmd = "minimap2 -c -x asm5 -o " + rescue_alnfilename + " " + rescue_refseqfilename + " " + rescue_cnsfilename + " > /dev/null 2>&1";
-				status = system(minimap2_cmd.c_str());
-				ret_status = getSuccessStatusSystemCmd(status);
+				argv_vec = {"minimap2", "-c", "-x", "asm5", "-o", rescue_alnfilename, rescue_refseqfilename, rescue_cnsfilename};
+				ret_status = runProcess(argv_vec, (int64_t)max_proc_running_minutes * 60);
 				if(ret_status==0){ // command executed successfully
 					// parse alignment information
 					minimap2_aln_vec = minimap2Parse(rescue_alnfilename, rescue_cnsfilename, rescue_refseqfilename);
@@ -6432,8 +6363,11 @@ vector<reg_t*> varCand::rescueLargeIndelClipReg(){
 
 	ofstream outfile_rescue_reads, outfile_rescue_refseq, outfile_rescue_cns;
 	string rescue_readsfilename, rescue_refseqfilename, rescue_cnsfilename, rescue_alnfilename, tmp_rescue_cnsfilename;
-	string cons_header, abpoa_cmd, minimap2_cmd;
-	int32_t ret_status, status, serial_number, left_shift_size, right_shift_size, chrlen_tmp;
+	string cons_header;
+	vector<string> argv_vec;
+	procOpt_t proc_opt;
+	procResult_t proc_result;
+	int32_t ret_status, serial_number, left_shift_size, right_shift_size, chrlen_tmp;
 	bool flag, valid_flag;
 	vector<minimap2_aln_t*> minimap2_aln_vec;
 
@@ -6693,13 +6627,13 @@ vector<reg_t*> varCand::rescueLargeIndelClipReg(){
 													valid_flag = true;
 													queryseq = "";
 													if(left_aln_seg->aln_orient==query_orient){
-														if(left_qpos<=right_qpos) for(j=left_qpos-1; j<(size_t)right_qpos; j++) queryseq += "=ACMGRSVTWYHKDBN"[bam_seqi(seq_int_whole, j)];  // seq
+														if(left_qpos<=right_qpos) decodeBamSeq(seq_int_whole, left_qpos-1, right_qpos-left_qpos+1, queryseq);  // seq
 														else valid_flag = false;
 													}else{
 														start_qpos_tmp = query_len_whole - right_qpos;
 														end_qpos_tmp = query_len_whole - left_qpos;
 														if(start_qpos_tmp<=end_qpos_tmp){
-															for(j=start_qpos_tmp-1; j<(size_t)end_qpos_tmp; j++) queryseq += "=ACMGRSVTWYHKDBN"[bam_seqi(seq_int_whole, j)];  // seq
+															decodeBamSeq(seq_int_whole, start_qpos_tmp-1, end_qpos_tmp-start_qpos_tmp+1, queryseq);  // seq
 															reverseComplement(queryseq);
 														}else valid_flag = false;
 													}
@@ -6739,13 +6673,13 @@ vector<reg_t*> varCand::rescueLargeIndelClipReg(){
 
 																queryseq = "";
 																if(left_aln_seg->aln_orient==query_orient){
-																	if(left_qpos<=right_qpos) for(j=left_qpos-1; j<(size_t)right_qpos; j++) queryseq += "=ACMGRSVTWYHKDBN"[bam_seqi(seq_int_whole, j)];  // seq
+																	if(left_qpos<=right_qpos) decodeBamSeq(seq_int_whole, left_qpos-1, right_qpos-left_qpos+1, queryseq);  // seq
 																	else valid_flag = false;
 																}else{
 																	start_qpos_tmp = query_len_whole - right_qpos;
 																	end_qpos_tmp = query_len_whole - left_qpos;
 																	if(start_qpos_tmp<=end_qpos_tmp){
-																		for(j=start_qpos_tmp-1; j<(size_t)end_qpos_tmp; j++) queryseq += "=ACMGRSVTWYHKDBN"[bam_seqi(seq_int_whole, j)];  // seq
+																		decodeBamSeq(seq_int_whole, start_qpos_tmp-1, end_qpos_tmp-start_qpos_tmp+1, queryseq);  // seq
 																		reverseComplement(queryseq);
 																	}else valid_flag = false;
 																}
@@ -6835,8 +6769,10 @@ vector<reg_t*> varCand::rescueLargeIndelClipReg(){
 					outfile_rescue_reads.close();
 
 					// perform abpoa consensus
-					abpoa_cmd = "abpoa -S -o " + tmp_rescue_cnsfilename + " " + rescue_readsfilename + " > /dev/null 2>&1";
-					system(abpoa_cmd.c_str());
+					argv_vec = {"abpoa", "-S", "-o", tmp_rescue_cnsfilename, rescue_readsfilename};
+					initProcOpt(proc_opt);
+					proc_opt.wall_timeout_sec = (int64_t)max_proc_running_minutes * 60;
+					if(runProcess(argv_vec, proc_opt, proc_result)==PROC_RET_FAILED) printProcFailure(__func__, argv_vec, proc_result);
 
 					flag = isFileExist(tmp_rescue_cnsfilename);
 					if(flag){ // cons generated successfully
@@ -6863,9 +6799,8 @@ vector<reg_t*> varCand::rescueLargeIndelClipReg(){
 
 			flag = isFileExist(rescue_cnsfilename);
 			if(flag){
-				minimap2_cmd = "minimap2 -c -x asm5 -o " + rescue_alnfilename + " " + rescue_refseqfilename + " " + rescue_cnsfilename + " > /dev/null 2>&1";
-				status = system(minimap2_cmd.c_str());
-				ret_status = getSuccessStatusSystemCmd(status);
+				argv_vec = {"minimap2", "-c", "-x", "asm5", "-o", rescue_alnfilename, rescue_refseqfilename, rescue_cnsfilename};
+				ret_status = runProcess(argv_vec, (int64_t)max_proc_running_minutes * 60);
 				if(ret_status==0){ // command executed successfully
 					// parse alignment information
 					minimap2_aln_vec = minimap2Parse(rescue_alnfilename, rescue_cnsfilename, rescue_refseqfilename);
@@ -8486,6 +8421,7 @@ void varCand::printSV(){
 // genotyping for indels
 void varCand::indelGenotyping(){
 	reg_t *reg;
+	vector<reg_t*> gt_reg_vec;
 
 	cout << "========== alnfilename=" << alnfilename << endl;
 
@@ -8496,17 +8432,20 @@ void varCand::indelGenotyping(){
 //		if(i<6)
 //			continue;
 
-		if(reg->var_type!=VAR_DUP){ //exclude DUP
-
+		if(reg->var_type!=VAR_DUP) //exclude DUP
+			gt_reg_vec.push_back(reg);
+	}
 
-			genotyping gt(reg, fai, inBamFile, gt_min_sig_size, gt_size_ratio_match, gt_hete_ratio_thres, gt_homo_ratio_thres, gt_min_sup_num_recover, minMapQ, minHighMapQ, max_ultra_high_cov);
-			gt.computeGenotype();
-		}
+	// genotype all the alleles in a single pass over the reads
+	if(gt_reg_vec.size()>0){
+		gtEngine gt_engine(gt_reg_vec, fai, inBamFile, gt_min_sig_size, gt_size_ratio_match, gt_hete_ratio_thres, gt_homo_ratio_thres, gt_min_sup_num_recover, minMapQ, minHighMapQ, max_ultra_high_cov);
+		gt_engine.computeGenotypes();
 	}
 }
 
 void varCand::indelGenotyping02(){
 	reg_t *reg;
+	vector<reg_t*> gt_reg_vec;
 
 	cout << "========== alnfilename=" << alnfilename << endl;
 
@@ -8517,12 +8456,14 @@ void varCand::indelGenotyping02(){
 //		if(i<6)
 //			continue;
 
-		if(reg->var_type!=VAR_DUP){ //exclude DUP
-
+		if(reg->var_type!=VAR_DUP) //exclude DUP
+			gt_reg_vec.push_back(reg);
+	}
 
-			genotyping gt(reg, fai, inBamFile, gt_min_sig_size, gt_size_ratio_match, gt_hete_ratio_thres, gt_homo_ratio_thres, gt_min_sup_num_recover, minMapQ, minHighMapQ, max_ultra_high_cov);
-			gt.computeGenotype();
-		}
+	// genotype all the alleles in a single pass over the reads
+	if(gt_reg_vec.size()>0){
+		gtEngine gt_engine(gt_reg_vec, fai, inBamFile, gt_min_sig_size, gt_size_ratio_match, gt_hete_ratio_thres, gt_homo_ratio_thres, gt_min_sup_num_recover, minMapQ, minHighMapQ, max_ultra_high_cov);
+		gt_engine.computeGenotypes();
 	}
 }
 // output newVarVector
@@ -16,9 +16,11 @@
 #include "RefSeqLoader.h"
 #include "alnDataLoader.h"
 #include "meminfo.h"
+#include "cpuinfo.h"
 #include "genotyping.h"
 #include "clipAlnDataLoader.h"
 #include "identity.h"
+#include "seqAlign.h"
 #include "util.h"
 
 using namespace std;
@@ -77,6 +79,7 @@ class varCand {
 		double max_ultra_high_cov, min_identity_match, min_identity_merge;
 		vector<reg_t*> varVec, newVarVec;
 		bool cns_success, align_success, call_success, clip_reg_flag, killed_flag;  	// default: false
+		bool minimap2_lib_flag;		// align the contigs by the minimap2 library in process
 		vector<blat_aln_t*> blat_aln_vec;               	// blat aligned segments
 		vector<minimap2_aln_t*> minimap2_aln_vec;           // minimap2 aligned segments
 		//vector<clipAlnData_t*> clipAlnDataVector;
@@ -138,6 +141,7 @@ class varCand {
 		void adjustVarLocSlightly();
 		void fillVarseq();
 		void alnCtg2Refseq02();
+		bool getMinimap2AlnDoneFlag();
 		void alnCtg2Refseq();
 		void loadMinimap2AlnData();
 		void loadBlatAlnData();
@@ -146,11 +150,11 @@ class varCand {
 	private:
 		void init();
 		//void alnCtg2Refseq();
+		killedWorkRecord_t initKilledWorkRecord(bool minimap2_flag);
 		bool getMinimap2WorkKilledFlag();
 		bool getBlatWorkKilledFlag();
 		void recordMinimap2AlnInfo();
 		void recordBlatAlnInfo();
-		bool getMinimap2AlnDoneFlag();
 		bool getBlatAlnDoneFlag();
 		void assignMinimap2AlnStatus();
 		void assignBlatAlnStatus();
@@ -160,6 +164,7 @@ class varCand {
 		void callClipRegVariants02();
 		void minimap2Parse();
 		vector<minimap2_aln_t*> minimap2Parse(string &alnfilename, string &cnsfilename, string &refseqfilename);
+		vector<minimap2_aln_t*> generateMinimap2AlnVec(vector<pafRecord_t> &paf_rec_vec, string &ctgfilename, string &refseqfilename);
 		//allocatePafInDelAlnSeg
 		void getMissingPafInDelsAtAlnSegEnd(vector<struct pafalnSeg*> &all_pafalnsegs, vector<struct pafalnSeg*> &pafalnsegs, int32_t region_refstart, int32_t region_refend, int32_t querystart, int32_t queryend, int32_t query_len, int32_t subjectlen, int32_t subjectstart, int32_t subjectend, int32_t match_base_num, int32_t match_ref_len, string cons_seq, string ref_seq, int32_t aln_orient);
 		void blatParse();